@@ -179,6 +179,22 @@ namespace xt
             }
         }
 
+        template <class E>
+        inline auto assign_x_broadcast(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            E x = E::from_shape({ size, 4, 4, 4, 4, 2 });
+            E y = E::from_shape({ 4, 4, 4, 4, 2 });
+            E res = E::from_shape({ size, 4, 4, 4, 4, 2 });
+            std::fill(x.begin(), x.end(), 1.5);
+            std::fill(y.begin(), y.end(), 2.5);
+            for (auto _ : state)
+            {
+                xt::noalias(res) = x + y;
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
         BENCHMARK_TEMPLATE(assign_c_assign, xt::xtensor<double, 2>)->Range(32, 32<<3);
         BENCHMARK_TEMPLATE(assign_x_assign, xt::xarray<double>)->Range(32, 32<<3);
         BENCHMARK_TEMPLATE(assign_x_assign, xt::xtensor<double, 2>)->Range(32, 32<<3);
@@ -190,6 +206,7 @@ namespace xt
         BENCHMARK_TEMPLATE(assign_x_assign_iii, xt::xtensor<double, 2>)->Range(32, 32<<3);
         BENCHMARK_TEMPLATE(assign_xstorageiter_copy, xt::xtensor<double, 2>)->Range(32, 32<<3);
         BENCHMARK_TEMPLATE(assign_xiter_copy, xt::xtensor<double, 2>)->Range(32, 32<<3);
+        BENCHMARK_TEMPLATE(assign_x_broadcast, xt::xarray<double>)->Range(32, 32<<3);
     }
 }
 
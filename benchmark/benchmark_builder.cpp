@@ -8,7 +8,9 @@
 
 #include <benchmark/benchmark.h>
 
+#include "xtensor/xbuilder.hpp"
 #include "xtensor/xnoalias.hpp"
+#include "xtensor/xrandom.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xarray.hpp"
 
@@ -194,6 +196,63 @@ namespace xt
         }
     }
 
+    template <std::size_t axis>
+    inline auto builder_concatenate(benchmark::State& state)
+    {
+        xt::xtensor<double, 2> a = xt::ones<double>({500, 500});
+        xt::xtensor<double, 2> b = xt::ones<double>({500, 500}) * 2.;
+
+        for (auto _ : state)
+        {
+            xt::xtensor<double, 2> res = xt::concatenate(xt::xtuple(a, b, a), axis);
+            benchmark::DoNotOptimize(res.storage().data());
+        }
+    }
+
+    template <std::size_t axis>
+    inline auto builder_stack(benchmark::State& state)
+    {
+        xt::xtensor<double, 2> a = xt::ones<double>({500, 500});
+        xt::xtensor<double, 2> b = xt::ones<double>({500, 500}) * 2.;
+
+        for (auto _ : state)
+        {
+            xt::xtensor<double, 3> res = xt::stack(xt::xtuple(a, b, a), axis);
+            benchmark::DoNotOptimize(res.storage().data());
+        }
+    }
+
+    inline auto builder_meshgrid(benchmark::State& state)
+    {
+        for (auto _ : state)
+        {
+            auto mesh = xt::meshgrid(xt::arange<double>(1000.), xt::arange<double>(1000.));
+            xt::xtensor<double, 2> x = std::get<0>(mesh);
+            xt::xtensor<double, 2> y = std::get<1>(mesh);
+            benchmark::DoNotOptimize(x.storage().data());
+            benchmark::DoNotOptimize(y.storage().data());
+        }
+    }
+
+    inline auto builder_randn(benchmark::State& state)
+    {
+        for (auto _ : state)
+        {
+            xt::xtensor<double, 1> res = xt::random::randn<double>({std::size_t(1) << 22});
+            benchmark::DoNotOptimize(res.data());
+        }
+    }
+
+    inline auto builder_randn_philox(benchmark::State& state)
+    {
+        xt::random::philox_engine engine;
+        for (auto _ : state)
+        {
+            xt::xtensor<double, 1> res = xt::random::randn<double>({std::size_t(1) << 22}, 0., 1., engine);
+            benchmark::DoNotOptimize(res.data());
+        }
+    }
+
     BENCHMARK_TEMPLATE(builder_xarange, xarray<double>);
     BENCHMARK_TEMPLATE(builder_xarange, xtensor<double, 1>);
     BENCHMARK_TEMPLATE(builder_xarange_manual, xarray<double>);
@@ -215,4 +274,11 @@ namespace xt
     BENCHMARK(builder_ones_expr_fill);
     BENCHMARK(builder_ones_expr_for);
     BENCHMARK(builder_std_fill);
+    BENCHMARK_TEMPLATE(builder_concatenate, 0);
+    BENCHMARK_TEMPLATE(builder_concatenate, 1);
+    BENCHMARK_TEMPLATE(builder_stack, 0);
+    BENCHMARK_TEMPLATE(builder_stack, 2);
+    BENCHMARK(builder_meshgrid);
+    BENCHMARK(builder_randn);
+    BENCHMARK(builder_randn_philox);
 }
@@ -0,0 +1,63 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xfixed.hpp"
+#include "xtensor/xproduct.hpp"
+#include "xtensor/xreducer.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    namespace product
+    {
+        template <class E>
+        inline void matmul_square(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            E a = ones<double>({size, size});
+            E b = ones<double>({size, size});
+            for (auto _ : state)
+            {
+                auto res = matmul(a, b);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class E>
+        inline void matmul_broadcast_sum(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            E a = ones<double>({size, size});
+            E b = ones<double>({size, size});
+            for (auto _ : state)
+            {
+                E res = sum(view(a, all(), all(), newaxis()) * view(b, newaxis(), all(), all()), {1});
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        inline void dot_fixed_4x4(benchmark::State& state)
+        {
+            xtensor_fixed<double, xshape<4, 4>> a(1.);
+            xtensor_fixed<double, xshape<4, 4>> b(2.);
+            for (auto _ : state)
+            {
+                auto res = dot(a, b);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        BENCHMARK_TEMPLATE(matmul_square, xarray<double>)->Range(16, 16 << 6);
+        BENCHMARK_TEMPLATE(matmul_broadcast_sum, xarray<double>)->Range(16, 16 << 3);
+        BENCHMARK(dot_fixed_4x4);
+    }
+}
@@ -0,0 +1,66 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "xtensor/xrandom.hpp"
+#include "xtensor/xsort.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    namespace sorting
+    {
+        template <class T>
+        inline xtensor<T, 1> random_keys(std::size_t size, std::true_type /*integral*/)
+        {
+            return random::randint<T>({size});
+        }
+
+        template <class T>
+        inline xtensor<T, 1> random_keys(std::size_t size, std::false_type /*integral*/)
+        {
+            return random::randn<T>({size});
+        }
+
+        template <class T, sorting_method M>
+        inline void sort_1d(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            xtensor<T, 1> a = random_keys<T>(size, std::is_integral<T>());
+            for (auto _ : state)
+            {
+                auto res = sort(a, xnone(), M);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        template <class T, sorting_method M>
+        inline void argsort_1d(benchmark::State& state)
+        {
+            std::size_t size = static_cast<std::size_t>(state.range(0));
+            xtensor<T, 1> a = random_keys<T>(size, std::is_integral<T>());
+            for (auto _ : state)
+            {
+                auto res = argsort(a, xnone(), M);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        BENCHMARK_TEMPLATE(sort_1d, std::uint32_t, sorting_method::comparison)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(sort_1d, std::uint32_t, sorting_method::radix)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(sort_1d, std::int64_t, sorting_method::comparison)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(sort_1d, std::int64_t, sorting_method::radix)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(sort_1d, float, sorting_method::comparison)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(sort_1d, float, sorting_method::radix)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(argsort_1d, float, sorting_method::comparison)->Range(1 << 10, 1 << 22);
+        BENCHMARK_TEMPLATE(argsort_1d, float, sorting_method::radix)->Range(1 << 10, 1 << 22);
+    }
+}
@@ -13,7 +13,9 @@
 #include <benchmark/benchmark.h>
 
 #include "xtensor/xarray.hpp"
+#include "xtensor/xindex_view.hpp"
 #include "xtensor/xnoalias.hpp"
+#include "xtensor/xrandom.hpp"
 #include "xtensor/xstrided_view.hpp"
 #include "xtensor/xstrides.hpp"
 #include "xtensor/xtensor.hpp"
@@ -222,5 +224,28 @@ namespace xt
         BENCHMARK_CAPTURE(transpose_assign_cm_cm, 10x20x500, {10, 20, 500});
         BENCHMARK_CAPTURE(transpose_assign_rm_cm, 10x20x500, {10, 20, 500});
         BENCHMARK_CAPTURE(transpose_assign_cm_rm, 10x20x500, {10, 20, 500});
+
+        inline auto filter_assign(benchmark::State& state)
+        {
+            xt::xtensor<double, 2> a = xt::random::rand<double>({SIZE, SIZE});
+            for (auto _ : state)
+            {
+                xt::xtensor<double, 1> res = xt::filter(a, a > 0.5);
+                benchmark::DoNotOptimize(res.data());
+            }
+        }
+
+        inline auto filtration_assign(benchmark::State& state)
+        {
+            xt::xtensor<double, 2> a = xt::random::rand<double>({SIZE, SIZE});
+            for (auto _ : state)
+            {
+                xt::filtration(a, a > 0.5) *= 1.;
+                benchmark::DoNotOptimize(a.data());
+            }
+        }
+
+        BENCHMARK(filter_assign);
+        BENCHMARK(filtration_assign);
     }
 }
@@ -11,12 +11,17 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <functional>
 #include <numeric>
 #include <type_traits>
 
 #include "xexpression.hpp"
+#include "xparallel.hpp"
+#include "xreducer.hpp"
 #include "xstrides.hpp"
 #include "xtensor_forward.hpp"
+#include "xtensor_simd.hpp"
+#include "xutils.hpp"
 
 namespace xt
 {
@@ -139,6 +144,81 @@ namespace xt
             }
         }
 
+        // Accumulating functors that are known to be associative can be split
+        // in blocks and applied on batches.
+        template <class F, class T>
+        using is_simd_accumulator = is_simd_reducer<F, xtl::identity, T, T>;
+
+        // In-place scan of the size contiguous elements starting at data.
+        template <class F, class T>
+        inline void accumulate_scan(const F& f, T* data, std::size_t size)
+        {
+            for (std::size_t i = 1; i < size; ++i)
+            {
+                data[i] = f(data[i - 1], data[i]);
+            }
+        }
+
+        // Blocked two-pass scan: each worker reduces a chunk, the totals of the
+        // chunks are scanned, then each worker scans its chunk starting from
+        // the total of the previous chunks.
+        template <class F, class T>
+        inline void accumulate_scan_parallel(const F& f, T* data, std::size_t size)
+        {
+            using simd_tag = std::integral_constant<bool, is_simd_accumulator<F, T>::value>;
+            std::size_t n_chunks = (std::min)(size, parallel_concurrency());
+            uvector<T> totals(n_chunks);
+            auto chunk_first = [size, n_chunks](std::size_t c) { return size * c / n_chunks; };
+
+            parallel_for(std::size_t(0), n_chunks - 1, std::size_t(1), [&](std::size_t first, std::size_t last) {
+                for (std::size_t c = first; c < last; ++c)
+                {
+                    totals[c] = reduce_contiguous<T>(f, xtl::identity(), data + chunk_first(c),
+                                                     chunk_first(c + 1) - chunk_first(c), simd_tag());
+                }
+            });
+            for (std::size_t c = 1; c < n_chunks - 1; ++c)
+            {
+                totals[c] = f(totals[c - 1], totals[c]);
+            }
+            parallel_for(std::size_t(0), n_chunks, std::size_t(1), [&](std::size_t first, std::size_t last) {
+                for (std::size_t c = first; c < last; ++c)
+                {
+                    T* chunk = data + chunk_first(c);
+                    if (c != 0)
+                    {
+                        chunk[0] = f(totals[c - 1], chunk[0]);
+                    }
+                    accumulate_scan(f, chunk, chunk_first(c + 1) - chunk_first(c));
+                }
+            });
+        }
+
+        // dst[i] = f(src[i], dst[i]) for i in [0, size)
+        template <class F, class T>
+        inline void accumulate_row(const F& f, const T* src, T* dst, std::size_t size, std::false_type)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                dst[i] = f(src[i], dst[i]);
+            }
+        }
+
+        template <class F, class T>
+        inline void accumulate_row(const F& f, const T* src, T* dst, std::size_t size, std::true_type)
+        {
+            using traits = xreducer_simd_traits<F>;
+            constexpr std::size_t simd_size = xsimd::simd_traits<T>::size;
+            std::size_t i = 0;
+            for (; i + simd_size <= size; i += simd_size)
+            {
+                xsimd::store_simd(dst + i, traits::apply(f, xsimd::load_simd(src + i, unaligned_mode()),
+                                                         xsimd::load_simd(dst + i, unaligned_mode())),
+                                  unaligned_mode());
+            }
+            accumulate_row(f, src + i, dst + i, size - i, std::false_type());
+        }
+
         template <class F, class E>
         inline auto accumulator_impl(F&& f, E&& e, std::size_t axis, evaluation_strategy::immediate)
         {
@@ -153,55 +233,100 @@ namespace xt
 
             result_type result = e;  // assign + make a copy, we need it anyways
 
-            std::size_t inner_stride = result.strides()[axis];
-            std::size_t outer_stride = 1;  // this is either going row- or column-wise (strides.back / strides.front)
-            std::size_t outer_loop_size = 0;
-            std::size_t inner_loop_size = 0;
-
-            auto set_loop_sizes = [&outer_loop_size, &inner_loop_size](auto first, auto last, std::ptrdiff_t ax) {
-                outer_loop_size = std::accumulate(first,
-                                                  first + ax,
-                                                  std::size_t(1), std::multiplies<std::size_t>());
-
-                inner_loop_size = std::accumulate(first + ax,
-                                                  last,
-                                                  std::size_t(1), std::multiplies<std::size_t>());
-            };
-
-            if (result_type::static_layout == layout_type::row_major)
+            // activate the init loop if we have an init function other than identity
+            if (!std::is_same<decltype(std::get<1>(f)), xtl::identity>::value)
             {
-                set_loop_sizes(result.shape().cbegin(), result.shape().cend(), static_cast<std::ptrdiff_t>(axis));
+                accumulator_init_with_f(std::get<1>(f), result, axis);
             }
-            else
+
+            // The storage is made of blocks of n rows of row_size elements, the
+            // accumulation is performed row-wise within each block.
+            using value_type = typename result_type::value_type;
+            using simd_tag = std::integral_constant<bool, is_simd_accumulator<accumulate_functor, value_type>::value>;
+            const auto& shape = result.shape();
+            std::size_t n = shape[axis];
+            std::size_t row_size = result_type::static_layout == layout_type::row_major ?
+                std::accumulate(shape.cbegin() + std::ptrdiff_t(axis) + 1, shape.cend(), std::size_t(1), std::multiplies<std::size_t>()) :
+                std::accumulate(shape.cbegin(), shape.cbegin() + std::ptrdiff_t(axis), std::size_t(1), std::multiplies<std::size_t>());
+            std::size_t block_size = n * row_size;
+            if (n <= 1 || block_size == 0)
             {
-                set_loop_sizes(result.shape().cbegin(), result.shape().cend(), static_cast<std::ptrdiff_t>(axis + 1));
-                std::swap(inner_loop_size, outer_loop_size);
+                return result;
             }
+            std::size_t n_blocks = result.size() / block_size;
+            value_type* data = result.data();
+            const accumulate_functor& acc_fct = std::get<0>(f);
+
+            // accumulates the columns [first, last) of the block b
+            auto accumulate_block = [&acc_fct, data, n, row_size, block_size](std::size_t b, std::size_t first, std::size_t last) {
+                value_type* block = data + b * block_size;
+                if (row_size == 1)
+                {
+                    accumulate_scan(acc_fct, block, n);
+                }
+                else
+                {
+                    for (std::size_t k = 1; k < n; ++k)
+                    {
+                        accumulate_row(acc_fct, block + (k - 1) * row_size + first, block + k * row_size + first,
+                                       last - first, simd_tag());
+                    }
+                }
+            };
 
-            std::size_t pos = 0;
-
-            inner_loop_size = inner_loop_size - inner_stride;
-
-            // activate the init loop if we have an init function other than identity
-            if (!std::is_same<decltype(std::get<1>(f)), xtl::identity>::value)
+            std::size_t min_work_items = 4 * parallel_concurrency();
+            if (!parallel_enabled(result.size()))
             {
-                accumulator_init_with_f(std::get<1>(f), result, axis);
+                for (std::size_t b = 0; b < n_blocks; ++b)
+                {
+                    accumulate_block(b, 0, row_size);
+                }
             }
-
-            pos = 0;
-            for (std::size_t i = 0; i < outer_loop_size; ++i)
+            else if (row_size == 1 && n_blocks < min_work_items && simd_tag::value)
             {
-                for (std::size_t j = 0; j < inner_loop_size; ++j)
+                // few long contiguous lines: each of them is scanned in parallel
+                for (std::size_t b = 0; b < n_blocks; ++b)
                 {
-                    result.storage()[pos + inner_stride] = std::get<0>(f)(result.storage()[pos],
-                                                                       result.storage()[pos + inner_stride]);
-                    pos += outer_stride;
+                    accumulate_scan_parallel(acc_fct, data + b * block_size, n);
                 }
-                pos += inner_stride;
+            }
+            else
+            {
+                // independent lanes: the work items are the blocks, or slices
+                // of their columns if there are not enough blocks
+                std::size_t n_chunks = 1;
+                if (n_blocks < min_work_items)
+                {
+                    n_chunks = (std::min)(row_size, (min_work_items + n_blocks - 1) / n_blocks);
+                }
+                parallel_for(std::size_t(0), n_blocks * n_chunks, std::size_t(1), [&](std::size_t first, std::size_t last) {
+                    for (std::size_t w = first; w < last; ++w)
+                    {
+                        std::size_t chunk = w % n_chunks;
+                        accumulate_block(w / n_chunks, row_size * chunk / n_chunks, row_size * (chunk + 1) / n_chunks);
+                    }
+                });
             }
             return result;
         }
 
+        // Copies the elements of e in XTENSOR_DEFAULT_LAYOUT order, directly
+        // from the storage when it is laid out in this order.
+        template <class E, class T>
+        inline void flat_copy(const E& e, T* dst)
+        {
+            using expression_type = std::decay_t<E>;
+            xtl::mpl::static_if<has_data_interface<expression_type>::value && expression_type::contiguous_layout &&
+                                expression_type::static_layout == XTENSOR_DEFAULT_LAYOUT>([&](auto self)
+            {
+                std::copy(self(e).data(), self(e).data() + std::ptrdiff_t(e.size()), dst);
+            }, /*else*/ [&](auto self)
+            {
+                std::copy(self(e).template cbegin<XTENSOR_DEFAULT_LAYOUT>(),
+                          self(e).template cend<XTENSOR_DEFAULT_LAYOUT>(), dst);
+            });
+        }
+
         template <class F, class E>
         inline auto accumulator_impl(F&& f, E&& e, evaluation_strategy::immediate)
         {
@@ -211,16 +336,21 @@ namespace xt
             using result_type = xtensor<T, 1>;
             std::size_t sz = e.size();
             auto result = result_type::from_shape({sz});
+            if (sz == 0)
+            {
+                return result;
+            }
 
-            auto it = e.template begin<XTENSOR_DEFAULT_LAYOUT>();
-
-            result.storage()[0] = std::get<1>(f)(*it);
-            ++it;
+            flat_copy(e, result.data());
+            result.data()[0] = std::get<1>(f)(result.data()[0]);
 
-            for (std::size_t idx = 0; it != e.template end<XTENSOR_DEFAULT_LAYOUT>(); ++it)
+            if (is_simd_accumulator<accumulate_functor, T>::value && parallel_enabled(sz))
+            {
+                accumulate_scan_parallel(std::get<0>(f), result.data(), sz);
+            }
+            else
             {
-                result.storage()[idx + 1] = std::get<0>(f)(result.storage()[idx], *it);
-                ++idx;
+                accumulate_scan(std::get<0>(f), result.data(), sz);
             }
             return result;
         }
@@ -0,0 +1,714 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_ALLOCATOR_HPP
+#define XTENSOR_ALLOCATOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+#include "xparallel.hpp"
+
+#ifndef XTENSOR_ARENA_ALIGNMENT
+#define XTENSOR_ARENA_ALIGNMENT 64
+#endif
+
+#ifndef XTENSOR_ARENA_BLOCK_SIZE
+#define XTENSOR_ARENA_BLOCK_SIZE (std::size_t(1) << 20)
+#endif
+
+#ifndef XTENSOR_HUGEPAGE_SIZE
+#define XTENSOR_HUGEPAGE_SIZE (std::size_t(1) << 21)
+#endif
+
+#ifndef XTENSOR_HUGEPAGE_THRESHOLD
+#define XTENSOR_HUGEPAGE_THRESHOLD (std::size_t(1) << 22)
+#endif
+
+namespace xt
+{
+
+    /*******************************
+     * temporary_arena declaration *
+     *******************************/
+
+    namespace detail
+    {
+        class arena_block;
+    }
+
+    /**
+     * @class temporary_arena
+     * @brief Scoped bump arena for the allocations of arena_allocator.
+     *
+     * While a temporary_arena is alive, the allocations made by
+     * arena_allocator in the thread that created it are carved out of
+     * blocks owned by the arena, and aligned on XTENSOR_ARENA_ALIGNMENT
+     * bytes. Deallocating does not return memory to the system: a block is
+     * recycled once all its allocations have been released, and the blocks
+     * are freed all at once when the arena is destroyed. Containers
+     * allocated in the scope of the arena may outlive it; the blocks they
+     * use are then freed when the last of them is destroyed.
+     *
+     * Arenas can be nested, the innermost one serves the allocations.
+     * Allocations made in other threads, for instance by the workers of
+     * the parallel assignment, are not affected.
+     */
+    class temporary_arena
+    {
+    public:
+
+        explicit temporary_arena(std::size_t block_size = XTENSOR_ARENA_BLOCK_SIZE);
+        ~temporary_arena();
+
+        temporary_arena(const temporary_arena&) = delete;
+        temporary_arena& operator=(const temporary_arena&) = delete;
+        temporary_arena(temporary_arena&&) = delete;
+        temporary_arena& operator=(temporary_arena&&) = delete;
+
+        void* allocate(std::size_t size);
+
+        std::size_t block_size() const noexcept;
+        std::size_t capacity() const noexcept;
+
+        static temporary_arena* current() noexcept;
+
+    private:
+
+        detail::arena_block* get_block(std::size_t size);
+
+        static temporary_arena*& current_impl() noexcept;
+
+        std::vector<detail::arena_block*> m_blocks;
+        detail::arena_block* p_current;
+        std::size_t m_block_size;
+        temporary_arena* p_previous;
+    };
+
+    /*******************************
+     * arena_allocator declaration *
+     *******************************/
+
+    /**
+     * @class arena_allocator
+     * @brief Allocator using the current temporary_arena.
+     *
+     * arena_allocator serves the allocations from the innermost
+     * temporary_arena of the calling thread, and falls back to the global
+     * operator new when there is none. The memory is aligned on
+     * XTENSOR_ARENA_ALIGNMENT bytes in both cases. The allocator is
+     * stateless: memory allocated by any instance can be deallocated by
+     * any other, in any thread.
+     *
+     * Defining XTENSOR_USE_ARENA makes it the default allocator of the
+     * xtensor containers.
+     *
+     * @tparam T the type of the allocated elements.
+     */
+    template <class T>
+    class arena_allocator
+    {
+    public:
+
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+
+        template <class U>
+        struct rebind
+        {
+            using other = arena_allocator<U>;
+        };
+
+        arena_allocator() noexcept = default;
+
+        template <class U>
+        arena_allocator(const arena_allocator<U>& rhs) noexcept;
+
+        pointer allocate(size_type n, const void* hint = nullptr);
+        void deallocate(pointer p, size_type n) noexcept;
+
+        size_type max_size() const noexcept;
+
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args);
+
+        template <class U>
+        void destroy(U* p);
+    };
+
+    template <class T, class U>
+    bool operator==(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs) noexcept;
+
+    template <class T, class U>
+    bool operator!=(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs) noexcept;
+
+    /**********************************
+     * hugepage_allocator declaration *
+     **********************************/
+
+    /**
+     * @class hugepage_allocator
+     * @brief Allocator backing large buffers with huge pages.
+     *
+     * Allocations of at least XTENSOR_HUGEPAGE_THRESHOLD bytes are mapped
+     * directly with mmap, aligned on XTENSOR_HUGEPAGE_SIZE bytes, and
+     * advised to use transparent huge pages. Smaller allocations are
+     * aligned on XTENSOR_ARENA_ALIGNMENT bytes and served by the global
+     * operator new, as well as all the allocations on platforms without
+     * mmap.
+     *
+     * When @p ParallelTouch is true, the pages of the large buffers are
+     * touched by the workers of parallel_for right after the allocation,
+     * each worker touching a contiguous range of elements. With a
+     * first-touch NUMA policy and a static scheduling (e.g. OpenMP), the
+     * chunks of the buffer are then spread over the NUMA nodes of the
+     * workers. The worker assigning a given chunk later is not
+     * guaranteed to be the one that touched it, in particular with TBB.
+     *
+     * Defining XTENSOR_USE_HUGEPAGES makes hugepage_allocator<T> the
+     * default allocator of the xtensor containers.
+     *
+     * @tparam T the type of the allocated elements.
+     * @tparam ParallelTouch whether the pages of large buffers are
+     *         touched in parallel at allocation.
+     */
+    template <class T, bool ParallelTouch = false>
+    class hugepage_allocator
+    {
+    public:
+
+        using value_type = T;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using reference = T&;
+        using const_reference = const T&;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal = std::true_type;
+
+        template <class U>
+        struct rebind
+        {
+            using other = hugepage_allocator<U, ParallelTouch>;
+        };
+
+        hugepage_allocator() noexcept = default;
+
+        template <class U>
+        hugepage_allocator(const hugepage_allocator<U, ParallelTouch>& rhs) noexcept;
+
+        pointer allocate(size_type n, const void* hint = nullptr);
+        void deallocate(pointer p, size_type n) noexcept;
+
+        size_type max_size() const noexcept;
+
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args);
+
+        template <class U>
+        void destroy(U* p);
+    };
+
+    template <class T, bool PT, class U, bool PU>
+    bool operator==(const hugepage_allocator<T, PT>& lhs, const hugepage_allocator<U, PU>& rhs) noexcept;
+
+    template <class T, bool PT, class U, bool PU>
+    bool operator!=(const hugepage_allocator<T, PT>& lhs, const hugepage_allocator<U, PU>& rhs) noexcept;
+
+    /******************
+     * implementation *
+     ******************/
+
+    namespace detail
+    {
+        constexpr std::size_t arena_alignment = XTENSOR_ARENA_ALIGNMENT;
+
+        static_assert((arena_alignment & (arena_alignment - 1)) == 0, "XTENSOR_ARENA_ALIGNMENT must be a power of 2");
+        static_assert(arena_alignment >= 2 * sizeof(void*), "XTENSOR_ARENA_ALIGNMENT is too small");
+
+        inline std::size_t arena_round_up(std::size_t size) noexcept
+        {
+            return (size + arena_alignment - 1) & ~(arena_alignment - 1);
+        }
+
+        inline char* arena_align(char* p) noexcept
+        {
+            return reinterpret_cast<char*>(arena_round_up(reinterpret_cast<std::uintptr_t>(p)));
+        }
+
+        // Memory block of a temporary_arena. The arena holds one reference
+        // on the block and each allocation carved out of it holds another
+        // one; the block is freed when the last reference is released.
+        class arena_block
+        {
+        public:
+
+            explicit arena_block(std::size_t capacity)
+                : p_raw(static_cast<char*>(::operator new(capacity + arena_alignment))),
+                  p_begin(arena_align(p_raw)), m_capacity(capacity), m_offset(0), m_refs(1)
+            {
+            }
+
+            ~arena_block()
+            {
+                ::operator delete(p_raw);
+            }
+
+            arena_block(const arena_block&) = delete;
+            arena_block& operator=(const arena_block&) = delete;
+
+            std::size_t capacity() const noexcept
+            {
+                return m_capacity;
+            }
+
+            // Only the owning arena holds a reference, the block can be
+            // recycled.
+            bool unused() const noexcept
+            {
+                return m_refs.load(std::memory_order_acquire) == 1;
+            }
+
+            void reset() noexcept
+            {
+                m_offset = 0;
+            }
+
+            bool fits(std::size_t size) const noexcept
+            {
+                return size <= m_capacity - m_offset;
+            }
+
+            char* allocate(std::size_t size) noexcept
+            {
+                char* res = p_begin + m_offset;
+                m_offset += size;
+                m_refs.fetch_add(1, std::memory_order_relaxed);
+                return res;
+            }
+
+            void release() noexcept
+            {
+                if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    delete this;
+                }
+            }
+
+        private:
+
+            char* p_raw;
+            char* p_begin;
+            std::size_t m_capacity;
+            std::size_t m_offset;
+            std::atomic<std::size_t> m_refs;
+        };
+
+        // Stored right before each block of memory returned by
+        // arena_allocate: p_block is the arena block holding the memory,
+        // or nullptr if it was allocated with the global operator new, in
+        // which case p_raw is the pointer to delete.
+        struct arena_header
+        {
+            arena_block* p_block;
+            void* p_raw;
+        };
+
+        inline arena_header* get_arena_header(void* p) noexcept
+        {
+            return reinterpret_cast<arena_header*>(static_cast<char*>(p) - sizeof(arena_header));
+        }
+
+        inline void* arena_allocate(std::size_t size)
+        {
+            temporary_arena* arena = temporary_arena::current();
+            if (arena != nullptr)
+            {
+                return arena->allocate(size);
+            }
+            char* raw = static_cast<char*>(::operator new(size + sizeof(arena_header) + arena_alignment));
+            char* res = arena_align(raw + sizeof(arena_header));
+            arena_header* header = get_arena_header(res);
+            header->p_block = nullptr;
+            header->p_raw = raw;
+            return res;
+        }
+
+        inline void arena_deallocate(void* p) noexcept
+        {
+            if (p != nullptr)
+            {
+                arena_header* header = get_arena_header(p);
+                if (header->p_block != nullptr)
+                {
+                    header->p_block->release();
+                }
+                else
+                {
+                    ::operator delete(header->p_raw);
+                }
+            }
+        }
+
+        constexpr std::size_t hugepage_size = XTENSOR_HUGEPAGE_SIZE;
+
+        static_assert((hugepage_size & (hugepage_size - 1)) == 0, "XTENSOR_HUGEPAGE_SIZE must be a power of 2");
+
+        inline bool use_hugepages(std::size_t size) noexcept
+        {
+#ifdef _WIN32
+            (void) size;
+            return false;
+#else
+            return size >= std::size_t(XTENSOR_HUGEPAGE_THRESHOLD);
+#endif
+        }
+
+        inline std::size_t hugepage_round_up(std::size_t size) noexcept
+        {
+            return (size + hugepage_size - 1) & ~(hugepage_size - 1);
+        }
+
+        inline void* aligned_new(std::size_t size)
+        {
+            char* raw = static_cast<char*>(::operator new(size + sizeof(void*) + arena_alignment));
+            char* res = arena_align(raw + sizeof(void*));
+            reinterpret_cast<void**>(res)[-1] = raw;
+            return res;
+        }
+
+        inline void aligned_delete(void* p) noexcept
+        {
+            if (p != nullptr)
+            {
+                ::operator delete(static_cast<void**>(p)[-1]);
+            }
+        }
+
+#ifndef _WIN32
+        // Maps size bytes aligned on a huge page. The mapping is one huge
+        // page larger than needed, the unaligned head and the tail are
+        // unmapped afterwards.
+        inline void* hugepage_map(std::size_t size)
+        {
+            std::size_t mapped_size = hugepage_round_up(size);
+            void* ptr = ::mmap(nullptr, mapped_size + hugepage_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ptr == MAP_FAILED)
+            {
+                throw std::bad_alloc();
+            }
+            char* raw = static_cast<char*>(ptr);
+            char* res = reinterpret_cast<char*>(hugepage_round_up(reinterpret_cast<std::uintptr_t>(raw)));
+            std::size_t head = static_cast<std::size_t>(res - raw);
+            if (head != 0)
+            {
+                ::munmap(raw, head);
+            }
+            // head < hugepage_size, the tail is never empty
+            ::munmap(res + mapped_size, hugepage_size - head);
+#ifdef MADV_HUGEPAGE
+            ::madvise(res, mapped_size, MADV_HUGEPAGE);
+#endif
+            return res;
+        }
+
+        inline void hugepage_unmap(void* p, std::size_t size) noexcept
+        {
+            ::munmap(p, hugepage_round_up(size));
+        }
+#endif
+
+        // Writes one byte per page of the n elements of size elem_size
+        // starting at p, distributing the elements among the workers.
+        inline void parallel_touch(void* p, std::size_t n, std::size_t elem_size)
+        {
+            if (!parallel_enabled(n))
+            {
+                return;
+            }
+            constexpr std::size_t page_size = 4096;
+            char* data = static_cast<char*>(p);
+            parallel_for(std::size_t(0), n, std::size_t(1), [data, elem_size](std::size_t first, std::size_t last) {
+                char* page_first = data + first * elem_size;
+                char* page_last = data + last * elem_size;
+                for (char* page = page_first; page < page_last; page += page_size)
+                {
+                    *static_cast<volatile char*>(page) = char(0);
+                }
+            });
+        }
+    }
+
+    /**********************************
+     * temporary_arena implementation *
+     **********************************/
+
+    /**
+     * Builds an arena allocating memory by blocks of @p block_size bytes
+     * and makes it the current arena of the calling thread.
+     * @param block_size the size of the memory blocks. Larger requests
+     *                   are served by dedicated blocks.
+     */
+    inline temporary_arena::temporary_arena(std::size_t block_size)
+        : m_blocks(), p_current(nullptr), m_block_size(detail::arena_round_up(block_size)), p_previous(current_impl())
+    {
+        current_impl() = this;
+    }
+
+    /**
+     * Restores the previous arena of the calling thread and releases the
+     * blocks of this arena. Arenas must be destroyed in the reverse order
+     * of their construction.
+     */
+    inline temporary_arena::~temporary_arena()
+    {
+        current_impl() = p_previous;
+        for (auto* block : m_blocks)
+        {
+            block->release();
+        }
+    }
+
+    /**
+     * Allocates @p size bytes from the arena.
+     */
+    inline void* temporary_arena::allocate(std::size_t size)
+    {
+        std::size_t slot_size = detail::arena_round_up(size) + detail::arena_alignment;
+        detail::arena_block* block = get_block(slot_size);
+        char* res = block->allocate(slot_size) + detail::arena_alignment;
+        detail::arena_header* header = detail::get_arena_header(res);
+        header->p_block = block;
+        header->p_raw = nullptr;
+        return res;
+    }
+
+    /**
+     * Returns the size of the memory blocks of the arena.
+     */
+    inline std::size_t temporary_arena::block_size() const noexcept
+    {
+        return m_block_size;
+    }
+
+    /**
+     * Returns the total size of the memory blocks owned by the arena.
+     */
+    inline std::size_t temporary_arena::capacity() const noexcept
+    {
+        std::size_t res = 0;
+        for (const auto* block : m_blocks)
+        {
+            res += block->capacity();
+        }
+        return res;
+    }
+
+    /**
+     * Returns the innermost arena of the calling thread, nullptr if there
+     * is none.
+     */
+    inline temporary_arena* temporary_arena::current() noexcept
+    {
+        return current_impl();
+    }
+
+    inline detail::arena_block* temporary_arena::get_block(std::size_t size)
+    {
+        if (p_current != nullptr)
+        {
+            if (p_current->unused())
+            {
+                p_current->reset();
+            }
+            if (p_current->fits(size))
+            {
+                return p_current;
+            }
+        }
+        auto it = std::find_if(m_blocks.begin(), m_blocks.end(), [size](detail::arena_block* block) {
+            return block->unused() && size <= block->capacity();
+        });
+        if (it != m_blocks.end())
+        {
+            p_current = *it;
+            p_current->reset();
+            return p_current;
+        }
+        m_blocks.reserve(m_blocks.size() + 1);
+        p_current = new detail::arena_block((std::max)(size, m_block_size));
+        m_blocks.push_back(p_current);
+        return p_current;
+    }
+
+    inline temporary_arena*& temporary_arena::current_impl() noexcept
+    {
+        static thread_local temporary_arena* arena = nullptr;
+        return arena;
+    }
+
+    /**********************************
+     * arena_allocator implementation *
+     **********************************/
+
+    template <class T>
+    template <class U>
+    inline arena_allocator<T>::arena_allocator(const arena_allocator<U>&) noexcept
+    {
+    }
+
+    template <class T>
+    inline auto arena_allocator<T>::allocate(size_type n, const void*) -> pointer
+    {
+        if (n > max_size())
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<pointer>(detail::arena_allocate(n * sizeof(T)));
+    }
+
+    template <class T>
+    inline void arena_allocator<T>::deallocate(pointer p, size_type) noexcept
+    {
+        detail::arena_deallocate(p);
+    }
+
+    template <class T>
+    inline auto arena_allocator<T>::max_size() const noexcept -> size_type
+    {
+        return (std::numeric_limits<size_type>::max() - 2 * detail::arena_alignment) / sizeof(T);
+    }
+
+    template <class T>
+    template <class U, class... Args>
+    inline void arena_allocator<T>::construct(U* p, Args&&... args)
+    {
+        new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <class T>
+    template <class U>
+    inline void arena_allocator<T>::destroy(U* p)
+    {
+        p->~U();
+    }
+
+    template <class T, class U>
+    inline bool operator==(const arena_allocator<T>&, const arena_allocator<U>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    inline bool operator!=(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    /*************************************
+     * hugepage_allocator implementation *
+     *************************************/
+
+    template <class T, bool ParallelTouch>
+    template <class U>
+    inline hugepage_allocator<T, ParallelTouch>::hugepage_allocator(const hugepage_allocator<U, ParallelTouch>&) noexcept
+    {
+    }
+
+    template <class T, bool ParallelTouch>
+    inline auto hugepage_allocator<T, ParallelTouch>::allocate(size_type n, const void*) -> pointer
+    {
+        if (n > max_size())
+        {
+            throw std::bad_alloc();
+        }
+        std::size_t size = n * sizeof(T);
+#ifndef _WIN32
+        if (detail::use_hugepages(size))
+        {
+            void* res = detail::hugepage_map(size);
+            if (ParallelTouch)
+            {
+                detail::parallel_touch(res, n, sizeof(T));
+            }
+            return static_cast<pointer>(res);
+        }
+#endif
+        return static_cast<pointer>(detail::aligned_new(size));
+    }
+
+    template <class T, bool ParallelTouch>
+    inline void hugepage_allocator<T, ParallelTouch>::deallocate(pointer p, size_type n) noexcept
+    {
+        std::size_t size = n * sizeof(T);
+#ifndef _WIN32
+        if (detail::use_hugepages(size))
+        {
+            detail::hugepage_unmap(p, size);
+            return;
+        }
+#endif
+        detail::aligned_delete(p);
+    }
+
+    template <class T, bool ParallelTouch>
+    inline auto hugepage_allocator<T, ParallelTouch>::max_size() const noexcept -> size_type
+    {
+        return (std::numeric_limits<size_type>::max() - 2 * detail::hugepage_size) / sizeof(T);
+    }
+
+    template <class T, bool ParallelTouch>
+    template <class U, class... Args>
+    inline void hugepage_allocator<T, ParallelTouch>::construct(U* p, Args&&... args)
+    {
+        new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <class T, bool ParallelTouch>
+    template <class U>
+    inline void hugepage_allocator<T, ParallelTouch>::destroy(U* p)
+    {
+        p->~U();
+    }
+
+    template <class T, bool PT, class U, bool PU>
+    inline bool operator==(const hugepage_allocator<T, PT>&, const hugepage_allocator<U, PU>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, bool PT, class U, bool PU>
+    inline bool operator!=(const hugepage_allocator<T, PT>& lhs, const hugepage_allocator<U, PU>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+}
+
+#endif
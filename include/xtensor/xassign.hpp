@@ -10,6 +10,10 @@
 #define XTENSOR_ASSIGN_HPP
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
@@ -18,12 +22,27 @@
 #include "xconcepts.hpp"
 #include "xexpression.hpp"
 #include "xiterator.hpp"
+#include "xparallel.hpp"
 #include "xstrides.hpp"
 #include "xtensor_forward.hpp"
 #include "xutils.hpp"
 
 namespace xt
 {
+    template <class CT, class X>
+    class xbroadcast;
+
+    template <class CT, class S, layout_type L, class FS>
+    class xstrided_view;
+
+    template <class CT, class I>
+    class xindex_view;
+
+    template <class F, class CT>
+    class xfunctor_view;
+
+    template <class F, class CT, class X>
+    class xreducer;
 
     /********************
      * Assign functions *
@@ -113,12 +132,43 @@ namespace xt
 
     private:
 
+        using axes_type = dynamic_shape<size_type>;
+
+        bool use_tiles() const;
+        void run_tiled();
+        void run_band(size_type row_begin);
+        void collapse_axes();
+        bool use_rows();
+        void run_parallel();
+        void run_steps(size_type n);
+        template <class F>
+        void for_each_row(size_type n, F&& f);
+        void assign_row(size_type n, size_type axis);
+        void assign_row(size_type n, size_type axis, size_type flat_index, std::true_type);
+        void assign_row(size_type n, size_type axis, size_type flat_index, std::false_type);
+        void run_rows(size_type n, std::true_type);
+        void run_rows(size_type n, std::false_type);
+        size_type linear_index() const;
+        void seek(size_type outer_index, size_type n_outer_axes);
+        void step_back(size_type i, size_type n);
+
         E1& m_e1;
+        const E2& m_e2;
 
         lhs_iterator m_lhs;
         rhs_iterator m_rhs;
 
         index_type m_index;
+
+        // Iteration plan, computed by run() before any worker is created: the
+        // innermost axis and the extent of each group of collapsed axes, from
+        // the outermost to the innermost one, and the strides along the
+        // innermost group when rows are assigned through raw pointers.
+        axes_type m_axes;
+        axes_type m_extents;
+        bool m_rows;
+        std::ptrdiff_t m_lhs_stride;
+        std::ptrdiff_t m_rhs_stride;
     };
 
     /********************
@@ -132,6 +182,22 @@ namespace xt
         static void run(E1& e1, const E2& e2);
     };
 
+    /******************
+     * fixed_assigner *
+     ******************/
+
+    /**
+     * Trivial assignment to a container whose number of elements is known at
+     * compile time. The loops over the elements and the batches are fully
+     * unrolled, without alignment prologue nor parallel dispatch.
+     */
+    template <bool simd_assign>
+    struct fixed_assigner
+    {
+        template <class E1, class E2>
+        static void run(E1& e1, const E2& e2);
+    };
+
     /***********************************
      * Assign functions implementation *
      ***********************************/
@@ -238,6 +304,189 @@ namespace xt
             static constexpr bool value = xtl::disjunction<
                 std::integral_constant<bool, forbid_simd_assign<typename std::decay<CT>::type>::value>...>::value;
         };
+
+        // Expressions whose evaluation mutates a shared state (such as the
+        // random generators) must not be assigned by several workers at once.
+        // Such expressions specialize this trait.
+        template <class E>
+        struct forbid_parallel_assign : std::false_type
+        {
+        };
+
+        template <class F, class R, class... CT>
+        struct forbid_parallel_assign<xfunction<F, R, CT...>>
+            : xtl::disjunction<forbid_parallel_assign<std::decay_t<CT>>...>
+        {
+        };
+
+        // Views, broadcasts and reducers evaluate the underlying expression
+        // when they are evaluated.
+        template <class CT, class... S>
+        struct forbid_parallel_assign<xview<CT, S...>> : forbid_parallel_assign<std::decay_t<CT>>
+        {
+        };
+
+        template <class CT, class X>
+        struct forbid_parallel_assign<xbroadcast<CT, X>> : forbid_parallel_assign<std::decay_t<CT>>
+        {
+        };
+
+        template <class CT, class S, layout_type L, class FS>
+        struct forbid_parallel_assign<xstrided_view<CT, S, L, FS>> : forbid_parallel_assign<std::decay_t<CT>>
+        {
+        };
+
+        template <class CT, class I>
+        struct forbid_parallel_assign<xindex_view<CT, I>> : forbid_parallel_assign<std::decay_t<CT>>
+        {
+        };
+
+        template <class F, class CT>
+        struct forbid_parallel_assign<xfunctor_view<F, CT>> : forbid_parallel_assign<std::decay_t<CT>>
+        {
+        };
+
+        template <class F, class CT, class X>
+        struct forbid_parallel_assign<xreducer<F, CT, X>> : forbid_parallel_assign<std::decay_t<CT>>
+        {
+        };
+
+        template <class E, class = void>
+        struct has_strides : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_strides<E, void_t<decltype(std::declval<const E&>().strides())>> : std::true_type
+        {
+        };
+
+        // Returns true if stepping along the inner axis of an assignment in the
+        // layout L jumps further in memory than stepping along the next axis,
+        // as with the transpose of a container of the opposite layout.
+        template <layout_type L, class S>
+        inline bool is_transposed_strides(const S& strides, std::size_t dim)
+        {
+            std::size_t size = strides.size();
+            if (dim < 2 || size < 2 || size > dim)
+            {
+                return false;
+            }
+            std::size_t offset = dim - size;
+            std::size_t inner = L == layout_type::row_major ? dim - 1 : 0;
+            std::size_t outer = L == layout_type::row_major ? dim - 2 : 1;
+            if (inner < offset || outer < offset)
+            {
+                return false;
+            }
+            std::ptrdiff_t inner_stride = std::abs(static_cast<std::ptrdiff_t>(strides[inner - offset]));
+            std::ptrdiff_t outer_stride = std::abs(static_cast<std::ptrdiff_t>(strides[outer - offset]));
+            return outer_stride != 0 && inner_stride > outer_stride;
+        }
+
+        template <layout_type L, class E>
+        inline std::enable_if_t<has_strides<E>::value, bool>
+        is_transposed_access(const E& e, std::size_t dim)
+        {
+            return is_transposed_strides<L>(e.strides(), dim);
+        }
+
+        template <layout_type L, class E>
+        inline std::enable_if_t<!has_strides<E>::value, bool>
+        is_transposed_access(const E&, std::size_t)
+        {
+            return false;
+        }
+
+        template <layout_type L, class F, class R, class... CT>
+        inline bool is_transposed_access(const xfunction<F, R, CT...>& e, std::size_t dim);
+
+        template <layout_type L, class T, std::size_t... I>
+        inline bool is_transposed_arguments(const T& args, std::size_t dim, std::index_sequence<I...>)
+        {
+            bool res = false;
+            auto dummy = {(res = res || is_transposed_access<L>(std::get<I>(args), dim))...};
+            (void) dummy;
+            return res;
+        }
+
+        template <layout_type L, class F, class R, class... CT>
+        inline bool is_transposed_access(const xfunction<F, R, CT...>& e, std::size_t dim)
+        {
+            return is_transposed_arguments<L>(e.arguments(), dim, std::make_index_sequence<sizeof...(CT)>());
+        }
+
+        // Expressions whose elements along the inner axis of an assignment
+        // can be addressed from the element their stepper points to.
+        template <class E>
+        using has_strided_rows = xtl::conjunction<has_data_interface<E>, has_strides<E>>;
+
+        // Returns the stride of e along the given axis of a dim-dimensional
+        // assignment, 0 if that axis is broadcast. Expressions without strides
+        // are indexed linearly.
+        template <class E>
+        inline std::enable_if_t<!has_strides<E>::value, std::ptrdiff_t>
+        axis_stride(const E&, std::size_t, std::size_t)
+        {
+            return 1;
+        }
+
+        template <class E>
+        inline std::enable_if_t<has_strides<E>::value, std::ptrdiff_t>
+        axis_stride(const E& e, std::size_t axis, std::size_t dim)
+        {
+            const auto& shape = e.shape();
+            std::size_t size = shape.size();
+            if (axis + size < dim)
+            {
+                return 0;
+            }
+            std::size_t i = axis + size - dim;
+            return shape[i] == 1 ? 0 : static_cast<std::ptrdiff_t>(e.strides()[i]);
+        }
+
+        // Returns true if stepping e once along the inner axis past its last
+        // index reaches the next index along the outer axis, so that both
+        // axes can be iterated as a single one. Expressions without strides
+        // are conservatively not collapsed.
+        template <class E, class S>
+        inline std::enable_if_t<has_strides<E>::value, bool>
+        is_collapsible(const E& e, std::size_t outer, std::size_t inner, const S& shape)
+        {
+            std::size_t dim = shape.size();
+            return axis_stride(e, outer, dim) == static_cast<std::ptrdiff_t>(shape[inner]) * axis_stride(e, inner, dim);
+        }
+
+        template <class E, class S>
+        inline std::enable_if_t<!has_strides<E>::value, bool>
+        is_collapsible(const E&, std::size_t, std::size_t, const S&)
+        {
+            return false;
+        }
+
+        template <class CT, class S>
+        inline bool is_collapsible(const xscalar<CT>&, std::size_t, std::size_t, const S&)
+        {
+            return true;
+        }
+
+        template <class F, class R, class... CT, class S>
+        inline bool is_collapsible(const xfunction<F, R, CT...>& e, std::size_t outer, std::size_t inner, const S& shape);
+
+        template <class T, class S, std::size_t... I>
+        inline bool is_collapsible_arguments(const T& args, std::size_t outer, std::size_t inner, const S& shape, std::index_sequence<I...>)
+        {
+            bool res = true;
+            auto dummy = {(res = res && is_collapsible(std::get<I>(args), outer, inner, shape))...};
+            (void) dummy;
+            return res;
+        }
+
+        template <class F, class R, class... CT, class S>
+        inline bool is_collapsible(const xfunction<F, R, CT...>& e, std::size_t outer, std::size_t inner, const S& shape)
+        {
+            return is_collapsible_arguments(e.arguments(), outer, inner, shape, std::make_index_sequence<sizeof...(CT)>());
+        }
     }
 
     template <class E1, class E2>
@@ -250,6 +499,10 @@ namespace xt
         static constexpr bool simd_size() { return xsimd::simd_traits<typename E1::value_type>::size > 1; }
         static constexpr bool forbid_simd() { return detail::forbid_simd_assign<E2>::value; }
         static constexpr bool simd_assign() { return contiguous_layout() && same_type() && simd_size() && !forbid_simd(); }
+        static constexpr bool forbid_parallel() { return detail::forbid_parallel_assign<E2>::value; }
+        static constexpr bool flat_rows() { return E2::contiguous_layout && simd_size() && !forbid_simd(); }
+        static constexpr bool row_assign() { return same_type() && detail::has_strided_rows<E1>::value && (detail::has_strided_rows<E2>::value || flat_rows()); }
+        static constexpr bool fixed_assign() { return fixed_size<E1>::value != 0 && fixed_size<E1>::value <= XTENSOR_FIXED_UNROLL_SIZE; }
     };
 
     template <class E1, class E2>
@@ -262,7 +515,10 @@ namespace xt
         if (trivial_broadcast)
         {
             constexpr bool simd_assign = xassign_traits<E1, E2>::simd_assign();
-            trivial_assigner<simd_assign>::run(de1, de2);
+            using assigner_type = std::conditional_t<xassign_traits<E1, E2>::fixed_assign(),
+                                                     fixed_assigner<simd_assign>,
+                                                     trivial_assigner<simd_assign>>;
+            assigner_type::run(de1, de2);
         }
         else
         {
@@ -346,25 +602,434 @@ namespace xt
 
     template <class E1, class E2, layout_type L>
     inline data_assigner<E1, E2, L>::data_assigner(E1& e1, const E2& e2)
-        : m_e1(e1), m_lhs(e1.stepper_begin(e1.shape())),
+        : m_e1(e1), m_e2(e2), m_lhs(e1.stepper_begin(e1.shape())),
           m_rhs(e2.stepper_begin(e1.shape())),
-          m_index(xtl::make_sequence<index_type>(e1.shape().size(), size_type(0)))
+          m_index(xtl::make_sequence<index_type>(e1.shape().size(), size_type(0))),
+          m_rows(false), m_lhs_stride(1), m_rhs_stride(1)
     {
     }
 
     template <class E1, class E2, layout_type L>
     inline void data_assigner<E1, E2, L>::run()
     {
-        using size_type = typename E1::size_type;
+        if (use_tiles())
+        {
+            run_tiled();
+            return;
+        }
+        // The strides of the views are lazily computed, planning the
+        // iteration here retrieves them before any worker is created.
+        collapse_axes();
+        m_rows = use_rows();
+        size_type s = m_e1.size();
+        if (!xassign_traits<E1, E2>::forbid_parallel() && parallel_enabled(s))
+        {
+            run_parallel();
+        }
+        else
+        {
+            run_steps(s);
+        }
+    }
+
+    /**
+     * Drops the axes of length 1 and merges the adjacent axes (in the
+     * iteration order) that both operands can step through as a single one.
+     * A broadcast where a single axis differs is then iterated as a 2-D
+     * expression with long rows, instead of carrying the full index on
+     * every element.
+     */
+    template <class E1, class E2, layout_type L>
+    inline void data_assigner<E1, E2, L>::collapse_axes()
+    {
+        const auto& shape = m_e1.shape();
+        size_type dim = shape.size();
+        m_axes.resize(0);
+        m_extents.resize(0);
+        for (size_type i = 0; i < dim; ++i)
+        {
+            size_type axis = L == layout_type::row_major ? i : dim - i - 1;
+            if (shape[axis] == 1)
+            {
+                continue;
+            }
+            if (!m_axes.empty() && detail::is_collapsible(m_e1, m_axes.back(), axis, shape) &&
+                detail::is_collapsible(m_e2, m_axes.back(), axis, shape))
+            {
+                m_axes.back() = axis;
+                m_extents.back() *= shape[axis];
+            }
+            else
+            {
+                m_axes.push_back(axis);
+                m_extents.push_back(shape[axis]);
+            }
+        }
+    }
+
+    /**
+     * Rows of the collapsed shape are assigned through raw pointers, with
+     * SIMD loads and stores when both sides have a unit stride, if the
+     * left-hand side exposes its data and strides and the right-hand side
+     * either does so or is a contiguous expression of the same shape and
+     * layout that can be indexed linearly.
+     */
+    template <class E1, class E2, layout_type L>
+    inline bool data_assigner<E1, E2, L>::use_rows()
+    {
+        if (!xassign_traits<E1, E2>::row_assign() || m_axes.empty())
+        {
+            return false;
+        }
+        size_type dim = m_e1.dimension();
+        m_lhs_stride = detail::axis_stride(m_e1, m_axes.back(), dim);
+        m_rhs_stride = detail::axis_stride(m_e2, m_axes.back(), dim);
+        if (detail::has_strided_rows<E2>::value)
+        {
+            return true;
+        }
+        const auto& shape = m_e1.shape();
+        if (E2::static_layout != L || m_e2.dimension() != dim ||
+            !std::equal(shape.cbegin(), shape.cend(), m_e2.shape().cbegin()))
+        {
+            return false;
+        }
+        dynamic_shape<std::size_t> strides = xtl::make_sequence<dynamic_shape<std::size_t>>(dim, std::size_t(0));
+        compute_strides(shape, L, strides);
+        return m_e2.is_trivial_broadcast(strides);
+    }
+
+    /**
+     * Splits the outer dimensions (in the iteration order) among the workers.
+     * The outer block spans as few axes as possible while still providing a
+     * few work items per worker, each worker steps its own pair of steppers
+     * over a contiguous range of outer indices.
+     */
+    template <class E1, class E2, layout_type L>
+    inline void data_assigner<E1, E2, L>::run_parallel()
+    {
+        const auto& shape = m_e1.shape();
+        size_type dim = shape.size();
+        size_type min_outer_size = 4 * parallel_concurrency();
+        size_type outer_size = 1;
+        size_type n_outer_axes = 0;
+        while (n_outer_axes < dim && outer_size < min_outer_size)
+        {
+            size_type axis = L == layout_type::row_major ? n_outer_axes : dim - n_outer_axes - 1;
+            outer_size *= shape[axis];
+            ++n_outer_axes;
+        }
+        size_type inner_size = m_e1.size() / outer_size;
+
+        // The steppers of this assigner have already been built, so the lazily
+        // computed members of the expressions are not modified by the workers.
+        // The workers copy them along with the iteration plan.
+        parallel_for(size_type(0), outer_size, size_type(1), [this, inner_size, n_outer_axes](size_type first, size_type last) {
+            data_assigner worker(*this);
+            worker.seek(first, n_outer_axes);
+            worker.run_steps((last - first) * inner_size);
+        });
+    }
+
+    template <class E1, class E2, layout_type L>
+    inline void data_assigner<E1, E2, L>::run_steps(size_type n)
+    {
+        if (m_rows)
+        {
+            run_rows(n, std::integral_constant<bool, xassign_traits<E1, E2>::row_assign()>());
+        }
+        else
+        {
+            run_rows(n, std::false_type());
+        }
+    }
+
+    /**
+     * Calls f(row_size, axis) on the successive rows of the collapsed shape
+     * that cover the n elements following the current position. f assigns
+     * row_size elements along axis from the current position and leaves
+     * the steppers on the last of them.
+     */
+    template <class E1, class E2, layout_type L>
+    template <class F>
+    inline void data_assigner<E1, E2, L>::for_each_row(size_type n, F&& f)
+    {
+        if (n == 0)
+        {
+            return;
+        }
+        size_type n_groups = m_axes.size();
+        if (n_groups == 0)
+        {
+            f(size_type(1), size_type(0));
+            return;
+        }
+
+        const auto& shape = m_e1.shape();
+        size_type dim = shape.size();
+        axes_type index = xtl::make_sequence<axes_type>(n_groups, size_type(0));
+        for (size_type i = 0, g = 0; i < dim && g < n_groups; ++i)
+        {
+            size_type axis = L == layout_type::row_major ? i : dim - i - 1;
+            index[g] = index[g] * shape[axis] + m_index[axis];
+            if (axis == m_axes[g])
+            {
+                ++g;
+            }
+        }
+
+        size_type inner = n_groups - 1;
+        while (true)
+        {
+            size_type row_size = (std::min)(n, m_extents[inner] - index[inner]);
+            f(row_size, m_axes[inner]);
+            n -= row_size;
+            if (n == 0)
+            {
+                return;
+            }
+            // The row ended on the last index of the inner group
+            step_back(m_axes[inner], m_extents[inner] - 1);
+            index[inner] = 0;
+            size_type g = inner;
+            while (g != 0)
+            {
+                --g;
+                if (index[g] + 1 != m_extents[g])
+                {
+                    ++index[g];
+                    step(m_axes[g]);
+                    break;
+                }
+                step_back(m_axes[g], m_extents[g] - 1);
+                index[g] = 0;
+            }
+        }
+    }
+
+    template <class E1, class E2, layout_type L>
+    inline void data_assigner<E1, E2, L>::assign_row(size_type n, size_type axis)
+    {
         using argument_type = std::decay_t<decltype(*m_rhs)>;
         using result_type = std::decay_t<decltype(*m_lhs)>;
         constexpr bool is_narrowing = is_narrowing_conversion<argument_type, result_type>::value;
 
-        size_type s = m_e1.size();
-        for (size_type i = 0; i < s; ++i)
+        for (size_type i = 0; i < n; ++i)
         {
+            if (i != 0)
+            {
+                step(axis);
+            }
             *m_lhs = conditional_cast<is_narrowing, result_type>(*m_rhs);
-            stepper_tools<L>::increment_stepper(*this, m_index, m_e1.shape());
+        }
+    }
+
+    template <class E1, class E2, layout_type L>
+    inline void data_assigner<E1, E2, L>::assign_row(size_type n, size_type axis, size_type, std::true_type)
+    {
+        using value_type = typename E1::value_type;
+        constexpr size_type simd_size = xsimd::simd_traits<value_type>::size;
+        value_type* dst = std::addressof(*m_lhs);
+        const value_type* src = std::addressof(*m_rhs);
+        size_type i = 0;
+        if (m_lhs_stride == 1 && m_rhs_stride == 1)
+        {
+            for (; i + simd_size <= n; i += simd_size)
+            {
+                xsimd::store_simd(dst + i, xsimd::load_simd(src + i, unaligned_mode()), unaligned_mode());
+            }
+        }
+        for (; i < n; ++i)
+        {
+            std::ptrdiff_t j = static_cast<std::ptrdiff_t>(i);
+            dst[j * m_lhs_stride] = src[j * m_rhs_stride];
+        }
+        if (n > 1)
+        {
+            step(axis, n - 1);
+        }
+    }
+
+    template <class E1, class E2, layout_type L>
+    inline void data_assigner<E1, E2, L>::assign_row(size_type n, size_type axis, size_type flat_index, std::false_type)
+    {
+        using value_type = typename E1::value_type;
+        using simd_type = xsimd::simd_type<value_type>;
+        constexpr size_type simd_size = xsimd::simd_traits<value_type>::size;
+        value_type* dst = std::addressof(*m_lhs);
+        size_type i = 0;
+        if (m_lhs_stride == 1)
+        {
+            for (; i + simd_size <= n; i += simd_size)
+            {
+                xsimd::store_simd(dst + i, m_e2.template load_simd<unaligned_mode, simd_type>(flat_index + i), unaligned_mode());
+            }
+        }
+        for (; i < n; ++i)
+        {
+            dst[static_cast<std::ptrdiff_t>(i) * m_lhs_stride] = m_e2.data_element(flat_index + i);
+        }
+        if (n > 1)
+        {
+            step(axis, n - 1);
+        }
+    }
+
+    /**
+     * Assigns the rows through raw pointers, see use_rows.
+     */
+    template <class E1, class E2, layout_type L>
+    inline void data_assigner<E1, E2, L>::run_rows(size_type n, std::true_type)
+    {
+        size_type flat_index = linear_index();
+        for_each_row(n, [this, &flat_index](size_type row_size, size_type axis) {
+            assign_row(row_size, axis, flat_index, std::integral_constant<bool, detail::has_strided_rows<E2>::value>());
+            flat_index += row_size;
+        });
+    }
+
+    /**
+     * Assigns the rows element by element through the steppers.
+     */
+    template <class E1, class E2, layout_type L>
+    inline void data_assigner<E1, E2, L>::run_rows(size_type n, std::false_type)
+    {
+        for_each_row(n, [this](size_type row_size, size_type axis) { assign_row(row_size, axis); });
+    }
+
+    template <class E1, class E2, layout_type L>
+    inline auto data_assigner<E1, E2, L>::linear_index() const -> size_type
+    {
+        const auto& shape = m_e1.shape();
+        size_type dim = shape.size();
+        size_type res = 0;
+        for (size_type i = 0; i < dim; ++i)
+        {
+            size_type axis = L == layout_type::row_major ? i : dim - i - 1;
+            res = res * shape[axis] + m_index[axis];
+        }
+        return res;
+    }
+
+    /**
+     * Tiles are worth it when one of the operands is accessed in the opposite
+     * order of its memory layout and the two inner dimensions (in the
+     * iteration order) span several tiles. Expressions that forbid parallel
+     * assignment depend on the order of evaluation and are never tiled.
+     */
+    template <class E1, class E2, layout_type L>
+    inline bool data_assigner<E1, E2, L>::use_tiles() const
+    {
+        const auto& shape = m_e1.shape();
+        size_type dim = shape.size();
+        if (xassign_traits<E1, E2>::forbid_parallel() || dim < 2)
+        {
+            return false;
+        }
+        size_type tile = XTENSOR_ASSIGN_TILE_SIZE;
+        size_type row_axis = L == layout_type::row_major ? dim - 2 : 1;
+        size_type col_axis = L == layout_type::row_major ? dim - 1 : 0;
+        return shape[row_axis] > tile && shape[col_axis] > tile &&
+            (detail::is_transposed_access<L>(m_e1, dim) || detail::is_transposed_access<L>(m_e2, dim));
+    }
+
+    /**
+     * Splits the assignment into bands of XTENSOR_ASSIGN_TILE_SIZE rows of the
+     * two inner dimensions, for each index of the outer dimensions. The bands
+     * are split among the workers and each band is assigned tile by tile, so
+     * that the cache lines of the transposed operand are reused across the
+     * rows of a tile instead of being evicted after a single element.
+     */
+    template <class E1, class E2, layout_type L>
+    inline void data_assigner<E1, E2, L>::run_tiled()
+    {
+        const auto& shape = m_e1.shape();
+        size_type dim = shape.size();
+        size_type tile = XTENSOR_ASSIGN_TILE_SIZE;
+        size_type row_axis = L == layout_type::row_major ? dim - 2 : 1;
+        size_type col_axis = L == layout_type::row_major ? dim - 1 : 0;
+        size_type n_row_tiles = (shape[row_axis] + tile - 1) / tile;
+        size_type n_bands = m_e1.size() / (shape[row_axis] * shape[col_axis]) * n_row_tiles;
+
+        // As in run_parallel, the workers copy the steppers of this assigner
+        // instead of building new ones from the shared expressions.
+        auto run_bands = [this, dim, tile, n_row_tiles](size_type first, size_type last) {
+            for (size_type b = first; b < last; ++b)
+            {
+                data_assigner worker(*this);
+                worker.seek(b / n_row_tiles, dim - 2);
+                worker.run_band((b % n_row_tiles) * tile);
+            }
+        };
+
+        if (parallel_enabled(m_e1.size()))
+        {
+            parallel_for(size_type(0), n_bands, size_type(1), run_bands);
+        }
+        else
+        {
+            run_bands(size_type(0), n_bands);
+        }
+    }
+
+    template <class E1, class E2, layout_type L>
+    inline void data_assigner<E1, E2, L>::run_band(size_type row_begin)
+    {
+        using argument_type = std::decay_t<decltype(*m_rhs)>;
+        using result_type = std::decay_t<decltype(*m_lhs)>;
+        constexpr bool is_narrowing = is_narrowing_conversion<argument_type, result_type>::value;
+
+        const auto& shape = m_e1.shape();
+        size_type dim = shape.size();
+        size_type tile = XTENSOR_ASSIGN_TILE_SIZE;
+        size_type row_axis = L == layout_type::row_major ? dim - 2 : 1;
+        size_type col_axis = L == layout_type::row_major ? dim - 1 : 0;
+        size_type n_rows = (std::min)(tile, shape[row_axis] - row_begin);
+        size_type n_cols = shape[col_axis];
+
+        // The steppers never move past the last element of the band, so that
+        // they remain valid for any underlying iterator.
+        step(row_axis, row_begin);
+        for (size_type col_begin = 0; col_begin < n_cols; col_begin += tile)
+        {
+            size_type tile_cols = (std::min)(tile, n_cols - col_begin);
+            for (size_type i = 0; i < n_rows; ++i)
+            {
+                *m_lhs = conditional_cast<is_narrowing, result_type>(*m_rhs);
+                for (size_type j = 1; j < tile_cols; ++j)
+                {
+                    step(col_axis);
+                    *m_lhs = conditional_cast<is_narrowing, result_type>(*m_rhs);
+                }
+                step_back(col_axis, tile_cols - 1);
+                if (i + 1 < n_rows)
+                {
+                    step(row_axis);
+                }
+            }
+            step_back(row_axis, n_rows - 1);
+            if (col_begin + tile_cols < n_cols)
+            {
+                step(col_axis, tile_cols);
+            }
+        }
+    }
+
+    template <class E1, class E2, layout_type L>
+    inline void data_assigner<E1, E2, L>::seek(size_type outer_index, size_type n_outer_axes)
+    {
+        const auto& shape = m_e1.shape();
+        size_type dim = shape.size();
+        for (size_type i = n_outer_axes; i != 0; --i)
+        {
+            size_type axis = L == layout_type::row_major ? i - 1 : dim - i;
+            size_type n = outer_index % shape[axis];
+            outer_index /= shape[axis];
+            if (n != 0)
+            {
+                m_index[axis] = n;
+                step(axis, n);
+            }
         }
     }
 
@@ -382,6 +1047,13 @@ namespace xt
         m_rhs.step(i, n);
     }
 
+    template <class E1, class E2, layout_type L>
+    inline void data_assigner<E1, E2, L>::step_back(size_type i, size_type n)
+    {
+        m_lhs.step_back(i, n);
+        m_rhs.step_back(i, n);
+    }
+
     template <class E1, class E2, layout_type L>
     inline void data_assigner<E1, E2, L>::reset(size_type i)
     {
@@ -416,13 +1088,26 @@ namespace xt
         size_type align_begin = is_aligned ? 0 : xsimd::get_alignment_offset(e1.data(), size, simd_size);
         size_type align_end = align_begin + ((size - align_begin) & ~(simd_size - 1));
 
+        auto assign_simd = [&e1, &e2, simd_size](size_type first, size_type last) {
+            for (size_type i = first; i < last; i += simd_size)
+            {
+                e1.template store_simd<lhs_align_mode, simd_type>(i, e2.template load_simd<rhs_align_mode, simd_type>(i));
+            }
+        };
+
         for (size_type i = 0; i < align_begin; ++i)
         {
             e1.data_element(i) = e2.data_element(i);
         }
-        for (size_type i = align_begin; i < align_end; i += simd_size)
+        if (!xassign_traits<E1, E2>::forbid_parallel() && parallel_enabled(size))
         {
-            e1.template store_simd<lhs_align_mode, simd_type>(i, e2.template load_simd<rhs_align_mode, simd_type>(i));
+            // Chunk bounds are multiples of simd_size, so that aligned
+            // loads and stores remain aligned in every worker.
+            parallel_for(align_begin, align_end, simd_size, assign_simd);
+        }
+        else
+        {
+            assign_simd(align_begin, align_end);
         }
         for (size_type i = align_end; i < size; ++i)
         {
@@ -435,7 +1120,23 @@ namespace xt
         template <class E1, class E2>
         inline void trivial_assigner_run_impl(E1& e1, const E2& e2, std::true_type)
         {
-            std::transform(e2.storage_cbegin(), e2.storage_cend(), e1.storage_begin(), [](typename E2::value_type x) { return static_cast<typename E1::value_type>(x); });
+            using size_type = typename E1::size_type;
+            size_type size = e1.size();
+            if (!xassign_traits<E1, E2>::forbid_parallel() && parallel_enabled(size))
+            {
+                using lhs_difference_type = typename E1::difference_type;
+                using rhs_difference_type = typename E2::difference_type;
+                parallel_for(size_type(0), size, size_type(1), [&e1, &e2](size_type first, size_type last) {
+                    auto src = e2.storage_cbegin() + static_cast<rhs_difference_type>(first);
+                    std::transform(src, src + static_cast<rhs_difference_type>(last - first),
+                                   e1.storage_begin() + static_cast<lhs_difference_type>(first),
+                                   [](typename E2::value_type x) { return static_cast<typename E1::value_type>(x); });
+                });
+            }
+            else
+            {
+                std::transform(e2.storage_cbegin(), e2.storage_cend(), e1.storage_begin(), [](typename E2::value_type x) { return static_cast<typename E1::value_type>(x); });
+            }
         }
 
         template <class E1, class E2>
@@ -457,6 +1158,80 @@ namespace xt
         // empty in this case.
         assigner_detail::trivial_assigner_run_impl(e1, e2, is_convertible());
     }
+
+    /*********************************
+     * fixed_assigner implementation *
+     *********************************/
+
+    namespace assigner_detail
+    {
+        template <class E1, class E2>
+        inline void fixed_assign_elements(E1&, const E2&, std::size_t, std::index_sequence<>)
+        {
+        }
+
+        template <class E1, class E2, std::size_t... I>
+        inline void fixed_assign_elements(E1& e1, const E2& e2, std::size_t offset, std::index_sequence<I...>)
+        {
+            using value_type = typename E1::value_type;
+            auto dummy = {(e1.data_element(offset + I) = static_cast<value_type>(e2.data_element(offset + I)))...};
+            (void) dummy;
+        }
+
+        template <class LM, class RM, class S, class E1, class E2>
+        inline void fixed_assign_batches(E1&, const E2&, std::index_sequence<>)
+        {
+        }
+
+        template <class LM, class RM, class S, class E1, class E2, std::size_t... I>
+        inline void fixed_assign_batches(E1& e1, const E2& e2, std::index_sequence<I...>)
+        {
+            constexpr std::size_t simd_size = S::size;
+            auto dummy = {(e1.template store_simd<LM, S>(I * simd_size, e2.template load_simd<RM, S>(I * simd_size)), 0)...};
+            (void) dummy;
+        }
+
+        template <class E1, class E2>
+        inline void fixed_assigner_run_impl(E1& e1, const E2& e2, std::true_type)
+        {
+            constexpr std::size_t size = fixed_size<E1>::value;
+            fixed_assign_elements(e1, e2, std::size_t(0), std::make_index_sequence<size>());
+        }
+
+        template <class E1, class E2>
+        inline void fixed_assigner_run_impl(E1&, const E2&, std::false_type)
+        {
+            XTENSOR_PRECONDITION(false,
+                "Internal error: fixed_assigner called with unrelated types.");
+        }
+    }
+
+    template <bool simd_assign>
+    template <class E1, class E2>
+    inline void fixed_assigner<simd_assign>::run(E1& e1, const E2& e2)
+    {
+        // The storage of an adaptor may not be aligned, its batches are
+        // then loaded and stored unaligned instead of peeling a prologue.
+        using lhs_align_mode = xsimd::container_alignment_t<E1>;
+        constexpr bool is_aligned = std::is_same<lhs_align_mode, aligned_mode>::value;
+        using rhs_align_mode = std::conditional_t<is_aligned, inner_aligned_mode, unaligned_mode>;
+        using simd_type = xsimd::simd_type<typename E1::value_type>;
+        constexpr std::size_t size = fixed_size<E1>::value;
+        constexpr std::size_t simd_end = size - size % simd_type::size;
+
+        assigner_detail::fixed_assign_batches<lhs_align_mode, rhs_align_mode, simd_type>(
+            e1, e2, std::make_index_sequence<simd_end / simd_type::size>());
+        assigner_detail::fixed_assign_elements(e1, e2, simd_end, std::make_index_sequence<size - simd_end>());
+    }
+
+    template <>
+    template <class E1, class E2>
+    inline void fixed_assigner<false>::run(E1& e1, const E2& e2)
+    {
+        using is_convertible = std::is_convertible<typename std::decay_t<E2>::value_type,
+                                                   typename std::decay_t<E1>::value_type>;
+        assigner_detail::fixed_assigner_run_impl(e1, e2, is_convertible());
+    }
 }
 
 #endif
@@ -26,10 +26,13 @@
 #include <xtl/xclosure.hpp>
 #include <xtl/xsequence.hpp>
 
+#include "xassign.hpp"
 #include "xbroadcast.hpp"
 #include "xfunction.hpp"
 #include "xgenerator.hpp"
 #include "xoperation.hpp"
+#include "xparallel.hpp"
+#include "xstrided_view.hpp"
 
 namespace xt
 {
@@ -99,6 +102,10 @@ namespace xt
      * - ``std::array`` or ``initializer_list`` → ``xtensor<T, N>``
      * - ``xshape<N...>`` → ``xtensor_fixed<T, xshape<N...>>``
      *
+     * The elements of trivially constructible types are not written, so the
+     * memory pages are first touched by the assignment that follows, which
+     * is split among the workers when a parallel backend is enabled.
+     *
      * @param shape shape of the new xcontainer
      */
     template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class S>
@@ -390,6 +397,24 @@ namespace xt
 
     namespace detail
     {
+        /**
+         * Assigns \c e to the block of the container \c c that has the shape
+         * of \c e, starts at \c offset and steps with \c strides. The block
+         * is a strided view on the data of \c c, its assignment copies whole
+         * rows instead of locating each element among the builder inputs.
+         */
+        template <class C, class E>
+        inline void assign_block(C& c, const E& e, dynamic_shape<std::size_t>&& strides, std::size_t offset)
+        {
+            if (e.size() == 0)
+            {
+                return;
+            }
+            dynamic_shape<std::size_t> shape(e.shape().cbegin(), e.shape().cend());
+            auto block = strided_view(c, std::move(shape), std::move(strides), offset);
+            xt::assign_data(block, e, false);
+        }
+
         template <class... CT>
         class concatenate_impl
         {
@@ -417,6 +442,17 @@ namespace xt
                 return access_impl(xindex(first, last));
             }
 
+            template <class E>
+            inline void assign_to(E& e) const
+            {
+                auto assign_input = [this, &e](size_type offset, const auto& arr) {
+                    dynamic_shape<std::size_t> strides(e.strides().cbegin(), e.strides().cend());
+                    assign_block(e, arr, std::move(strides), offset * e.strides()[this->m_axis]);
+                    return offset + arr.shape()[this->m_axis];
+                };
+                accumulate(assign_input, size_type(0), m_t);
+            }
+
         private:
 
             inline value_type access_impl(xindex idx) const
@@ -476,6 +512,19 @@ namespace xt
                 return access_impl(xindex(first, last));
             }
 
+            template <class E>
+            inline void assign_to(E& e) const
+            {
+                dynamic_shape<std::size_t> strides(e.strides().cbegin(), e.strides().cend());
+                size_type axis_stride = strides[m_axis];
+                strides.erase(strides.begin() + std::ptrdiff_t(m_axis));
+                auto assign_input = [&e, &strides, axis_stride](size_type i, const auto& arr) {
+                    assign_block(e, arr, dynamic_shape<std::size_t>(strides), i * axis_stride);
+                    return i + 1;
+                };
+                accumulate(assign_input, size_type(0), m_t);
+            }
+
         private:
 
             inline value_type access_impl(xindex idx) const
@@ -520,6 +569,87 @@ namespace xt
                 return m_source(*(first + static_cast<std::ptrdiff_t>(m_axis)));
             }
 
+            /**
+             * Evaluates the source once, then fills the rows along the
+             * innermost axis of the container \c e: a row along the repeat
+             * axis is a copy of the source, any other row repeats a single
+             * value. The rows are split among the workers for large outputs.
+             */
+            template <class E>
+            inline void assign_to(E& e) const
+            {
+                using e_value_type = typename E::value_type;
+                const auto& shape = e.shape();
+                const auto& strides = e.strides();
+                size_type dim = shape.size();
+                size_type size = e.size();
+                if (size == 0)
+                {
+                    return;
+                }
+
+                std::vector<e_value_type> values(m_source.cbegin(), m_source.cend());
+                bool row_major = e.layout() != layout_type::column_major;
+                size_type inner = row_major ? dim - 1 : 0;
+                size_type row_size = shape[inner];
+                std::ptrdiff_t row_stride = static_cast<std::ptrdiff_t>(strides[inner]);
+                e_value_type* data = e.data();
+
+                auto assign_rows = [&](size_type first, size_type last) {
+                    for (size_type row = first; row < last; ++row)
+                    {
+                        size_type index = row;
+                        size_type offset = 0;
+                        size_type source_index = 0;
+                        for (size_type k = 0; k < dim; ++k)
+                        {
+                            size_type axis = row_major ? dim - k - 1 : k;
+                            if (axis == inner)
+                            {
+                                continue;
+                            }
+                            size_type i = index % shape[axis];
+                            index /= shape[axis];
+                            offset += i * strides[axis];
+                            source_index = axis == m_axis ? i : source_index;
+                        }
+                        e_value_type* dst = data + offset;
+                        if (inner == m_axis && row_stride == 1)
+                        {
+                            std::copy(values.cbegin(), values.cend(), dst);
+                        }
+                        else if (inner == m_axis)
+                        {
+                            for (size_type j = 0; j < row_size; ++j)
+                            {
+                                dst[static_cast<std::ptrdiff_t>(j) * row_stride] = values[j];
+                            }
+                        }
+                        else if (row_stride == 1)
+                        {
+                            std::fill(dst, dst + row_size, values[source_index]);
+                        }
+                        else
+                        {
+                            for (size_type j = 0; j < row_size; ++j)
+                            {
+                                dst[static_cast<std::ptrdiff_t>(j) * row_stride] = values[source_index];
+                            }
+                        }
+                    }
+                };
+
+                size_type n_rows = size / row_size;
+                if (parallel_enabled(size))
+                {
+                    parallel_for(size_type(0), n_rows, size_type(1), assign_rows);
+                }
+                else
+                {
+                    assign_rows(size_type(0), n_rows);
+                }
+            }
+
         private:
 
             CT m_source;
@@ -544,6 +674,9 @@ namespace xt
      * @param axis axis along which elements are concatenated
      * @returns xgenerator evaluating to concatenated elements
      *
+     * The returned generator is lazy. When it is assigned to a container,
+     * each expression is assigned as a whole to its block of the container.
+     *
      * \code{.cpp}
      * xt::xarray<double> a = {{1, 2, 3}};
      * xt::xarray<double> b = {{2, 3, 4}};
@@ -593,6 +726,9 @@ namespace xt
      * @param axis axis along which elements are stacked
      * @returns xgenerator evaluating to stacked elements
      *
+     * The returned generator is lazy. When it is assigned to a container,
+     * each expression is assigned as a whole to its slice of the container.
+     *
      * \code{.cpp}
      * xt::xarray<double> a = {1, 2, 3};
      * xt::xarray<double> b = {5, 6, 7};
@@ -9,13 +9,29 @@
 #ifndef XTENSOR_CSV_HPP
 #define XTENSOR_CSV_HPP
 
+#include <clocale>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <exception>
 #include <istream>
 #include <iterator>
+#include <limits>
+#include <numeric>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
+#if defined(__APPLE__)
+#include <xlocale.h>
+#elif !defined(_MSC_VER)
+#include <locale.h>
+#endif
+
+#include "xparallel.hpp"
 #include "xtensor.hpp"
 
 namespace xt
@@ -29,7 +45,8 @@ namespace xt
     using xcsv_tensor = xtensor_container<std::vector<T, A>, 2, layout_type::row_major>;
 
     template <class T, class A = std::allocator<T>>
-    xcsv_tensor<T, A> load_csv(std::istream& stream);
+    xcsv_tensor<T, A> load_csv(std::istream& stream, char delimiter = ',', std::size_t skip_rows = 0,
+                               const std::vector<std::size_t>& usecols = {});
 
     template <class E>
     void dump_csv(std::ostream& stream, const xexpression<E>& e);
@@ -76,55 +93,431 @@ namespace xt
         template <>
         inline unsigned long long lexical_cast<unsigned long long>(const std::string& cell) { return std::stoull(cell); }
 
-        template <class ST, class T, class OI>
-        ST load_csv_row(std::istream& row_stream, OI output, std::string cell)
+        inline bool is_csv_space(char c) noexcept
+        {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        inline bool is_csv_digit(char c) noexcept
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        [[noreturn]] inline void throw_csv_cell_error(const char* first, const char* last)
+        {
+            throw std::runtime_error("Invalid CSV cell: '" + std::string(first, last) + "'");
+        }
+
+        // strtof, strtod and strtold in the C locale, whatever the global
+        // locale is
+#if defined(_MSC_VER)
+        inline _locale_t csv_c_locale()
         {
-            ST length = 0;
-            while (std::getline(row_stream, cell, ','))
+            static _locale_t c_locale = _create_locale(LC_NUMERIC, "C");
+            return c_locale;
+        }
+
+        inline float csv_strto(const char* str, char** end, float)
+        {
+            return _strtof_l(str, end, csv_c_locale());
+        }
+
+        inline double csv_strto(const char* str, char** end, double)
+        {
+            return _strtod_l(str, end, csv_c_locale());
+        }
+
+        inline long double csv_strto(const char* str, char** end, long double)
+        {
+            return _strtold_l(str, end, csv_c_locale());
+        }
+#else
+        inline locale_t csv_c_locale()
+        {
+            static locale_t c_locale = newlocale(LC_NUMERIC_MASK, "C", static_cast<locale_t>(0));
+            return c_locale;
+        }
+
+        inline float csv_strto(const char* str, char** end, float)
+        {
+            return strtof_l(str, end, csv_c_locale());
+        }
+
+        inline double csv_strto(const char* str, char** end, double)
+        {
+            return strtod_l(str, end, csv_c_locale());
+        }
+
+        inline long double csv_strto(const char* str, char** end, long double)
+        {
+            return strtold_l(str, end, csv_c_locale());
+        }
+#endif
+
+        template <class T>
+        inline T parse_csv_strtod(const char* first, const char* last)
+        {
+            std::string cell(first, last);
+            char* end = nullptr;
+            T res = csv_strto(cell.c_str(), &end, T());
+            if (cell.empty() || end != cell.c_str() + cell.size())
             {
-                *output++ = lexical_cast<T>(cell);
-                ++length;
+                throw_csv_cell_error(first, last);
+            }
+            return res;
+        }
+
+        // Parses a decimal double without going through the locale. Numbers
+        // with at most 19 significant digits, a mantissa exactly
+        // representable as a double and a decimal exponent in [-22, 22] are
+        // converted exactly; others fall back to strtod in the C locale.
+        inline double parse_csv_double(const char* first, const char* last)
+        {
+            static const double pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                           1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+            const char* p = first;
+            bool negative = false;
+            if (p != last && (*p == '-' || *p == '+'))
+            {
+                negative = *p == '-';
+                ++p;
+            }
+            std::uint64_t mantissa = 0;
+            int n_digits = 0;
+            int exponent = 0;
+            bool any_digit = false;
+            bool truncated = false;
+            // Returns false if the digit does not fit in the mantissa
+            auto add_digit = [&mantissa, &n_digits, &truncated](char c) {
+                if (n_digits < 19)
+                {
+                    mantissa = mantissa * 10 + std::uint64_t(c - '0');
+                    n_digits += mantissa != 0 ? 1 : 0;
+                    return true;
+                }
+                truncated = truncated || c != '0';
+                return false;
+            };
+            for (; p != last && is_csv_digit(*p); ++p)
+            {
+                any_digit = true;
+                if (!add_digit(*p))
+                {
+                    ++exponent;
+                }
+            }
+            if (p != last && *p == '.')
+            {
+                for (++p; p != last && is_csv_digit(*p); ++p)
+                {
+                    any_digit = true;
+                    if (add_digit(*p))
+                    {
+                        --exponent;
+                    }
+                }
+            }
+            if (p != last && any_digit && (*p == 'e' || *p == 'E'))
+            {
+                ++p;
+                bool negative_exponent = false;
+                if (p != last && (*p == '-' || *p == '+'))
+                {
+                    negative_exponent = *p == '-';
+                    ++p;
+                }
+                if (p == last || !is_csv_digit(*p))
+                {
+                    throw_csv_cell_error(first, last);
+                }
+                int e = 0;
+                for (; p != last && is_csv_digit(*p); ++p)
+                {
+                    e = (std::min)(e * 10 + (*p - '0'), 100000);
+                }
+                exponent += negative_exponent ? -e : e;
+            }
+            if (!any_digit || p != last)
+            {
+                // inf, nan, hexadecimal floats or invalid cells
+                return parse_csv_strtod<double>(first, last);
+            }
+            if (!truncated && mantissa <= (std::uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+            {
+                double res = static_cast<double>(mantissa);
+                res = exponent < 0 ? res / pow10[-exponent] : res * pow10[exponent];
+                return negative ? -res : res;
+            }
+            return parse_csv_strtod<double>(first, last);
+        }
+
+        template <class T>
+        inline T parse_csv_integer(const char* first, const char* last)
+        {
+            const char* p = first;
+            bool negative = false;
+            if (p != last && (*p == '-' || *p == '+'))
+            {
+                negative = *p == '-';
+                ++p;
+            }
+            if (p == last)
+            {
+                throw_csv_cell_error(first, last);
+            }
+            // Magnitude of the bound in the direction of the sign
+            using unsigned_type = std::make_unsigned_t<T>;
+            unsigned_type max_value = negative ?
+                static_cast<unsigned_type>(unsigned_type(0) - static_cast<unsigned_type>(std::numeric_limits<T>::min())) :
+                static_cast<unsigned_type>(std::numeric_limits<T>::max());
+            unsigned_type value = 0;
+            for (; p != last; ++p)
+            {
+                if (!is_csv_digit(*p))
+                {
+                    throw_csv_cell_error(first, last);
+                }
+                unsigned_type digit = static_cast<unsigned_type>(*p - '0');
+                if (value > (max_value - digit) / 10)
+                {
+                    throw std::out_of_range("CSV cell out of range: '" + std::string(first, last) + "'");
+                }
+                value = static_cast<unsigned_type>(value * 10 + digit);
+            }
+            return static_cast<T>(negative ? static_cast<unsigned_type>(unsigned_type(0) - value) : value);
+        }
+
+        template <class T, class = void>
+        struct csv_cell_parser
+        {
+            static T parse(const char* first, const char* last)
+            {
+                return lexical_cast<T>(std::string(first, last));
+            }
+        };
+
+        template <class T>
+        struct csv_cell_parser<T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>>
+        {
+            static T parse(const char* first, const char* last)
+            {
+                return parse_csv_integer<T>(first, last);
+            }
+        };
+
+        // float and long double go through strtof and strtold, which round
+        // correctly to their precision, unlike the double fast path.
+        template <class T>
+        struct csv_cell_parser<T, std::enable_if_t<std::is_floating_point<T>::value>>
+        {
+            static T parse(const char* first, const char* last)
+            {
+                return parse_csv_strtod<T>(first, last);
+            }
+        };
+
+        template <>
+        struct csv_cell_parser<double>
+        {
+            static double parse(const char* first, const char* last)
+            {
+                return parse_csv_double(first, last);
+            }
+        };
+
+        template <class T>
+        inline T parse_csv_cell(const char* first, const char* last)
+        {
+            while (first != last && is_csv_space(*first))
+            {
+                ++first;
+            }
+            while (last != first && is_csv_space(*(last - 1)))
+            {
+                --last;
+            }
+            return csv_cell_parser<T>::parse(first, last);
+        }
+
+        inline std::string read_csv_stream(std::istream& stream)
+        {
+            std::string buffer;
+            std::streampos start = stream.tellg();
+            if (start != std::streampos(-1))
+            {
+                stream.seekg(0, std::ios::end);
+                std::streampos end = stream.tellg();
+                stream.seekg(start);
+                if (end != std::streampos(-1) && end > start)
+                {
+                    buffer.reserve(static_cast<std::size_t>(end - start));
+                }
+            }
+            std::vector<char> chunk(std::size_t(1) << 16);
+            while (stream.read(chunk.data(), std::streamsize(chunk.size())) || stream.gcount() > 0)
+            {
+                buffer.append(chunk.data(), static_cast<std::size_t>(stream.gcount()));
+            }
+            return buffer;
+        }
+
+        inline const char* next_csv_line(const char* first, const char* last) noexcept
+        {
+            const void* eol = std::memchr(first, '\n', static_cast<std::size_t>(last - first));
+            return eol == nullptr ? last : static_cast<const char*>(eol) + 1;
+        }
+
+        // Calls f(line_first, line_last) on each non-empty line of
+        // [first, last), line_last excluding the end of line characters.
+        template <class F>
+        inline void for_each_csv_line(const char* first, const char* last, F&& f)
+        {
+            while (first != last)
+            {
+                const char* next = next_csv_line(first, last);
+                const char* line_last = next;
+                while (line_last != first && (*(line_last - 1) == '\n' || *(line_last - 1) == '\r'))
+                {
+                    --line_last;
+                }
+                if (line_last != first)
+                {
+                    f(first, line_last);
+                }
+                first = next;
+            }
+        }
+
+        template <class T>
+        inline void parse_csv_line(const char* first, const char* last, char delimiter,
+                                   const std::vector<std::ptrdiff_t>& column_map, T* output)
+        {
+            std::size_t col = 0;
+            for (;;)
+            {
+                const void* d = std::memchr(first, delimiter, static_cast<std::size_t>(last - first));
+                const char* cell_last = d == nullptr ? last : static_cast<const char*>(d);
+                if (col < column_map.size() && column_map[col] >= 0)
+                {
+                    output[column_map[col]] = parse_csv_cell<T>(first, cell_last);
+                }
+                ++col;
+                if (cell_last == last)
+                {
+                    break;
+                }
+                first = cell_last + 1;
+            }
+            if (col != column_map.size())
+            {
+                throw std::runtime_error("Inconsistent row lengths in CSV");
             }
-            return length;
         }
     }
 
     /**
      * @brief Load tensor from CSV.
-     * 
-     * Returns an \ref xexpression for the parsed CSV
+     *
+     * Returns an \ref xexpression for the parsed CSV. The stream is read
+     * at once, then the rows are located and parsed concurrently when a
+     * parallel backend is enabled. Cells are parsed independently of the
+     * locale. Empty lines are ignored, except the first one after the
+     * skipped rows, which gives the number of columns.
      * @param stream the input stream containing the CSV encoded values
+     * @param delimiter the character separating the cells of a row
+     * @param skip_rows the number of lines to skip at the beginning of
+     *                  the stream, e.g. a header
+     * @param usecols the indices of the columns to load, in the order
+     *                of the result; all the columns if empty
      */
     template <class T, class A>
-    xcsv_tensor<T, A> load_csv(std::istream& stream)
+    xcsv_tensor<T, A> load_csv(std::istream& stream, char delimiter, std::size_t skip_rows,
+                               const std::vector<std::size_t>& usecols)
     {
         using tensor_type = xcsv_tensor<T, A>;
         using storage_type = typename tensor_type::storage_type;
         using size_type = typename tensor_type::size_type;
         using inner_shape_type = typename tensor_type::inner_shape_type;
         using inner_strides_type = typename tensor_type::inner_strides_type;
-        using output_iterator = std::back_insert_iterator<storage_type>;
 
-        storage_type data;
-        size_type nbrow = 0, nbcol = 0;
+        std::string buffer = detail::read_csv_stream(stream);
+        const char* first = buffer.data();
+        const char* last = first + buffer.size();
+        for (std::size_t i = 0; i < skip_rows && first != last; ++i)
+        {
+            first = detail::next_csv_line(first, last);
+        }
+
+        // The number of columns is given by the first row
+        size_type nbcol_file = 0;
+        detail::for_each_csv_line(first, detail::next_csv_line(first, last), [&nbcol_file, delimiter](const char* line_first, const char* line_last) {
+            nbcol_file = size_type(std::count(line_first, line_last, delimiter)) + 1;
+        });
+        if (nbcol_file == 0 && first != last)
+        {
+            throw std::runtime_error("Empty first row in CSV, the number of columns cannot be deduced");
+        }
+        std::vector<std::ptrdiff_t> column_map(nbcol_file, std::ptrdiff_t(-1));
+        if (usecols.empty())
+        {
+            std::iota(column_map.begin(), column_map.end(), std::ptrdiff_t(0));
+        }
+        else
         {
-            output_iterator output(data);
-            std::string row, cell;
-            while (std::getline(stream, row))
+            for (std::size_t i = 0; i < usecols.size(); ++i)
             {
-                std::stringstream row_stream(row);
-                nbcol = detail::load_csv_row<size_type, T, output_iterator>(row_stream, output, cell);
-                ++nbrow;
+                if (usecols[i] >= nbcol_file)
+                {
+                    throw std::runtime_error("Column " + std::to_string(usecols[i]) + " out of bounds in CSV");
+                }
+                if (column_map[usecols[i]] >= 0)
+                {
+                    throw std::runtime_error("Column " + std::to_string(usecols[i]) + " used twice in CSV");
+                }
+                column_map[usecols[i]] = std::ptrdiff_t(i);
             }
         }
-        inner_shape_type shape = {nbrow, nbcol};
-        inner_strides_type strides;  // no need for initializer list for stack-allocated strides_type
-        size_type data_size = compute_strides(shape, layout_type::row_major, strides);
-        // Sanity check for data size.
-        if (data.size() != data_size)
+        size_type nbcol = usecols.empty() ? nbcol_file : usecols.size();
+
+        // Splits the input in chunks of whole lines, counts the rows of
+        // each chunk, then parses the chunks into their part of the storage
+        std::size_t size = static_cast<std::size_t>(last - first);
+        std::size_t n_chunks = parallel_enabled(size) ? parallel_concurrency() : std::size_t(1);
+        std::vector<const char*> bounds(n_chunks + 1, last);
+        bounds[0] = first;
+        for (std::size_t c = 1; c < n_chunks; ++c)
         {
-            throw std::runtime_error("Inconsistent row lengths in CSV");
+            const char* nominal = (std::max)(first + size * c / n_chunks, bounds[c - 1]);
+            bounds[c] = nominal == first ? first : detail::next_csv_line(nominal - 1, last);
         }
+        std::vector<size_type> row_offsets(n_chunks + 1, 0);
+        parallel_for(std::size_t(0), n_chunks, std::size_t(1), [&bounds, &row_offsets](std::size_t c_first, std::size_t c_last) {
+            for (std::size_t c = c_first; c < c_last; ++c)
+            {
+                size_type n_rows = 0;
+                detail::for_each_csv_line(bounds[c], bounds[c + 1], [&n_rows](const char*, const char*) { ++n_rows; });
+                row_offsets[c + 1] = n_rows;
+            }
+        });
+        std::partial_sum(row_offsets.begin(), row_offsets.end(), row_offsets.begin());
+        size_type nbrow = row_offsets.back();
+
+        storage_type data(nbrow * nbcol);
+        T* output = data.data();
+        parallel_for(std::size_t(0), n_chunks, std::size_t(1), [&](std::size_t c_first, std::size_t c_last) {
+            for (std::size_t c = c_first; c < c_last; ++c)
+            {
+                T* row_output = output + row_offsets[c] * nbcol;
+                detail::for_each_csv_line(bounds[c], bounds[c + 1], [&](const char* line_first, const char* line_last) {
+                    detail::parse_csv_line(line_first, line_last, delimiter, column_map, row_output);
+                    row_output += nbcol;
+                });
+            }
+        });
+
+        inner_shape_type shape = {nbrow, nbcol};
+        inner_strides_type strides;  // no need for initializer list for stack-allocated strides_type
+        compute_strides(shape, layout_type::row_major, strides);
         return tensor_type(std::move(data), std::move(shape), std::move(strides));
     }
 
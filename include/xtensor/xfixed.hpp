@@ -270,6 +270,18 @@ namespace xt
     template <class V, class S>
     using get_init_type_t = typename get_init_type<V, S>::type;
 
+    template <class ET, class S, layout_type L, class Tag>
+    struct fixed_size<xfixed_container<ET, S, L, Tag>>
+        : std::integral_constant<std::size_t, detail::fixed_compute_size<S>::value>
+    {
+    };
+
+    template <class EC, class S, layout_type L, class Tag>
+    struct fixed_size<xfixed_adaptor<EC, S, L, Tag>>
+        : std::integral_constant<std::size_t, detail::fixed_compute_size<S>::value>
+    {
+    };
+
     template <class ET, class S, layout_type L, class Tag>
     struct xcontainer_inner_types<xfixed_container<ET, S, L, Tag>>
     {
@@ -291,6 +291,7 @@ namespace xt
         detail::simd_return_type_t<functor_type, simd_argument_type, simd> load_simd(size_type i) const;
 
         const tuple_type& arguments() const noexcept;
+        const functor_type& functor() const noexcept;
 
     protected:
 
@@ -804,6 +805,12 @@ namespace xt
         return m_e;
     }
 
+    template <class F, class R, class... CT>
+    inline auto xfunction_base<F, R, CT...>::functor() const noexcept -> const functor_type&
+    {
+        return m_f;
+    }
+
     template <class F, class R, class... CT>
     template <std::size_t... I>
     inline layout_type xfunction_base<F, R, CT...>::layout_impl(std::index_sequence<I...>) const noexcept
@@ -0,0 +1,523 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_FUSE_HPP
+#define XTENSOR_FUSE_HPP
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <xtl/xtype_traits.hpp>
+
+#include "xassign.hpp"
+#include "xfunction.hpp"
+#include "xscalar.hpp"
+
+namespace xt
+{
+
+    /********************
+     * fuse declaration *
+     ********************/
+
+    template <class F, class R, class... CT>
+    auto fuse(const xfunction<F, R, CT...>& e);
+
+    /***********************
+     * fuse implementation *
+     ***********************/
+
+    namespace detail
+    {
+        constexpr std::size_t fuse_sum(std::initializer_list<std::size_t> l, std::size_t n)
+        {
+            std::size_t res = 0;
+            std::size_t i = 0;
+            for (auto it = l.begin(); it != l.end() && i != n; ++it, ++i)
+            {
+                res += *it;
+            }
+            return res;
+        }
+
+        constexpr std::size_t fuse_sum(std::initializer_list<std::size_t> l)
+        {
+            return fuse_sum(l, l.size());
+        }
+
+        template <class... T>
+        struct fuse_concat;
+
+        template <>
+        struct fuse_concat<>
+        {
+            using type = std::tuple<>;
+        };
+
+        template <class T>
+        struct fuse_concat<T>
+        {
+            using type = T;
+        };
+
+        template <class... T1, class... T2, class... T>
+        struct fuse_concat<std::tuple<T1...>, std::tuple<T2...>, T...>
+            : fuse_concat<std::tuple<T1..., T2...>, T...>
+        {
+        };
+
+        template <class E>
+        struct is_fuse_node : std::false_type
+        {
+        };
+
+        template <class F, class R, class... CT>
+        struct is_fuse_node<xfunction<F, R, CT...>> : std::true_type
+        {
+        };
+
+        /***************
+         * fuse_traits *
+         ***************/
+
+        // Describes the tree rooted at the closure type CT: its number of
+        // xfunction nodes, the closure types of its leaves and the functor
+        // types of its nodes, both in pre-order.
+        template <class E>
+        struct fuse_node_traits;
+
+        template <class CT, class = void>
+        struct fuse_traits
+        {
+            static constexpr std::size_t n_nodes = 0;
+            static constexpr std::size_t n_leaves = 1;
+            using leaves = std::tuple<CT>;
+            using functors = std::tuple<>;
+
+            template <class T>
+            using is_homogeneous = std::is_same<xvalue_type_t<std::decay_t<CT>>, T>;
+        };
+
+        template <class CT>
+        struct fuse_traits<CT, std::enable_if_t<is_fuse_node<std::decay_t<CT>>::value>>
+            : fuse_node_traits<std::decay_t<CT>>
+        {
+        };
+
+        template <class F, class R, class... CT>
+        struct fuse_node_traits<xfunction<F, R, CT...>>
+        {
+            static constexpr std::size_t n_nodes = 1 + fuse_sum({fuse_traits<CT>::n_nodes...});
+            static constexpr std::size_t n_leaves = fuse_sum({fuse_traits<CT>::n_leaves...});
+            using leaves = typename fuse_concat<typename fuse_traits<CT>::leaves...>::type;
+            using functors = typename fuse_concat<std::tuple<typename xfunction<F, R, CT...>::functor_type>,
+                                                  typename fuse_traits<CT>::functors...>::type;
+
+            template <class T>
+            using is_homogeneous = xtl::conjunction<std::is_same<R, T>,
+                                                    typename fuse_traits<CT>::template is_homogeneous<T>...>;
+        };
+
+        /*************************
+         * structural comparison *
+         *************************/
+
+        template <class F, class R, class... CT>
+        bool fuse_node_equal(const xfunction<F, R, CT...>& lhs, const xfunction<F, R, CT...>& rhs);
+
+        // Leaves held by reference are identical if they are the same object.
+        // Leaves held by value are conservatively considered different,
+        // except scalars which are compared by value.
+        template <class CT, class D = std::decay_t<CT>>
+        struct fuse_argument_equal
+        {
+            static bool run(const D& lhs, const D& rhs)
+            {
+                return std::is_lvalue_reference<CT>::value && &lhs == &rhs;
+            }
+        };
+
+        template <class CT, class F, class R, class... A>
+        struct fuse_argument_equal<CT, xfunction<F, R, A...>>
+        {
+            static bool run(const xfunction<F, R, A...>& lhs, const xfunction<F, R, A...>& rhs)
+            {
+                return fuse_node_equal(lhs, rhs);
+            }
+        };
+
+        template <class CT, class T>
+        struct fuse_argument_equal<CT, xscalar<T>>
+        {
+            static bool run(const xscalar<T>& lhs, const xscalar<T>& rhs)
+            {
+                return std::is_lvalue_reference<T>::value ? &lhs() == &rhs() : lhs() == rhs();
+            }
+        };
+
+        template <class... CT, class T, std::size_t... I>
+        inline bool fuse_arguments_equal(const T& lhs, const T& rhs, std::index_sequence<I...>)
+        {
+            bool res = true;
+            auto dummy = {(res = res && fuse_argument_equal<CT>::run(std::get<I>(lhs), std::get<I>(rhs)))...};
+            (void) dummy;
+            return res;
+        }
+
+        template <class F, class R, class... CT>
+        inline bool fuse_node_equal(const xfunction<F, R, CT...>& lhs, const xfunction<F, R, CT...>& rhs)
+        {
+            // Functors with a state may compute different things
+            return &lhs == &rhs ||
+                (std::is_empty<typename xfunction<F, R, CT...>::functor_type>::value &&
+                 fuse_arguments_equal<CT...>(lhs.arguments(), rhs.arguments(), std::make_index_sequence<sizeof...(CT)>()));
+        }
+
+        /***********************
+         * collecting the tree *
+         ***********************/
+
+        struct fuse_node_info
+        {
+            const void* p_node;
+            const void* p_type;
+            bool (*p_equal)(const void*, const void*);
+        };
+
+        template <class E>
+        inline const void* fuse_type_id() noexcept
+        {
+            static const char id = 0;
+            return &id;
+        }
+
+        template <class E>
+        inline bool fuse_erased_equal(const void* lhs, const void* rhs)
+        {
+            return fuse_node_equal(*static_cast<const E*>(lhs), *static_cast<const E*>(rhs));
+        }
+
+        template <class T, std::size_t... I>
+        inline auto fuse_flatten(const T& t, std::index_sequence<I...>)
+        {
+            return std::tuple_cat(std::get<I>(t)...);
+        }
+
+        template <class CT, class D, class N>
+        inline std::enable_if_t<!is_fuse_node<D>::value, std::tuple<const D&>>
+        fuse_collect(const D& e, N&, std::size_t&)
+        {
+            return std::tuple<const D&>(e);
+        }
+
+        template <class... CT, class T, class N, std::size_t... I>
+        inline auto fuse_collect_arguments(const T& args, N& nodes, std::size_t& index, std::index_sequence<I...>);
+
+        // Records the nodes in pre-order and returns the leaves
+        template <class CT, class F, class R, class... A, class N>
+        inline auto fuse_collect(const xfunction<F, R, A...>& e, N& nodes, std::size_t& index)
+        {
+            using node_type = xfunction<F, R, A...>;
+            nodes[index++] = fuse_node_info{&e, fuse_type_id<node_type>(), &fuse_erased_equal<node_type>};
+            return fuse_collect_arguments<A...>(e.arguments(), nodes, index, std::make_index_sequence<sizeof...(A)>());
+        }
+
+        template <class... CT, class T, class N, std::size_t... I>
+        inline auto fuse_collect_arguments(const T& args, N& nodes, std::size_t& index, std::index_sequence<I...>)
+        {
+            // Braced initialization guarantees the pre-order
+            std::tuple<decltype(fuse_collect<CT>(std::get<I>(args), nodes, index))...> leaves{
+                fuse_collect<CT>(std::get<I>(args), nodes, index)...};
+            return fuse_flatten(leaves, std::make_index_sequence<sizeof...(I)>());
+        }
+
+        template <class CT, class D>
+        inline std::enable_if_t<!is_fuse_node<D>::value, std::tuple<>> fuse_functors(const D&)
+        {
+            return std::tuple<>();
+        }
+
+        template <class CT, class F, class R, class... A>
+        inline auto fuse_functors(const xfunction<F, R, A...>& e);
+
+        template <class... CT, class T, std::size_t... I>
+        inline auto fuse_arguments_functors(const T& args, std::index_sequence<I...>)
+        {
+            return std::tuple_cat(fuse_functors<CT>(std::get<I>(args))...);
+        }
+
+        template <class CT, class F, class R, class... A>
+        inline auto fuse_functors(const xfunction<F, R, A...>& e)
+        {
+            return std::tuple_cat(std::make_tuple(e.functor()),
+                                  fuse_arguments_functors<A...>(e.arguments(), std::make_index_sequence<sizeof...(A)>()));
+        }
+
+        /******************
+         * fuse_evaluator *
+         ******************/
+
+        template <class E, std::size_t K, std::size_t O>
+        struct fuse_node_evaluator;
+
+        // Evaluates the tree rooted at the closure type CT, whose first node
+        // has index K and first leaf index O, given the values of the
+        // leaves.
+        template <class CT, std::size_t K, std::size_t O, class = void>
+        struct fuse_evaluator
+        {
+            template <class C, class L>
+            static decltype(auto) run(C&, const L& leaves)
+            {
+                return std::get<O>(leaves);
+            }
+        };
+
+        template <class CT, std::size_t K, std::size_t O>
+        struct fuse_evaluator<CT, K, O, std::enable_if_t<is_fuse_node<std::decay_t<CT>>::value>>
+            : fuse_node_evaluator<std::decay_t<CT>, K, O>
+        {
+        };
+
+        template <class F, class R, class... CT, std::size_t K, std::size_t O>
+        struct fuse_node_evaluator<xfunction<F, R, CT...>, K, O>
+        {
+            template <std::size_t I>
+            using child_evaluator = fuse_evaluator<std::tuple_element_t<I, std::tuple<CT...>>,
+                                                   K + 1 + fuse_sum({fuse_traits<CT>::n_nodes...}, I),
+                                                   O + fuse_sum({fuse_traits<CT>::n_leaves...}, I)>;
+
+            template <class C, class L>
+            static typename C::value_type run(C& ctx, const L& leaves)
+            {
+                return run_impl(ctx, leaves, std::make_index_sequence<sizeof...(CT)>());
+            }
+
+            template <class C, class L, std::size_t... I>
+            static typename C::value_type run_impl(C& ctx, const L& leaves, std::index_sequence<I...>)
+            {
+                std::size_t canonical = ctx.canonical(K);
+                if (canonical != K)
+                {
+                    return ctx.memo[canonical];
+                }
+                // Braced initialization evaluates the operands from left to
+                // right, so the first occurrence of a duplicated subtree is
+                // always computed before it is reused.
+                std::array<typename C::value_type, sizeof...(CT)> args = {
+                    {typename C::value_type(child_evaluator<I>::run(ctx, leaves))...}};
+                ctx.memo[K] = ctx.apply(std::get<K>(ctx.functors()), args[I]...);
+                return ctx.memo[K];
+            }
+        };
+
+        template <class V, class FS, std::size_t N, bool simd>
+        struct fuse_context
+        {
+            using value_type = V;
+
+            fuse_context(const FS& functors, const std::array<std::size_t, N>& canon)
+                : m_functors(functors), m_canon(canon)
+            {
+            }
+
+            const FS& functors() const noexcept
+            {
+                return m_functors;
+            }
+
+            std::size_t canonical(std::size_t k) const noexcept
+            {
+                return m_canon[k];
+            }
+
+            template <class F, class... A>
+            V apply(const F& f, const A&... args) const
+            {
+                return apply_impl(std::integral_constant<bool, simd>(), f, args...);
+            }
+
+            std::array<V, N> memo;
+
+        private:
+
+            template <class F, class... A>
+            V apply_impl(std::false_type, const F& f, const A&... args) const
+            {
+                return f(args...);
+            }
+
+            template <class F, class... A>
+            V apply_impl(std::true_type, const F& f, const A&... args) const
+            {
+                return f.simd_apply(args...);
+            }
+
+            const FS& m_functors;
+            const std::array<std::size_t, N>& m_canon;
+        };
+
+        /****************
+         * fuse_functor *
+         ****************/
+
+        template <class E>
+        class fuse_functor_base
+        {
+        public:
+
+            using traits = fuse_node_traits<E>;
+            using functors_type = typename traits::functors;
+            using canon_type = std::array<std::size_t, traits::n_nodes>;
+            using value_type = typename E::value_type;
+            using result_type = value_type;
+
+            fuse_functor_base(functors_type functors, const canon_type& canon)
+                : m_functors(std::move(functors)), m_canon(canon)
+            {
+            }
+
+            template <class... A>
+            result_type operator()(const A&... args) const
+            {
+                fuse_context<value_type, functors_type, traits::n_nodes, false> ctx(m_functors, m_canon);
+                return fuse_evaluator<E, 0, 0>::run(ctx, std::forward_as_tuple(args...));
+            }
+
+        protected:
+
+            template <class B, class... A>
+            B simd_apply_impl(const B& arg, const A&... args) const
+            {
+                fuse_context<B, functors_type, traits::n_nodes, true> ctx(m_functors, m_canon);
+                return fuse_evaluator<E, 0, 0>::run(ctx, std::forward_as_tuple(arg, args...));
+            }
+
+        private:
+
+            functors_type m_functors;
+            canon_type m_canon;
+        };
+
+        // The fused functor is vectorized if and only if the original
+        // expression is.
+        template <class E, bool simd = !forbid_simd_assign<E>::value>
+        class fuse_functor : public fuse_functor_base<E>
+        {
+        public:
+
+            using fuse_functor_base<E>::fuse_functor_base;
+        };
+
+        template <class E>
+        class fuse_functor<E, true> : public fuse_functor_base<E>
+        {
+        public:
+
+            using fuse_functor_base<E>::fuse_functor_base;
+
+            template <class B, class... A>
+            B simd_apply(const B& arg, const A&... args) const
+            {
+                return this->simd_apply_impl(arg, args...);
+            }
+        };
+
+        template <class E, class L>
+        struct fused_expression;
+
+        template <class E, class... CT>
+        struct fused_expression<E, std::tuple<CT...>>
+        {
+            using type = xfunction<fuse_functor<E>, typename E::value_type, CT...>;
+        };
+
+        template <class E>
+        using fused_expression_t = typename fused_expression<E, typename fuse_node_traits<E>::leaves>::type;
+
+        template <class E, class L, std::size_t... I>
+        inline fused_expression_t<E> make_fused_expression(fuse_functor<E>&& f, const L& leaves, std::index_sequence<I...>)
+        {
+            return fused_expression_t<E>(std::move(f), std::get<I>(leaves)...);
+        }
+
+        template <class E>
+        inline fused_expression_t<E> fuse_impl(const E& e, std::true_type)
+        {
+            using traits = fuse_node_traits<E>;
+            constexpr std::size_t n_nodes = traits::n_nodes;
+            std::array<fuse_node_info, n_nodes> nodes;
+            std::size_t index = 0;
+            auto leaves = fuse_collect<const E&>(e, nodes, index);
+
+            // Maps each node to the first node of the tree equal to it
+            std::array<std::size_t, n_nodes> canon;
+            for (std::size_t k = 0; k < n_nodes; ++k)
+            {
+                canon[k] = k;
+                for (std::size_t j = 0; j < k; ++j)
+                {
+                    if (canon[j] == j && nodes[j].p_type == nodes[k].p_type && nodes[j].p_equal(nodes[j].p_node, nodes[k].p_node))
+                    {
+                        canon[k] = j;
+                        break;
+                    }
+                }
+            }
+            return make_fused_expression<E>(fuse_functor<E>(fuse_functors<const E&>(e), canon), leaves,
+                                             std::make_index_sequence<traits::n_leaves>());
+        }
+
+        template <class E>
+        inline E fuse_impl(const E& e, std::false_type)
+        {
+            return e;
+        }
+
+        template <class E>
+        using is_fusable = xtl::conjunction<
+            std::integral_constant<bool, (fuse_node_traits<E>::n_nodes > 1)>,
+            xtl::negation<std::is_same<typename E::value_type, bool>>,
+            typename fuse_node_traits<E>::template is_homogeneous<typename E::value_type>>;
+    }
+
+    /**
+     * @brief Eliminates the common subexpressions of a function expression.
+     *
+     * Returns an expression equivalent to @p e where the identical
+     * subexpressions are evaluated once per element (or per batch of
+     * elements when the assignment is vectorized) and their value is fed to
+     * all their consumers. For instance, in
+     *
+     * \code{.cpp}
+     * xt::xarray<double> res = xt::fuse(xt::exp(a) * xt::sin(b) + xt::exp(a) / c);
+     * \endcode
+     *
+     * the exponential is computed once per element instead of twice. Two
+     * subexpressions are identical if they apply the same stateless
+     * function to identical arguments, that is the same expressions held
+     * by reference or the same scalar values.
+     *
+     * The returned expression is a single function of the leaves of
+     * @p e, which it holds like @p e does. Expressions mixing several
+     * value types, or with a boolean value type, are returned unchanged.
+     * @param e the expression to fuse
+     */
+    template <class F, class R, class... CT>
+    inline auto fuse(const xfunction<F, R, CT...>& e)
+    {
+        using expression_type = xfunction<F, R, CT...>;
+        return detail::fuse_impl(e, detail::is_fusable<expression_type>());
+    }
+}
+
+#endif
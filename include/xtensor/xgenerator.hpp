@@ -112,6 +112,9 @@ namespace xt
         template <class O>
         const_stepper stepper_end(const O& shape, layout_type) const noexcept;
 
+        template <class E, class = decltype(std::declval<const functor_type&>().assign_to(std::declval<E&>()))>
+        void assign_to(xexpression<E>& e) const;
+
     private:
 
         template <std::size_t dim>
@@ -304,6 +307,21 @@ namespace xt
         return const_stepper(this, offset, true);
     }
 
+    /**
+     * Assigns the generator to the container \c e when the function knows
+     * how to fill a whole container at once, instead of being called for
+     * each of its elements.
+     * @param e the container to assign
+     */
+    template <class F, class R, class S>
+    template <class E, class>
+    inline void xgenerator<F, R, S>::assign_to(xexpression<E>& e) const
+    {
+        auto& de = e.derived_cast();
+        de.resize(m_shape);
+        m_f.assign_to(de);
+    }
+
     template <class F, class R, class S>
     template <std::size_t dim>
     inline void xgenerator<F, R, S>::adapt_index() const
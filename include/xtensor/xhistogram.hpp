@@ -0,0 +1,434 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+/**
+ * @brief functions to count the values of an xexpression in bins
+ */
+
+#ifndef XTENSOR_HISTOGRAM_HPP
+#define XTENSOR_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "xparallel.hpp"
+#include "xtensor.hpp"
+
+namespace xt
+{
+    namespace detail
+    {
+        // Number of values whose bins are computed before the bins are
+        // incremented, so that the computation of the bins vectorizes.
+        constexpr std::size_t histogram_block_size = 256;
+
+        template <class T>
+        using histogram_real_t = std::common_type_t<T, double>;
+
+        template <class T>
+        using histogram_weight_t = std::conditional_t<std::is_floating_point<T>::value, T, double>;
+
+        /**
+         * Returns e if its elements are stored contiguously in row-major
+         * order, a flattened copy otherwise.
+         */
+        template <class E, std::enable_if_t<has_data_interface<E>::value && E::contiguous_layout &&
+                                            E::static_layout == layout_type::row_major, int> = 0>
+        inline const E& flat_values(const E& e)
+        {
+            return e;
+        }
+
+        template <class E, std::enable_if_t<!(has_data_interface<E>::value && E::contiguous_layout &&
+                                              E::static_layout == layout_type::row_major), int> = 0>
+        inline auto flat_values(const E& e)
+        {
+            auto res = xtensor<typename E::value_type, 1>::from_shape({e.size()});
+            std::copy(e.cbegin(), e.cend(), res.begin());
+            return res;
+        }
+
+        template <class T>
+        inline std::enable_if_t<std::is_signed<T>::value, bool> is_negative(T t) noexcept
+        {
+            return t < T(0);
+        }
+
+        template <class T>
+        inline std::enable_if_t<!std::is_signed<T>::value, bool> is_negative(T) noexcept
+        {
+            return false;
+        }
+
+        /**
+         * Accumulates into res, which must be zero-initialized, the histogram
+         * of n_bins bins of the positions [0, size): fill(first, last, counts)
+         * adds the contributions of the positions [first, last) to counts.
+         * Large inputs are split into chunks binned concurrently into private
+         * histograms, summed at the end. The number of chunks is bounded so
+         * that summing the histograms costs less than binning the values.
+         */
+        template <class T, class F>
+        inline void chunked_histogram(T* res, std::size_t n_bins, std::size_t size, F&& fill)
+        {
+            std::size_t n_chunks = 1;
+            if (parallel_enabled(size))
+            {
+                n_chunks = (std::min)(parallel_concurrency(), size / (n_bins + 1));
+            }
+            if (n_chunks <= 1)
+            {
+                fill(std::size_t(0), size, res);
+                return;
+            }
+
+            std::vector<std::vector<T>> partials(n_chunks - 1);
+            parallel_for(std::size_t(0), n_chunks, std::size_t(1), [&](std::size_t c_first, std::size_t c_last) {
+                for (std::size_t c = c_first; c < c_last; ++c)
+                {
+                    T* counts = res;
+                    if (c != 0)
+                    {
+                        partials[c - 1].assign(n_bins, T(0));
+                        counts = partials[c - 1].data();
+                    }
+                    fill(size * c / n_chunks, size * (c + 1) / n_chunks, counts);
+                }
+            });
+
+            auto merge = [&partials, res](std::size_t first, std::size_t last) {
+                for (const auto& partial : partials)
+                {
+                    for (std::size_t b = first; b < last; ++b)
+                    {
+                        res[b] += partial[b];
+                    }
+                }
+            };
+            if (parallel_enabled(n_bins * (n_chunks - 1)))
+            {
+                parallel_for(std::size_t(0), n_bins, std::size_t(1), merge);
+            }
+            else
+            {
+                merge(std::size_t(0), n_bins);
+            }
+        }
+
+        template <class T>
+        inline xtensor<T, 1> make_histogram(std::size_t n_bins)
+        {
+            typename xtensor<T, 1>::shape_type shape = {n_bins};
+            return xtensor<T, 1>(shape, T(0));
+        }
+
+        template <class R>
+        inline xtensor<R, 1> uniform_bin_edges(std::size_t bins, R left, R right)
+        {
+            auto res = xtensor<R, 1>::from_shape({bins + 1});
+            R step = (right - left) / static_cast<R>(bins);
+            for (std::size_t i = 0; i < bins; ++i)
+            {
+                res(i) = left + static_cast<R>(i) * step;
+            }
+            res(bins) = right;
+            return res;
+        }
+
+        template <class T>
+        inline std::array<histogram_real_t<T>, 2> histogram_range(const T* data, std::size_t size)
+        {
+            using real_type = histogram_real_t<T>;
+            if (size == 0)
+            {
+                return {real_type(0), real_type(1)};
+            }
+            auto minmax = std::minmax_element(data, data + size);
+            real_type left = static_cast<real_type>(*minmax.first);
+            real_type right = static_cast<real_type>(*minmax.second);
+            if (left == right)
+            {
+                left -= real_type(0.5);
+                right += real_type(0.5);
+            }
+            return {left, right};
+        }
+
+        /**
+         * Counts the values of [data, data + size) in the bins of the
+         * uniform edges. The bin of a value is computed from its distance
+         * to the left edge, then corrected by comparing the value to the
+         * edges so that it is consistent with them. Values outside of the
+         * edges and NaN are counted in an extra bin, dropped at the end.
+         */
+        template <class T, class R>
+        inline xtensor<std::size_t, 1> uniform_histogram(const T* data, std::size_t size, const xtensor<R, 1>& edges)
+        {
+            std::size_t bins = edges.size() - 1;
+            R left = edges(0);
+            R right = edges(bins);
+            if (!(left < right))
+            {
+                throw std::runtime_error("histogram: the left edge must be lower than the right edge.");
+            }
+            R norm = static_cast<R>(bins) / (right - left);
+            const R* edge = edges.data();
+
+            std::vector<std::size_t> counts(bins + 1, std::size_t(0));
+            chunked_histogram(counts.data(), bins + 1, size, [=](std::size_t first, std::size_t last, std::size_t* c) {
+                std::array<std::size_t, histogram_block_size> index;
+                for (std::size_t i = first; i < last; i += histogram_block_size)
+                {
+                    std::size_t n = (std::min)(histogram_block_size, last - i);
+                    for (std::size_t j = 0; j < n; ++j)
+                    {
+                        R x = static_cast<R>(data[i + j]);
+                        bool inside = x >= left && x <= right;
+                        R pos = inside ? (x - left) * norm : R(0);
+                        std::size_t b = inside ? (std::min)(static_cast<std::size_t>(pos), bins - 1) : bins;
+                        b -= static_cast<std::size_t>(inside && x < edge[b]);
+                        b += static_cast<std::size_t>(inside && b + 1 < bins && x >= edge[b + 1]);
+                        index[j] = b;
+                    }
+                    for (std::size_t j = 0; j < n; ++j)
+                    {
+                        ++c[index[j]];
+                    }
+                }
+            });
+
+            auto res = xtensor<std::size_t, 1>::from_shape({bins});
+            std::copy(counts.cbegin(), counts.cbegin() + static_cast<std::ptrdiff_t>(bins), res.begin());
+            return res;
+        }
+    }
+
+    /**
+     * Counts the number of occurrences of each value of the xexpression,
+     * which must be made of non-negative integers.
+     *
+     * @param e input xexpression (will be flattened)
+     * @param minlength minimum number of bins of the result
+     *
+     * @return 1-D tensor whose element i is the number of occurrences of i
+     *         in \a e, with max(max(e) + 1, minlength) elements
+     */
+    template <class E>
+    inline xtensor<std::size_t, 1> bincount(const xexpression<E>& e, std::size_t minlength = 0)
+    {
+        using value_type = typename E::value_type;
+        static_assert(std::is_integral<value_type>::value, "bincount requires an integral value type");
+
+        auto&& values = detail::flat_values(e.derived_cast());
+        const value_type* data = values.data() + values.data_offset();
+        std::size_t size = values.size();
+        std::size_t n_bins = minlength;
+        if (size != 0)
+        {
+            auto minmax = std::minmax_element(data, data + size);
+            if (detail::is_negative(*minmax.first))
+            {
+                throw std::runtime_error("bincount: the values must be non-negative.");
+            }
+            n_bins = (std::max)(n_bins, static_cast<std::size_t>(*minmax.second) + 1);
+        }
+
+        auto res = detail::make_histogram<std::size_t>(n_bins);
+        detail::chunked_histogram(res.data(), n_bins, size, [data](std::size_t first, std::size_t last, std::size_t* counts) {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                ++counts[static_cast<std::size_t>(data[i])];
+            }
+        });
+        return res;
+    }
+
+    /**
+     * Sums the weights of the occurrences of each value of the xexpression,
+     * which must be made of non-negative integers.
+     *
+     * @param e input xexpression (will be flattened)
+     * @param weights xexpression of the weights, with the same size as \a e
+     * @param minlength minimum number of bins of the result
+     *
+     * @return 1-D tensor whose element i is the sum of the weights of the
+     *         occurrences of i in \a e
+     */
+    template <class E1, class E2>
+    inline auto bincount(const xexpression<E1>& e, const xexpression<E2>& weights, std::size_t minlength = 0)
+    {
+        using value_type = typename E1::value_type;
+        using weight_type = detail::histogram_weight_t<typename E2::value_type>;
+        static_assert(std::is_integral<value_type>::value, "bincount requires an integral value type");
+
+        auto&& values = detail::flat_values(e.derived_cast());
+        auto&& w = detail::flat_values(weights.derived_cast());
+        std::size_t size = values.size();
+        if (w.size() != size)
+        {
+            throw std::runtime_error("bincount: the weights and the values must have the same size.");
+        }
+        const value_type* data = values.data() + values.data_offset();
+        const auto* wdata = w.data() + w.data_offset();
+        std::size_t n_bins = minlength;
+        if (size != 0)
+        {
+            auto minmax = std::minmax_element(data, data + size);
+            if (detail::is_negative(*minmax.first))
+            {
+                throw std::runtime_error("bincount: the values must be non-negative.");
+            }
+            n_bins = (std::max)(n_bins, static_cast<std::size_t>(*minmax.second) + 1);
+        }
+
+        auto res = detail::make_histogram<weight_type>(n_bins);
+        detail::chunked_histogram(res.data(), n_bins, size, [data, wdata](std::size_t first, std::size_t last, weight_type* sums) {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                sums[static_cast<std::size_t>(data[i])] += static_cast<weight_type>(wdata[i]);
+            }
+        });
+        return res;
+    }
+
+    /**
+     * Computes the edges of \a bins bins of equal width between \a left
+     * and \a right.
+     *
+     * @param e input xexpression, only used for the type of the edges
+     * @param bins number of bins
+     * @param left lower edge of the first bin
+     * @param right upper edge of the last bin
+     *
+     * @return 1-D tensor of bins + 1 edges
+     */
+    template <class E, class T>
+    inline auto histogram_bin_edges(const xexpression<E>& /*e*/, std::size_t bins, T left, T right)
+    {
+        using real_type = detail::histogram_real_t<typename E::value_type>;
+        if (bins == 0)
+        {
+            throw std::runtime_error("histogram: the number of bins must be positive.");
+        }
+        return detail::uniform_bin_edges(bins, static_cast<real_type>(left), static_cast<real_type>(right));
+    }
+
+    /**
+     * Computes the edges of \a bins bins of equal width between the
+     * minimum and the maximum of the xexpression.
+     *
+     * @param e input xexpression
+     * @param bins number of bins
+     *
+     * @return 1-D tensor of bins + 1 edges
+     */
+    template <class E>
+    inline auto histogram_bin_edges(const xexpression<E>& e, std::size_t bins = 10)
+    {
+        auto&& values = detail::flat_values(e.derived_cast());
+        auto range = detail::histogram_range(values.data() + values.data_offset(), values.size());
+        return histogram_bin_edges(e, bins, range[0], range[1]);
+    }
+
+    /**
+     * Counts the values of the xexpression in \a bins bins of equal width
+     * between \a left and \a right. The last bin includes \a right, values
+     * outside of the range are ignored. The bins are computed by blocks of
+     * values and large inputs are counted concurrently.
+     *
+     * @param e input xexpression (will be flattened)
+     * @param bins number of bins
+     * @param left lower edge of the first bin
+     * @param right upper edge of the last bin
+     *
+     * @return 1-D tensor of the number of values in each bin
+     * @sa histogram_bin_edges
+     */
+    template <class E, class T>
+    inline xtensor<std::size_t, 1> histogram(const xexpression<E>& e, std::size_t bins, T left, T right)
+    {
+        auto&& values = detail::flat_values(e.derived_cast());
+        auto edges = histogram_bin_edges(e, bins, left, right);
+        return detail::uniform_histogram(values.data() + values.data_offset(), values.size(), edges);
+    }
+
+    /**
+     * Counts the values of the xexpression in \a bins bins of equal width
+     * between its minimum and its maximum.
+     *
+     * @param e input xexpression (will be flattened)
+     * @param bins number of bins
+     *
+     * @return 1-D tensor of the number of values in each bin
+     * @sa histogram_bin_edges
+     */
+    template <class E>
+    inline xtensor<std::size_t, 1> histogram(const xexpression<E>& e, std::size_t bins = 10)
+    {
+        auto&& values = detail::flat_values(e.derived_cast());
+        const auto* data = values.data() + values.data_offset();
+        auto range = detail::histogram_range(data, values.size());
+        auto edges = histogram_bin_edges(e, bins, range[0], range[1]);
+        return detail::uniform_histogram(data, values.size(), edges);
+    }
+
+    /**
+     * Counts the values of the xexpression in the bins delimited by the
+     * increasing sequence \a bin_edges. The last bin includes its upper
+     * edge, values outside of the edges are ignored.
+     *
+     * @param e input xexpression (will be flattened)
+     * @param bin_edges 1-D xexpression of the edges of the bins
+     *
+     * @return 1-D tensor of the number of values in each bin
+     */
+    template <class E1, class E2>
+    inline xtensor<std::size_t, 1> histogram(const xexpression<E1>& e, const xexpression<E2>& bin_edges)
+    {
+        using edge_type = typename E2::value_type;
+        auto&& values = detail::flat_values(e.derived_cast());
+        auto&& edges = detail::flat_values(bin_edges.derived_cast());
+        if (edges.size() < 2)
+        {
+            throw std::runtime_error("histogram: at least two bin edges are required.");
+        }
+        const auto* data = values.data() + values.data_offset();
+        const edge_type* first_edge = edges.data() + edges.data_offset();
+        const edge_type* last_edge = first_edge + edges.size();
+        if (!std::is_sorted(first_edge, last_edge))
+        {
+            throw std::runtime_error("histogram: the bin edges must be increasing.");
+        }
+        std::size_t bins = edges.size() - 1;
+
+        std::vector<std::size_t> counts(bins + 1, std::size_t(0));
+        detail::chunked_histogram(counts.data(), bins + 1, values.size(), [=](std::size_t first, std::size_t last, std::size_t* c) {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                auto x = data[i];
+                std::size_t b = bins;
+                if (x >= *first_edge && x <= *(last_edge - 1))
+                {
+                    auto it = std::upper_bound(first_edge, last_edge, x);
+                    b = (std::min)(static_cast<std::size_t>(it - first_edge) - 1, bins - 1);
+                }
+                ++c[b];
+            }
+        });
+
+        auto res = xtensor<std::size_t, 1>::from_shape({bins});
+        std::copy(counts.cbegin(), counts.cbegin() + static_cast<std::ptrdiff_t>(bins), res.begin());
+        return res;
+    }
+}
+
+#endif
@@ -11,21 +11,213 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <numeric>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "xbroadcast.hpp"
 #include "xexpression.hpp"
 #include "xiterable.hpp"
+#include "xparallel.hpp"
+#include "xstorage.hpp"
 #include "xstrides.hpp"
 #include "xutils.hpp"
 
 namespace xt
 {
-
     template <class CT, class I>
     class xindex_view;
 
+    namespace detail
+    {
+        /**
+         * Position of an element in the storage of a row-major contiguous
+         * expression. An index view holding such positions accesses the
+         * elements through data_element instead of a multi-dimensional index.
+         */
+        struct flat_index
+        {
+            std::size_t offset;
+        };
+
+        template <class E, class S>
+        inline decltype(auto) indexed_element(E& e, const S& index)
+        {
+            return e[index];
+        }
+
+        template <class E>
+        inline decltype(auto) indexed_element(E& e, const flat_index& index)
+        {
+            return e.data_element(index.offset);
+        }
+
+        template <class E, class = void>
+        struct has_flat_storage : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_flat_storage<E, void_t<decltype(std::declval<const E&>().data_element(std::size_t(0)))>>
+            : std::integral_constant<bool, has_data_interface<E>::value && E::contiguous_layout &&
+                                           E::static_layout == layout_type::row_major>
+        {
+        };
+
+        template <class C>
+        using has_linear_access = std::integral_constant<bool, C::contiguous_layout && C::static_layout == layout_type::row_major>;
+
+        /**
+         * Checks that the condition can be read through data_element with
+         * the storage positions of e, i.e. that it has the shape of e and
+         * does not broadcast any of its operands.
+         */
+        template <class E, class C>
+        inline bool is_linear_condition(const E& e, const C& condition)
+        {
+            return condition.dimension() == e.dimension() &&
+                std::equal(e.shape().cbegin(), e.shape().cend(), condition.shape().cbegin()) &&
+                condition.is_trivial_broadcast(e.strides());
+        }
+
+        template <class F>
+        inline void for_each_chunk(std::size_t size, std::size_t n_chunks, F&& f)
+        {
+            std::size_t chunk_size = (size + n_chunks - 1) / n_chunks;
+            auto run = [&f, size, chunk_size](std::size_t first, std::size_t last) {
+                for (std::size_t c = first; c < last; ++c)
+                {
+                    std::size_t begin = std::min(c * chunk_size, size);
+                    std::size_t end = std::min(begin + chunk_size, size);
+                    f(c, begin, end);
+                }
+            };
+            if (n_chunks > 1)
+            {
+                parallel_for(std::size_t(0), n_chunks, std::size_t(1), run);
+            }
+            else
+            {
+                run(std::size_t(0), n_chunks);
+            }
+        }
+
+        /**
+         * Stream compaction of the positions [0, size) where pred is true,
+         * in two passes over chunks of the input: the first one counts the
+         * selected positions of each chunk, the second one writes them at
+         * the offset of the chunk. The writes do not branch on pred, the
+         * loop stops as soon as the last selected position of the chunk has
+         * been written.
+         */
+        template <class P>
+        inline uvector<flat_index> compact_positions(std::size_t size, P&& pred)
+        {
+            std::size_t n_chunks = parallel_enabled(size) ? 4 * parallel_concurrency() : std::size_t(1);
+            std::vector<std::size_t> counts(n_chunks + 1, std::size_t(0));
+            for_each_chunk(size, n_chunks, [&pred, &counts](std::size_t c, std::size_t begin, std::size_t end) {
+                std::size_t n = 0;
+                for (std::size_t i = begin; i < end; ++i)
+                {
+                    n += static_cast<std::size_t>(pred(i));
+                }
+                counts[c + 1] = n;
+            });
+            std::partial_sum(counts.begin(), counts.end(), counts.begin());
+
+            uvector<flat_index> res(counts.back());
+            flat_index* dst = res.data();
+            for_each_chunk(size, n_chunks, [&pred, &counts, dst](std::size_t c, std::size_t begin, std::size_t) {
+                std::size_t k = counts[c];
+                std::size_t stop = counts[c + 1];
+                for (std::size_t i = begin; k < stop; ++i)
+                {
+                    dst[k].offset = i;
+                    k += static_cast<std::size_t>(pred(i));
+                }
+            });
+            return res;
+        }
+
+        template <class E, class C>
+        inline uvector<flat_index> filter_positions(const E& e, const C& condition, std::false_type)
+        {
+            // The condition is broadcast to the shape of e and traversed in
+            // row-major order, which is the storage order of e.
+            auto bc = broadcast(condition, e.shape());
+            uvector<bool> mask(e.size());
+            std::copy(bc.template cbegin<layout_type::row_major>(), bc.template cend<layout_type::row_major>(), mask.begin());
+            return compact_positions(mask.size(), [&mask](std::size_t i) { return mask[i]; });
+        }
+
+        template <class E, class C>
+        inline uvector<flat_index> filter_positions(const E& e, const C& condition, std::true_type)
+        {
+            if (!is_linear_condition(e, condition))
+            {
+                return filter_positions(e, condition, std::false_type());
+            }
+            return compact_positions(e.size(), [&condition](std::size_t i) {
+                return static_cast<bool>(condition.data_element(i));
+            });
+        }
+
+        template <class E, class C>
+        inline auto make_filter(E&& e, const C& condition, std::true_type)
+        {
+            auto indices = filter_positions(e, condition, has_linear_access<C>());
+            using view_type = xindex_view<xclosure_t<E>, decltype(indices)>;
+            return view_type(std::forward<E>(e), std::move(indices));
+        }
+
+        // As on the flat path, a condition of lower rank is broadcast to
+        // the shape of e, so that the selection does not depend on the
+        // layout of e.
+        template <class E, class C>
+        inline auto make_filter(E&& e, const C& condition, std::false_type)
+        {
+            auto indices = where(broadcast(condition, e.shape()));
+            using view_type = xindex_view<xclosure_t<E>, decltype(indices)>;
+            return view_type(std::forward<E>(e), std::move(indices));
+        }
+
+        template <class E, class C, class F>
+        inline bool apply_linear(E& e, const C& condition, F& func, std::true_type)
+        {
+            if (!is_linear_condition(e, condition))
+            {
+                return false;
+            }
+            auto* data = e.data();
+            // func selects between its argument and the updated value, the
+            // loop has no branch and the compiler emits masked blends.
+            auto run = [data, &condition, &func](std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    data[i] = func(data[i], static_cast<bool>(condition.data_element(i)));
+                }
+            };
+            std::size_t size = e.size();
+            if (parallel_enabled(size))
+            {
+                parallel_for(std::size_t(0), size, std::size_t(1), run);
+            }
+            else
+            {
+                run(std::size_t(0), size);
+            }
+            return true;
+        }
+
+        template <class E, class C, class F>
+        inline bool apply_linear(E&, const C&, F&, std::false_type)
+        {
+            return false;
+        }
+    }
+
     template <class CT, class I>
     struct xcontainer_inner_types<xindex_view<CT, I>>
     {
@@ -147,6 +339,9 @@ namespace xt
         template <class ST>
         const_stepper stepper_end(const ST& shape, layout_type) const;
 
+        template <class E, class IT = I, class = std::enable_if_t<std::is_same<typename IT::value_type, detail::flat_index>::value>>
+        void assign_to(xexpression<E>& e) const;
+
     private:
 
         CT m_e;
@@ -329,7 +524,7 @@ namespace xt
     template <class... Args>
     inline auto xindex_view<CT, I>::operator()(size_type idx, Args... /*args*/) -> reference
     {
-        return m_e[m_indices[idx]];
+        return detail::indexed_element(m_e, m_indices[idx]);
     }
 
     /**
@@ -341,7 +536,7 @@ namespace xt
     template <class... Args>
     inline auto xindex_view<CT, I>::operator()(size_type idx, Args... /*args*/) const -> const_reference
     {
-        return m_e[m_indices[idx]];
+        return detail::indexed_element(m_e, m_indices[idx]);
     }
 
     template <class CT, class I>
@@ -349,7 +544,7 @@ namespace xt
     inline auto xindex_view<CT, I>::operator[](const S& index)
         -> disable_integral_t<S, reference>
     {
-        return m_e[m_indices[index[0]]];
+        return detail::indexed_element(m_e, m_indices[index[0]]);
     }
 
     template <class CT, class I>
@@ -357,7 +552,7 @@ namespace xt
     inline auto xindex_view<CT, I>::operator[](std::initializer_list<OI> index)
         -> reference
     {
-        return m_e[m_indices[*(index.begin())]];
+        return detail::indexed_element(m_e, m_indices[*(index.begin())]);
     }
 
     template <class CT, class I>
@@ -371,7 +566,7 @@ namespace xt
     inline auto xindex_view<CT, I>::operator[](const S& index) const
         -> disable_integral_t<S, const_reference>
     {
-        return m_e[m_indices[index[0]]];
+        return detail::indexed_element(m_e, m_indices[index[0]]);
     }
 
     template <class CT, class I>
@@ -379,7 +574,7 @@ namespace xt
     inline auto xindex_view<CT, I>::operator[](std::initializer_list<OI> index) const
         -> const_reference
     {
-        return m_e[m_indices[*(index.begin())]];
+        return detail::indexed_element(m_e, m_indices[*(index.begin())]);
     }
 
     template <class CT, class I>
@@ -397,14 +592,14 @@ namespace xt
     template <class It>
     inline auto xindex_view<CT, I>::element(It first, It /*last*/) -> reference
     {
-        return m_e[m_indices[(*first)]];
+        return detail::indexed_element(m_e, m_indices[(*first)]);
     }
 
     template <class CT, class I>
     template <class It>
     inline auto xindex_view<CT, I>::element(It first, It /*last*/) const -> const_reference
     {
-        return m_e[m_indices[(*first)]];
+        return detail::indexed_element(m_e, m_indices[(*first)]);
     }
     //@}
 
@@ -473,6 +668,39 @@ namespace xt
         return const_stepper(this, offset, true);
     }
 
+    /**
+     * Gathers the selected elements into the container \c e, in parallel
+     * for large selections. Only available for the views built by \ref filter
+     * on row-major contiguous expressions.
+     * @param e the container to assign
+     */
+    template <class CT, class I>
+    template <class E, class, class>
+    inline void xindex_view<CT, I>::assign_to(xexpression<E>& e) const
+    {
+        auto& de = e.derived_cast();
+        de.resize(m_shape);
+        using e_value_type = typename E::value_type;
+        e_value_type* res = de.data();
+        const auto& ex = m_e;
+        const auto& indices = m_indices;
+        auto gather = [res, &ex, &indices](size_type first, size_type last) {
+            for (size_type i = first; i < last; ++i)
+            {
+                res[i] = static_cast<e_value_type>(ex.data_element(indices[i].offset));
+            }
+        };
+        size_type n = m_indices.size();
+        if (parallel_enabled(n))
+        {
+            parallel_for(size_type(0), n, size_type(1), gather);
+        }
+        else
+        {
+            gather(size_type(0), n);
+        }
+    }
+
     /******************************
      * xfiltration implementation *
      ******************************/
@@ -581,7 +809,12 @@ namespace xt
     template <class F>
     inline auto xfiltration<ECT, CCT>::apply(F&& func) -> self_type&
     {
-        std::transform(m_e.cbegin(), m_e.cend(), m_condition.cbegin(), m_e.begin(), func);
+        using flat = std::integral_constant<bool, detail::has_flat_storage<xexpression_type>::value &&
+                                                  detail::has_linear_access<std::decay_t<CCT>>::value>;
+        if (!detail::apply_linear(m_e, m_condition, func, flat()))
+        {
+            std::transform(m_e.cbegin(), m_e.cend(), m_condition.cbegin(), m_e.begin(), func);
+        }
         return *this;
     }
 
@@ -637,8 +870,13 @@ namespace xt
      * elements. In that case, you should consider using the \ref filtration function
      * instead.
      *
+     * When \a e is a row-major contiguous container, the view holds the storage
+     * positions of the selected elements, computed by a parallel stream compaction
+     * of \a condition, and is gathered directly when assigned to a container.
+     *
      * @param e the underlying xexpression
-     * @param condition xexpression with shape of \a e which selects indices
+     * @param condition xexpression which selects indices, broadcast to
+     *                  the shape of \a e
      *
      * \code{.cpp}
      * xarray<double> a = {{1,5,3}, {4,5,6}};
@@ -649,11 +887,9 @@ namespace xt
      * \sa filtration
      */
     template <class E, class O>
-    inline auto filter(E&& e, O&& condition) noexcept
+    inline auto filter(E&& e, O&& condition)
     {
-        auto indices = where(std::forward<O>(condition));
-        using view_type = xindex_view<xclosure_t<E>, decltype(indices)>;
-        return view_type(std::forward<E>(e), std::move(indices));
+        return detail::make_filter(std::forward<E>(e), condition, detail::has_flat_storage<std::decay_t<E>>());
     }
 
     /**
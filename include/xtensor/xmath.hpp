@@ -626,6 +626,32 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
         };
     }
 
+    template <class T>
+    struct xreducer_simd_traits<math::minimum<T>>
+    {
+        static constexpr bool value = true;
+        using value_type = T;
+
+        template <class B>
+        static B apply(const math::minimum<T>& f, const B& b1, const B& b2)
+        {
+            return f.simd_apply(b1, b2);
+        }
+    };
+
+    template <class T>
+    struct xreducer_simd_traits<math::maximum<T>>
+    {
+        static constexpr bool value = true;
+        using value_type = T;
+
+        template <class B>
+        static B apply(const math::maximum<T>& f, const B& b1, const B& b2)
+        {
+            return f.simd_apply(b1, b2);
+        }
+    };
+
     /**
      * @ingroup basic_functions
      * @brief Elementwise maximum
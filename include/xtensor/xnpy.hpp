@@ -19,11 +19,14 @@
 #include <complex>
 #include <cstdint>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
 #include <regex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <typeinfo>
 #include <vector>
 
@@ -31,11 +34,28 @@
 #include "xtensor/xarray.hpp"
 #include "xtensor/xeval.hpp"
 #include "xtensor/xstrides.hpp"
+#include "xtensor/xstrided_view.hpp"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace xt
 {
     using namespace std::string_literals;
 
+    /*! Access mode of the memory mapping created by load_npy_mmap */
+    enum class npy_mmap_mode
+    {
+        /*! the mapped pages are shared with the page cache, the elements are const */
+        read_only,
+        /*! writes go to private copies of the mapped pages, the file is not modified */
+        copy_on_write
+    };
+
     namespace detail
     {
 
@@ -347,7 +367,8 @@ namespace xt
 
         template <class O, class S>
         inline void write_header(O& out, const std::string& descr,
-                                 bool fortran_order, const S& shape)
+                                 bool fortran_order, const S& shape,
+                                 std::size_t leading_width = 0)
         {
             std::ostringstream ss_header;
             std::string s_fortran_order;
@@ -365,6 +386,12 @@ namespace xt
             ss_shape << "(";
             for (auto shape_it = std::begin(shape); shape_it != std::end(shape); ++shape_it)
             {
+                // The leading dimension can be padded so that it may be
+                // rewritten in place, see npy_writer
+                if (shape_it == std::begin(shape))
+                {
+                    ss_shape << std::setw(int(leading_width));
+                }
                 ss_shape << *shape_it << ", ";
             }
             s_shape = ss_shape.str();
@@ -470,6 +497,32 @@ namespace xt
             return header;
         }
 
+        template <class T, layout_type L>
+        inline std::vector<std::size_t> npy_cast_strides(const std::vector<std::size_t>& shape,
+                                                         bool fortran_order,
+                                                         const std::string& typestring,
+                                                         bool check_type)
+        {
+            // check if the typestring matches the given one
+            if (check_type && typestring != detail::build_typestring<T>())
+            {
+                throw std::runtime_error("Cast error: formats not matching "s + typestring +
+                                         " vs "s + detail::build_typestring<T>());
+            }
+
+            if ((L == layout_type::column_major && !fortran_order) ||
+                (L == layout_type::row_major && fortran_order))
+            {
+                throw std::runtime_error("Cast error: layout mismatch between npy file and requested layout.");
+            }
+
+            std::vector<std::size_t> strides(shape.size());
+            compute_strides(shape,
+                            fortran_order ? layout_type::column_major : layout_type::row_major,
+                            strides);
+            return strides;
+        }
+
         struct npy_file
         {
             npy_file() = default;
@@ -531,25 +584,9 @@ namespace xt
                     throw std::runtime_error("This npy_file has already been cast.");
                 }
                 T* ptr = reinterpret_cast<T*>(&m_buffer[0]);
-                std::vector<std::size_t> strides(m_shape.size());
                 std::size_t sz = compute_size(m_shape);
-
-                // check if the typestring matches the given one
-                if (check_type && m_typestring != detail::build_typestring<T>())
-                {
-                    throw std::runtime_error("Cast error: formats not matching "s + m_typestring +
-                                             " vs "s + detail::build_typestring<T>());
-                }
-
-                if ((L == layout_type::column_major && !m_fortran_order) ||
-                    (L == layout_type::row_major && m_fortran_order))
-                {
-                    throw std::runtime_error("Cast error: layout mismatch between npy file and requested layout.");
-                }
-
-                compute_strides(m_shape,
-                                m_fortran_order ? layout_type::column_major : layout_type::row_major,
-                                strides);
+                std::vector<std::size_t> strides = npy_cast_strides<T, L>(m_shape, m_fortran_order,
+                                                                          m_typestring, check_type);
                 std::vector<std::size_t> shape(m_shape);
 
                 return std::make_tuple(ptr, sz, std::move(shape), std::move(strides));
@@ -598,7 +635,8 @@ namespace xt
             char* m_buffer;
         };
 
-        npy_file load_npy_file(std::istream& stream)
+        inline void read_npy_header(std::istream& stream, std::vector<std::size_t>& shape,
+                                    bool& fortran_order, std::string& typestr)
         {
             // check magic bytes an version number
             unsigned char v_major, v_minor;
@@ -620,11 +658,15 @@ namespace xt
             }
 
             // parse header
+            detail::parse_header(header, typestr, &fortran_order, shape);
+        }
+
+        npy_file load_npy_file(std::istream& stream)
+        {
             bool fortran_order;
             std::string typestr;
-
             std::vector<std::size_t> shape;
-            detail::parse_header(header, typestr, &fortran_order, shape);
+            read_npy_header(stream, shape, fortran_order, typestr);
 
             npy_file result(shape, fortran_order, typestr);
             // read the data
@@ -653,6 +695,178 @@ namespace xt
             stream.write(reinterpret_cast<const char*>(eval_ex.data()),
                          std::streamsize((sizeof(value_type) * size)));
         }
+
+        // Mapping of a whole file in memory, unmapped on destruction.
+        class npy_mmap_region
+        {
+        public:
+
+            npy_mmap_region(const std::string& filename, npy_mmap_mode mode);
+            ~npy_mmap_region();
+
+            npy_mmap_region(const npy_mmap_region&) = delete;
+            npy_mmap_region& operator=(const npy_mmap_region&) = delete;
+
+            char* data() const noexcept;
+            std::size_t size() const noexcept;
+            bool contains(const void* ptr) const noexcept;
+
+        private:
+
+            char* m_data;
+            std::size_t m_size;
+        };
+
+        inline npy_mmap_region::npy_mmap_region(const std::string& filename, npy_mmap_mode mode)
+            : m_data(nullptr), m_size(0)
+        {
+#ifdef _WIN32
+            (void) mode;
+            throw std::runtime_error("load_npy_mmap is not supported on this platform: "s + filename);
+#else
+            int fd = ::open(filename.c_str(), O_RDONLY);
+            if (fd == -1)
+            {
+                throw std::runtime_error("io error: failed to open a file.");
+            }
+            struct stat file_stat;
+            if (::fstat(fd, &file_stat) == -1)
+            {
+                ::close(fd);
+                throw std::runtime_error("io error: failed to stat file: "s + filename);
+            }
+            std::size_t size = static_cast<std::size_t>(file_stat.st_size);
+            int prot = mode == npy_mmap_mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+            int flags = mode == npy_mmap_mode::read_only ? MAP_SHARED : MAP_PRIVATE;
+            void* ptr = ::mmap(nullptr, size, prot, flags, fd, 0);
+            // The mapping remains valid once the descriptor is closed
+            ::close(fd);
+            if (ptr == MAP_FAILED)
+            {
+                throw std::runtime_error("io error: failed to map file: "s + filename);
+            }
+            m_data = static_cast<char*>(ptr);
+            m_size = size;
+#endif
+        }
+
+        inline npy_mmap_region::~npy_mmap_region()
+        {
+#ifndef _WIN32
+            if (m_data != nullptr)
+            {
+                ::munmap(m_data, m_size);
+            }
+#endif
+        }
+
+        inline char* npy_mmap_region::data() const noexcept
+        {
+            return m_data;
+        }
+
+        inline std::size_t npy_mmap_region::size() const noexcept
+        {
+            return m_size;
+        }
+
+        inline bool npy_mmap_region::contains(const void* ptr) const noexcept
+        {
+            const char* p = static_cast<const char*>(ptr);
+            return m_data <= p && p < m_data + m_size;
+        }
+
+        // Allocator of the buffers returned by load_npy_mmap: deallocating the
+        // mapped payload releases the mapping, other buffers (e.g. after a
+        // resize) are handled as with std::allocator. When T is const, the
+        // buffers are read-only: pointer and reference are const.
+        template <class T>
+        class npy_mmap_allocator
+        {
+        public:
+
+            using value_type = std::remove_const_t<T>;
+            using pointer = T*;
+            using const_pointer = const value_type*;
+            using reference = T&;
+            using const_reference = const value_type&;
+            using size_type = std::size_t;
+            using difference_type = std::ptrdiff_t;
+
+            template <class U>
+            struct rebind
+            {
+                using other = npy_mmap_allocator<U>;
+            };
+
+            npy_mmap_allocator() noexcept = default;
+
+            explicit npy_mmap_allocator(std::shared_ptr<npy_mmap_region> region) noexcept
+                : m_region(std::move(region))
+            {
+            }
+
+            template <class U>
+            npy_mmap_allocator(const npy_mmap_allocator<U>& rhs) noexcept
+                : m_region(rhs.region())
+            {
+            }
+
+            pointer allocate(size_type n)
+            {
+                return std::allocator<value_type>().allocate(n);
+            }
+
+            void deallocate(pointer p, size_type n)
+            {
+                if (m_region != nullptr && m_region->contains(p))
+                {
+                    m_region.reset();
+                }
+                else
+                {
+                    std::allocator<value_type>().deallocate(const_cast<value_type*>(p), n);
+                }
+            }
+
+            template <class U, class... Args>
+            void construct(U* p, Args&&... args)
+            {
+                new (const_cast<void*>(static_cast<const void*>(p))) std::remove_const_t<U>(std::forward<Args>(args)...);
+            }
+
+            template <class U>
+            void destroy(U* p)
+            {
+                p->~U();
+            }
+
+            npy_mmap_allocator select_on_container_copy_construction() const noexcept
+            {
+                return npy_mmap_allocator();
+            }
+
+            const std::shared_ptr<npy_mmap_region>& region() const noexcept
+            {
+                return m_region;
+            }
+
+        private:
+
+            std::shared_ptr<npy_mmap_region> m_region;
+        };
+
+        template <class T, class U>
+        inline bool operator==(const npy_mmap_allocator<T>& lhs, const npy_mmap_allocator<U>& rhs) noexcept
+        {
+            return lhs.region() == rhs.region();
+        }
+
+        template <class T, class U>
+        inline bool operator!=(const npy_mmap_allocator<T>& lhs, const npy_mmap_allocator<U>& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
     }  // namespace detail
 
 
@@ -674,6 +888,259 @@ namespace xt
         detail::dump_npy_stream(stream, e);
     }
 
+    /**
+     * @class npy_writer
+     * @brief Incremental writer of npy files.
+     *
+     * The npy_writer writes a npy file (the numpy storage format) slab by
+     * slab along the first axis, so that arrays whose length is not known
+     * in advance, or which do not fit in memory, can be saved without being
+     * materialized. Lazy expressions are evaluated by chunks of rows. The
+     * leading dimension of the header is updated when the writer is closed.
+     *
+     * @tparam T the value type of the npy file
+     */
+    template <class T>
+    class npy_writer
+    {
+    public:
+
+        using value_type = T;
+        using shape_type = std::vector<std::size_t>;
+
+        explicit npy_writer(const std::string& filename);
+        template <class S>
+        npy_writer(const std::string& filename, const S& row_shape);
+        ~npy_writer();
+
+        npy_writer(const npy_writer&) = delete;
+        npy_writer& operator=(const npy_writer&) = delete;
+
+        npy_writer(npy_writer&&) = default;
+        npy_writer& operator=(npy_writer&&) = delete;
+
+        template <class E>
+        npy_writer& append(const xexpression<E>& e);
+
+        void close();
+
+        bool is_open() const noexcept;
+        const shape_type& shape() const noexcept;
+
+    private:
+
+        template <class E>
+        void write_rows(const E& e, std::size_t n_rows);
+        void write_data(const T* data, std::size_t size);
+        void write_header();
+
+        // Width of the leading dimension in the header, large enough
+        // for any 64-bit value
+        static constexpr std::size_t leading_width = 20;
+        // Number of elements evaluated at once for lazy expressions
+        static constexpr std::size_t chunk_size = 65536;
+
+        std::string m_filename;
+        std::ofstream m_stream;
+        shape_type m_shape;
+        bool m_header_written;
+        std::streamoff m_leading_dim_pos;
+        xarray<T> m_buffer;
+    };
+
+    /*****************************
+     * npy_writer implementation *
+     *****************************/
+
+    /**
+     * Opens a npy file for writing. The shape of the rows is deduced
+     * from the first slab passed to append.
+     * @param filename The filename or path to the file
+     */
+    template <class T>
+    inline npy_writer<T>::npy_writer(const std::string& filename)
+        : m_filename(filename), m_stream(filename, std::ofstream::binary),
+          m_shape(), m_header_written(false), m_leading_dim_pos(0)
+    {
+        if (!m_stream)
+        {
+            throw std::runtime_error("IO Error: failed to open file: "s + filename);
+        }
+    }
+
+    /**
+     * Opens a npy file for writing rows of the given shape.
+     * @param filename The filename or path to the file
+     * @param row_shape the shape of the array without its leading dimension
+     */
+    template <class T>
+    template <class S>
+    inline npy_writer<T>::npy_writer(const std::string& filename, const S& row_shape)
+        : npy_writer(filename)
+    {
+        m_shape.push_back(0);
+        m_shape.insert(m_shape.end(), std::begin(row_shape), std::end(row_shape));
+        write_header();
+    }
+
+    /**
+     * Closes the writer, errors are ignored; call close to handle them.
+     */
+    template <class T>
+    inline npy_writer<T>::~npy_writer()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    /**
+     * Appends an expression to the file. The expression is either a slab of
+     * rows, with the same dimension as the file, or a single row, with one
+     * dimension less. Its shape without the leading dimension must match
+     * the one of the rows previously written.
+     * @param e the expression to append
+     * @return a reference to the writer
+     */
+    template <class T>
+    template <class E>
+    inline auto npy_writer<T>::append(const xexpression<E>& e) -> npy_writer&
+    {
+        const E& de = e.derived_cast();
+        if (!m_stream.is_open())
+        {
+            throw std::runtime_error("npy_writer: cannot append to a closed file: "s + m_filename);
+        }
+        if (!m_header_written)
+        {
+            if (de.dimension() == 0)
+            {
+                throw std::runtime_error("npy_writer: cannot append a 0-D expression.");
+            }
+            m_shape.assign(de.shape().cbegin(), de.shape().cend());
+            m_shape[0] = 0;
+            write_header();
+        }
+
+        const auto& shape = de.shape();
+        if (de.dimension() == m_shape.size() &&
+            std::equal(shape.cbegin() + 1, shape.cend(), m_shape.cbegin() + 1))
+        {
+            write_rows(de, shape[0]);
+        }
+        else if (de.dimension() + 1 == m_shape.size() &&
+                 std::equal(shape.cbegin(), shape.cend(), m_shape.cbegin() + 1))
+        {
+            m_buffer = de;
+            write_data(m_buffer.data(), m_buffer.size());
+            m_shape[0] += 1;
+        }
+        else
+        {
+            throw std::runtime_error("npy_writer: shape mismatch between the appended expression and the file.");
+        }
+        return *this;
+    }
+
+    /**
+     * Writes the final leading dimension in the header and closes the file.
+     * If nothing has been written, the file holds an empty 1-D array.
+     */
+    template <class T>
+    inline void npy_writer<T>::close()
+    {
+        if (!m_stream.is_open())
+        {
+            return;
+        }
+        if (!m_header_written)
+        {
+            m_shape = {0};
+            write_header();
+        }
+        m_stream.seekp(m_leading_dim_pos);
+        m_stream << std::setw(int(leading_width)) << m_shape[0];
+        m_stream.close();
+        if (!m_stream)
+        {
+            throw std::runtime_error("IO Error: failed to write file: "s + m_filename);
+        }
+    }
+
+    /**
+     * Returns true if the file is open for writing.
+     */
+    template <class T>
+    inline bool npy_writer<T>::is_open() const noexcept
+    {
+        return m_stream.is_open();
+    }
+
+    /**
+     * Returns the shape of the array written so far, empty if neither
+     * the row shape nor any slab has been given yet.
+     */
+    template <class T>
+    inline auto npy_writer<T>::shape() const noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    template <class T>
+    template <class E>
+    inline void npy_writer<T>::write_rows(const E& e, std::size_t n_rows)
+    {
+        std::size_t row_size = compute_size(e.shape()) / (n_rows == 0 ? 1 : n_rows);
+        xtl::mpl::static_if<detail::is_container<E>::value && std::is_same<typename E::value_type, T>::value>([&](auto self) {
+            if (self(e).layout() == layout_type::row_major)
+            {
+                write_data(self(e).data(), self(e).size());
+            }
+            else
+            {
+                m_buffer = self(e);
+                write_data(m_buffer.data(), m_buffer.size());
+            }
+        }, /*else*/ [&](auto self) {
+            std::size_t chunk_rows = (std::max)(std::size_t(1), chunk_size / (std::max)(row_size, std::size_t(1)));
+            slice_vector sv(e.dimension(), all());
+            for (std::size_t i = 0; i < n_rows; i += chunk_rows)
+            {
+                std::size_t last = (std::min)(i + chunk_rows, n_rows);
+                sv[0] = range(std::ptrdiff_t(i), std::ptrdiff_t(last));
+                m_buffer = strided_view(self(e), sv);
+                write_data(m_buffer.data(), m_buffer.size());
+            }
+        });
+        m_shape[0] += n_rows;
+    }
+
+    template <class T>
+    inline void npy_writer<T>::write_data(const T* data, std::size_t size)
+    {
+        m_stream.write(reinterpret_cast<const char*>(data), std::streamsize(sizeof(T) * size));
+        if (!m_stream)
+        {
+            throw std::runtime_error("IO Error: failed to write file: "s + m_filename);
+        }
+    }
+
+    template <class T>
+    inline void npy_writer<T>::write_header()
+    {
+        std::ostringstream ss_header;
+        detail::write_header(ss_header, detail::build_typestring<T>(), false, m_shape, leading_width);
+        std::string header = ss_header.str();
+        const std::string shape_key = "'shape': (";
+        m_leading_dim_pos = std::streamoff(header.find(shape_key) + shape_key.size());
+        m_stream.write(header.data(), std::streamsize(header.size()));
+        m_header_written = true;
+    }
+
     /**
      * Loads a npy file (the numpy storage format)
      *
@@ -696,6 +1163,61 @@ namespace xt
         return std::move(file).cast<T, L>();
     }
 
+    /**
+     * Loads a npy file (the numpy storage format) without reading its
+     * payload: the file is mapped in memory and the returned xarray_adaptor
+     * points directly to the mapped data, whose pages are loaded lazily on
+     * first access. Mappings of the same file share the page cache. The
+     * mapping is released when the adaptor is destroyed.
+     *
+     * Not supported on Windows.
+     *
+     * @param filename The filename or path to the file
+     * @tparam T select the type of the npy file (note: currently there is
+     *           no dynamic casting if types do not match)
+     * @tparam L select layout_type::column_major if you stored data in
+     *           Fortran format
+     * @tparam M npy_mmap_mode::read_only (the default) maps the file for
+     *           reading only, the elements of the returned adaptor are
+     *           const; npy_mmap_mode::copy_on_write allows writing to the
+     *           adaptor without modifying the file
+     * @return xarray_adaptor on the mapped contents of the npy file
+     */
+    template <typename T, layout_type L = layout_type::dynamic, npy_mmap_mode M = npy_mmap_mode::read_only>
+    auto load_npy_mmap(const std::string& filename)
+    {
+        using value_type = std::conditional_t<M == npy_mmap_mode::read_only, const T, T>;
+        bool fortran_order;
+        std::string typestr;
+        std::vector<std::size_t> shape;
+        std::size_t offset;
+        {
+            std::ifstream stream(filename, std::ifstream::binary);
+            if (!stream)
+            {
+                throw std::runtime_error("io error: failed to open a file.");
+            }
+            detail::read_npy_header(stream, shape, fortran_order, typestr);
+            offset = static_cast<std::size_t>(stream.tellg());
+        }
+        std::vector<std::size_t> strides = detail::npy_cast_strides<T, L>(shape, fortran_order, typestr, true);
+        std::size_t size = compute_size(shape);
+
+        auto region = std::make_shared<detail::npy_mmap_region>(filename, M);
+        if (offset + size * sizeof(T) > region->size())
+        {
+            throw std::runtime_error("io error: truncated npy file: "s + filename);
+        }
+        if (offset % alignof(T) != 0)
+        {
+            throw std::runtime_error("npy payload is not aligned for the requested type: "s + filename);
+        }
+
+        value_type* ptr = reinterpret_cast<value_type*>(region->data() + offset);
+        return adapt(std::move(ptr), size, acquire_ownership(), std::move(shape), std::move(strides),
+                     detail::npy_mmap_allocator<value_type>(std::move(region)));
+    }
+
 }  // namespace xt
 
 #endif
@@ -0,0 +1,203 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_PARALLEL_HPP
+#define XTENSOR_PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <type_traits>
+
+#include "xtensor_config.hpp"
+
+#if defined(XTENSOR_USE_TBB)
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+#elif defined(XTENSOR_USE_OPENMP)
+#include <omp.h>
+#endif
+
+namespace xt
+{
+
+    /***********************
+     * parallel primitives *
+     ***********************/
+
+    std::size_t parallel_concurrency() noexcept;
+
+    bool parallel_enabled(std::size_t size) noexcept;
+
+    template <class F>
+    void parallel_for(std::size_t first, std::size_t last, std::size_t grain, F&& f);
+
+    template <class It, class T>
+    void parallel_fill(It first, It last, const T& value);
+
+    template <class It, class O>
+    O parallel_copy(It first, It last, O output);
+
+    /**************************************
+     * parallel primitives implementation *
+     **************************************/
+
+    /**
+     * Returns the number of workers available to the parallel algorithms
+     * of xtensor, 1 if neither XTENSOR_USE_TBB nor XTENSOR_USE_OPENMP is
+     * defined.
+     */
+    inline std::size_t parallel_concurrency() noexcept
+    {
+#if defined(XTENSOR_USE_TBB)
+        return static_cast<std::size_t>(tbb::this_task_arena::max_concurrency());
+#elif defined(XTENSOR_USE_OPENMP)
+        return static_cast<std::size_t>(omp_get_max_threads());
+#else
+        return std::size_t(1);
+#endif
+    }
+
+    /**
+     * Returns true if a workload of @p size elements should be split across
+     * several workers, that is, if a parallel backend is enabled and @p size
+     * is not smaller than XTENSOR_PARALLEL_THRESHOLD.
+     */
+    inline bool parallel_enabled(std::size_t size) noexcept
+    {
+#if defined(XTENSOR_USE_TBB)
+        return size >= std::size_t(XTENSOR_PARALLEL_THRESHOLD) && parallel_concurrency() > 1;
+#elif defined(XTENSOR_USE_OPENMP)
+        return size >= std::size_t(XTENSOR_PARALLEL_THRESHOLD) && parallel_concurrency() > 1 && !omp_in_parallel();
+#else
+        (void) size;  // remove unused parameter warning
+        return false;
+#endif
+    }
+
+    /**
+     * Splits the range [@p first, @p last) into chunks whose bounds are
+     * multiples of @p grain (relative to @p first, except for the last
+     * bound) and calls @p f(begin, end) on each of them concurrently. If no
+     * parallel backend is enabled, @p f is called once on the whole range.
+     * Callers are expected to check parallel_enabled on the size of the
+     * underlying workload before calling this function.
+     * @param first the beginning of the range
+     * @param last the end of the range
+     * @param grain the granularity of the chunks
+     * @param f the function to call on each chunk
+     */
+    template <class F>
+    inline void parallel_for(std::size_t first, std::size_t last, std::size_t grain, F&& f)
+    {
+        if (last <= first)
+        {
+            return;
+        }
+        std::size_t n_blocks = (last - first + grain - 1) / grain;
+        auto run_blocks = [first, last, grain, &f](std::size_t block_begin, std::size_t block_end) {
+            f(first + block_begin * grain, (std::min)(first + block_end * grain, last));
+        };
+#if defined(XTENSOR_USE_TBB)
+        tbb::parallel_for(tbb::blocked_range<std::size_t>(std::size_t(0), n_blocks),
+                          [&run_blocks](const tbb::blocked_range<std::size_t>& r) {
+                              run_blocks(r.begin(), r.end());
+                          });
+#elif defined(XTENSOR_USE_OPENMP)
+        // Exceptions must not escape an OpenMP parallel region, the first one
+        // is captured and rethrown once all the workers are done.
+        std::exception_ptr error;
+        std::size_t n_chunks = (std::min)(n_blocks, parallel_concurrency());
+        std::ptrdiff_t n = static_cast<std::ptrdiff_t>(n_chunks);
+#pragma omp parallel for schedule(static)
+        for (std::ptrdiff_t c = 0; c < n; ++c)
+        {
+            std::size_t chunk = static_cast<std::size_t>(c);
+            try
+            {
+                run_blocks(n_blocks * chunk / n_chunks, n_blocks * (chunk + 1) / n_chunks);
+            }
+            catch (...)
+            {
+#pragma omp critical(xtensor_parallel_for)
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+#else
+        run_blocks(std::size_t(0), n_blocks);
+#endif
+    }
+
+    /**
+     * Assigns @p value to the elements of the random access range
+     * [@p first, @p last), splitting the range among the workers when
+     * parallel_enabled() is true for its size. The pages of freshly
+     * allocated memory are then first touched by the parallel workers
+     * rather than by the calling thread alone.
+     * @param first the beginning of the range
+     * @param last the end of the range
+     * @param value the value to assign
+     */
+    template <class It, class T>
+    inline void parallel_fill(It first, It last, const T& value)
+    {
+        // Proxy references, such as the ones of std::vector<bool>, may
+        // share memory between elements and are not split
+        using reference = typename std::iterator_traits<It>::reference;
+        std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+        if (std::is_lvalue_reference<reference>::value && parallel_enabled(size))
+        {
+            using difference_type = typename std::iterator_traits<It>::difference_type;
+            parallel_for(std::size_t(0), size, std::size_t(1), [first, &value](std::size_t b, std::size_t e) {
+                std::fill(first + static_cast<difference_type>(b), first + static_cast<difference_type>(e), value);
+            });
+        }
+        else
+        {
+            std::fill(first, last, value);
+        }
+    }
+
+    /**
+     * Copies the random access range [@p first, @p last) to the range
+     * beginning at @p output, splitting the copy among the workers when
+     * parallel_enabled() is true for its size.
+     * @param first the beginning of the input range
+     * @param last the end of the input range
+     * @param output the beginning of the output range
+     * @return an iterator past the last element written
+     */
+    template <class It, class O>
+    inline O parallel_copy(It first, It last, O output)
+    {
+        using reference = typename std::iterator_traits<O>::reference;
+        std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+        if (std::is_lvalue_reference<reference>::value && parallel_enabled(size))
+        {
+            using difference_type = typename std::iterator_traits<It>::difference_type;
+            using output_difference_type = typename std::iterator_traits<O>::difference_type;
+            parallel_for(std::size_t(0), size, std::size_t(1), [first, output](std::size_t b, std::size_t e) {
+                std::copy(first + static_cast<difference_type>(b), first + static_cast<difference_type>(e),
+                          output + static_cast<output_difference_type>(b));
+            });
+            return output + static_cast<output_difference_type>(size);
+        }
+        return std::copy(first, last, output);
+    }
+}
+
+#endif
@@ -0,0 +1,1182 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_PRODUCT_HPP
+#define XTENSOR_PRODUCT_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <xtl/xsequence.hpp>
+#include <xtl/xtype_traits.hpp>
+
+#include "xarray.hpp"
+#include "xassign.hpp"
+#include "xfixed.hpp"
+#include "xparallel.hpp"
+#include "xstorage.hpp"
+#include "xtensor_simd.hpp"
+#include "xutils.hpp"
+
+namespace xt
+{
+
+    /************************
+     * product declarations *
+     ************************/
+
+    template <class E1, class E2>
+    auto dot(const xexpression<E1>& e1, const xexpression<E2>& e2);
+
+    template <class E1, class E2>
+    auto outer(const xexpression<E1>& e1, const xexpression<E2>& e2);
+
+    template <class E1, class E2>
+    auto matmul(const xexpression<E1>& e1, const xexpression<E2>& e2);
+
+    template <class E1, class E2>
+    auto tensordot(const xexpression<E1>& e1, const xexpression<E2>& e2, std::size_t naxes = 2);
+
+    template <class E1, class E2, class A1, class A2>
+    auto tensordot(const xexpression<E1>& e1, const xexpression<E2>& e2, const A1& axes1, const A2& axes2);
+
+    template <class E1, class E2>
+    auto tensordot(const xexpression<E1>& e1, const xexpression<E2>& e2,
+                   std::initializer_list<std::size_t> axes1, std::initializer_list<std::size_t> axes2);
+
+    template <class E>
+    auto einsum(const std::string& subscripts, const xexpression<E>& e);
+
+    template <class E1, class E2>
+    auto einsum(const std::string& subscripts, const xexpression<E1>& e1, const xexpression<E2>& e2);
+
+    /*************************
+     * gemm kernel constants *
+     *************************/
+
+    namespace detail
+    {
+        // Blocking of the operands: a kc x nc panel of B is packed once and
+        // shared by the workers, each of them packing mc x kc blocks of A.
+        constexpr std::size_t gemm_kc = 256;
+        constexpr std::size_t gemm_mc = 96;
+        constexpr std::size_t gemm_nc = 4096;
+
+        template <class T, bool = std::is_floating_point<T>::value && (xsimd::simd_traits<T>::size > 1)>
+        struct gemm_traits
+        {
+            using batch_type = T;
+            static constexpr std::size_t batch_size = 1;
+            static constexpr std::size_t mr = 4;
+            static constexpr std::size_t nb = 4;
+
+            static batch_type load(const T* src)
+            {
+                return *src;
+            }
+
+            static void store(T* dst, const batch_type& src)
+            {
+                *dst = src;
+            }
+
+            static batch_type broadcast(const T& value)
+            {
+                return value;
+            }
+        };
+
+        template <class T>
+        struct gemm_traits<T, true>
+        {
+            using batch_type = xsimd::simd_type<T>;
+            static constexpr std::size_t batch_size = xsimd::simd_traits<T>::size;
+            static constexpr std::size_t mr = 4;
+            static constexpr std::size_t nb = 2;
+
+            static batch_type load(const T* src)
+            {
+                return xsimd::load_simd(src, unaligned_mode());
+            }
+
+            static void store(T* dst, const batch_type& src)
+            {
+                xsimd::store_simd(dst, src, unaligned_mode());
+            }
+
+            static batch_type broadcast(const T& value)
+            {
+                return xsimd::set_simd(value);
+            }
+        };
+    }
+
+    /******************************
+     * gemm kernel implementation *
+     ******************************/
+
+    namespace detail
+    {
+        inline std::ptrdiff_t gemm_offset(std::size_t i, std::ptrdiff_t stride)
+        {
+            return static_cast<std::ptrdiff_t>(i) * stride;
+        }
+
+        // Copies the mc x kc block of A into panels of mr rows, each of them
+        // stored column by column and padded with zeros.
+        template <class T>
+        inline void gemm_pack_a(std::size_t mc, std::size_t kc, const T* a, std::ptrdiff_t rs, std::ptrdiff_t cs, T* dst)
+        {
+            constexpr std::size_t mr = gemm_traits<T>::mr;
+            for (std::size_t i = 0; i < mc; i += mr)
+            {
+                std::size_t rows = (std::min)(mr, mc - i);
+                for (std::size_t p = 0; p < kc; ++p)
+                {
+                    const T* src = a + gemm_offset(i, rs) + gemm_offset(p, cs);
+                    for (std::size_t r = 0; r < mr; ++r)
+                    {
+                        *dst++ = r < rows ? src[gemm_offset(r, rs)] : T(0);
+                    }
+                }
+            }
+        }
+
+        // Copies the kc x nc panel of B into panels of nr columns, each of them
+        // stored row by row and padded with zeros.
+        template <class T>
+        inline void gemm_pack_b(std::size_t kc, std::size_t nc, const T* b, std::ptrdiff_t rs, std::ptrdiff_t cs, T* dst)
+        {
+            constexpr std::size_t nr = gemm_traits<T>::nb * gemm_traits<T>::batch_size;
+            for (std::size_t j = 0; j < nc; j += nr)
+            {
+                std::size_t cols = (std::min)(nr, nc - j);
+                for (std::size_t p = 0; p < kc; ++p)
+                {
+                    const T* src = b + gemm_offset(p, rs) + gemm_offset(j, cs);
+                    for (std::size_t c = 0; c < nr; ++c)
+                    {
+                        *dst++ = c < cols ? src[gemm_offset(c, cs)] : T(0);
+                    }
+                }
+            }
+        }
+
+        // Computes the mr x nr tile of the product of a packed panel of A by
+        // a packed panel of B in registers, and stores (or adds) its top left
+        // rows x cols part to c.
+        template <class T>
+        inline void gemm_micro_kernel(std::size_t kc, const T* a, const T* b, T* c, std::ptrdiff_t rs, std::ptrdiff_t cs,
+                                      std::size_t rows, std::size_t cols, bool accumulate)
+        {
+            using traits = gemm_traits<T>;
+            using batch_type = typename traits::batch_type;
+            constexpr std::size_t mr = traits::mr;
+            constexpr std::size_t nb = traits::nb;
+            constexpr std::size_t batch_size = traits::batch_size;
+            constexpr std::size_t nr = nb * batch_size;
+
+            std::array<batch_type, mr * nb> acc;
+            acc.fill(traits::broadcast(T(0)));
+            for (std::size_t p = 0; p < kc; ++p, a += mr, b += nr)
+            {
+                std::array<batch_type, nb> bv;
+                for (std::size_t j = 0; j < nb; ++j)
+                {
+                    bv[j] = traits::load(b + j * batch_size);
+                }
+                for (std::size_t i = 0; i < mr; ++i)
+                {
+                    batch_type av = traits::broadcast(a[i]);
+                    for (std::size_t j = 0; j < nb; ++j)
+                    {
+                        acc[i * nb + j] += av * bv[j];
+                    }
+                }
+            }
+
+            std::array<T, mr * nr> tile;
+            for (std::size_t i = 0; i < mr; ++i)
+            {
+                for (std::size_t j = 0; j < nb; ++j)
+                {
+                    traits::store(tile.data() + i * nr + j * batch_size, acc[i * nb + j]);
+                }
+            }
+            for (std::size_t i = 0; i < rows; ++i)
+            {
+                T* dst = c + gemm_offset(i, rs);
+                for (std::size_t j = 0; j < cols; ++j)
+                {
+                    T& res = dst[gemm_offset(j, cs)];
+                    res = accumulate ? res + tile[i * nr + j] : tile[i * nr + j];
+                }
+            }
+        }
+
+        // Matrix-vector product, the packed kernel would waste most of its
+        // tile on a single column.
+        template <class T>
+        inline void gemv(std::size_t m, std::size_t k,
+                         const T* a, std::ptrdiff_t a_rs, std::ptrdiff_t a_cs,
+                         const T* b, std::ptrdiff_t b_rs,
+                         T* c, std::ptrdiff_t c_rs, bool accumulate, bool parallel)
+        {
+            auto run_rows = [&](std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    const T* row = a + gemm_offset(i, a_rs);
+                    T res = T(0);
+                    for (std::size_t p = 0; p < k; ++p)
+                    {
+                        res += row[gemm_offset(p, a_cs)] * b[gemm_offset(p, b_rs)];
+                    }
+                    T& dst = c[gemm_offset(i, c_rs)];
+                    dst = accumulate ? dst + res : res;
+                }
+            };
+            if (parallel && m > 1)
+            {
+                parallel_for(std::size_t(0), m, std::size_t(1), run_rows);
+            }
+            else
+            {
+                run_rows(std::size_t(0), m);
+            }
+        }
+
+        /**
+         * Computes C = A * B, or C += A * B if accumulate is true, where A is
+         * a m x k matrix, B a k x n matrix and C a m x n matrix, each of them
+         * given by a pointer to its first element and its row and column
+         * strides. A and B are packed block by block so that any strides,
+         * including the ones of transposed and broadcast operands, are
+         * supported. When parallel is true, the blocks of rows of C are
+         * split among the workers.
+         */
+        template <class T>
+        inline void gemm(std::size_t m, std::size_t n, std::size_t k,
+                         const T* a, std::ptrdiff_t a_rs, std::ptrdiff_t a_cs,
+                         const T* b, std::ptrdiff_t b_rs, std::ptrdiff_t b_cs,
+                         T* c, std::ptrdiff_t c_rs, std::ptrdiff_t c_cs,
+                         bool accumulate, bool parallel)
+        {
+            if (m == 0 || n == 0)
+            {
+                return;
+            }
+            if (n == 1)
+            {
+                gemv(m, k, a, a_rs, a_cs, b, b_rs, c, c_rs, accumulate, parallel);
+                return;
+            }
+            if (m == 1)
+            {
+                // C^T = B^T * A^T
+                gemv(n, k, b, b_cs, b_rs, a, a_cs, c, c_cs, accumulate, parallel);
+                return;
+            }
+            if (k == 0)
+            {
+                if (!accumulate)
+                {
+                    for (std::size_t i = 0; i < m; ++i)
+                    {
+                        for (std::size_t j = 0; j < n; ++j)
+                        {
+                            c[gemm_offset(i, c_rs) + gemm_offset(j, c_cs)] = T(0);
+                        }
+                    }
+                }
+                return;
+            }
+
+            constexpr std::size_t mr = gemm_traits<T>::mr;
+            constexpr std::size_t nr = gemm_traits<T>::nb * gemm_traits<T>::batch_size;
+
+            std::size_t mc_max = gemm_mc;
+            if (parallel)
+            {
+                // Leaves at least one block of rows per worker
+                std::size_t n_workers = parallel_concurrency();
+                std::size_t rows_per_worker = (m + n_workers - 1) / n_workers;
+                mc_max = (std::min)(mc_max, (rows_per_worker + mr - 1) / mr * mr);
+            }
+            std::size_t n_blocks = (m + mc_max - 1) / mc_max;
+            std::size_t nc_max = (std::min)(gemm_nc, n);
+            std::size_t kc_max = (std::min)(gemm_kc, k);
+            uvector<T> b_pack(kc_max * ((nc_max + nr - 1) / nr * nr));
+
+            for (std::size_t jc = 0; jc < n; jc += nc_max)
+            {
+                std::size_t nc = (std::min)(nc_max, n - jc);
+                for (std::size_t pc = 0; pc < k; pc += kc_max)
+                {
+                    std::size_t kc = (std::min)(kc_max, k - pc);
+                    bool acc_block = accumulate || pc != 0;
+                    gemm_pack_b(kc, nc, b + gemm_offset(pc, b_rs) + gemm_offset(jc, b_cs), b_rs, b_cs, b_pack.data());
+
+                    auto run_blocks = [&](std::size_t first, std::size_t last) {
+                        uvector<T> a_pack(((mc_max + mr - 1) / mr * mr) * kc);
+                        for (std::size_t block = first; block < last; ++block)
+                        {
+                            std::size_t ic = block * mc_max;
+                            std::size_t mc = (std::min)(mc_max, m - ic);
+                            gemm_pack_a(mc, kc, a + gemm_offset(ic, a_rs) + gemm_offset(pc, a_cs), a_rs, a_cs, a_pack.data());
+                            for (std::size_t jr = 0; jr < nc; jr += nr)
+                            {
+                                for (std::size_t ir = 0; ir < mc; ir += mr)
+                                {
+                                    gemm_micro_kernel(kc, a_pack.data() + ir * kc, b_pack.data() + jr * kc,
+                                                      c + gemm_offset(ic + ir, c_rs) + gemm_offset(jc + jr, c_cs), c_rs, c_cs,
+                                                      (std::min)(mr, mc - ir), (std::min)(nr, nc - jr), acc_block);
+                                }
+                            }
+                        }
+                    };
+
+                    if (parallel && n_blocks > 1)
+                    {
+                        parallel_for(std::size_t(0), n_blocks, std::size_t(1), run_blocks);
+                    }
+                    else
+                    {
+                        run_blocks(std::size_t(0), n_blocks);
+                    }
+                }
+            }
+        }
+    }
+
+    /*************************************
+     * contraction engine implementation *
+     *************************************/
+
+    namespace detail
+    {
+        template <class E1, class E2>
+        using product_value_type_t = std::common_type_t<typename E1::value_type, typename E2::value_type>;
+
+        template <class T>
+        using product_result_t = xarray<T, layout_type::row_major>;
+
+        // Operand of a contraction: a strided block of memory whose axes are
+        // labelled, axes with the same label being contracted or batched.
+        template <class T>
+        struct contraction_operand
+        {
+            const T* data;
+            dynamic_shape<std::size_t> shape;
+            dynamic_shape<std::ptrdiff_t> strides;
+            dynamic_shape<std::size_t> labels;
+        };
+
+        // Expressions exposing their data and strides are read in place, the
+        // other ones are evaluated in a temporary of the common value type.
+        template <class T, class E>
+        inline const E& strided_argument(const E& e, std::true_type)
+        {
+            return e;
+        }
+
+        template <class T, class E>
+        inline product_result_t<T> strided_argument(const E& e, std::false_type)
+        {
+            return product_result_t<T>(e);
+        }
+
+        template <class T, class E>
+        inline decltype(auto) strided_argument(const E& e)
+        {
+            using is_strided = xtl::conjunction<has_strided_rows<E>, std::is_same<typename E::value_type, T>>;
+            return strided_argument<T>(e, is_strided());
+        }
+
+        template <class T, class E>
+        inline contraction_operand<T> make_contraction_operand(const E& e)
+        {
+            std::size_t dim = e.dimension();
+            contraction_operand<T> res;
+            res.data = e.data() + e.data_offset();
+            res.shape = xtl::forward_sequence<dynamic_shape<std::size_t>>(e.shape());
+            res.strides.resize(dim);
+            res.labels.resize(dim);
+            for (std::size_t i = 0; i < dim; ++i)
+            {
+                res.strides[i] = static_cast<std::ptrdiff_t>(e.strides()[i]);
+                res.labels[i] = i;
+            }
+            return res;
+        }
+
+        template <class T>
+        inline std::size_t find_label(const contraction_operand<T>& op, std::size_t label)
+        {
+            return static_cast<std::size_t>(std::find(op.labels.cbegin(), op.labels.cend(), label) - op.labels.cbegin());
+        }
+
+        // Repeated labels in an operand select its diagonal, which is the
+        // axis whose stride is the sum of the strides of the repeated axes.
+        template <class T>
+        inline void merge_repeated_labels(contraction_operand<T>& op)
+        {
+            std::size_t i = 0;
+            while (i < op.labels.size())
+            {
+                std::size_t j = static_cast<std::size_t>(std::find(op.labels.cbegin(), op.labels.cbegin() + std::ptrdiff_t(i), op.labels[i]) - op.labels.cbegin());
+                if (j == i)
+                {
+                    ++i;
+                    continue;
+                }
+                if (op.shape[j] != op.shape[i])
+                {
+                    throw std::runtime_error("Repeated subscripts of an operand must have the same extent.");
+                }
+                op.strides[j] += op.strides[i];
+                op.labels.erase(op.labels.cbegin() + std::ptrdiff_t(i));
+                op.shape.erase(op.shape.cbegin() + std::ptrdiff_t(i));
+                op.strides.erase(op.strides.cbegin() + std::ptrdiff_t(i));
+            }
+        }
+
+        struct contraction_axis
+        {
+            std::size_t extent;
+            std::ptrdiff_t a_stride;
+            std::ptrdiff_t b_stride;
+            std::ptrdiff_t c_stride;
+        };
+
+        using contraction_axes = std::vector<contraction_axis>;
+
+        // Drops the axes of extent 1 and merges the adjacent axes that the
+        // three operands step through as a single one.
+        inline contraction_axes collapse_contraction_axes(const contraction_axes& axes)
+        {
+            contraction_axes res;
+            for (const auto& axis : axes)
+            {
+                if (axis.extent == 1)
+                {
+                    continue;
+                }
+                if (!res.empty())
+                {
+                    contraction_axis& last = res.back();
+                    std::ptrdiff_t extent = static_cast<std::ptrdiff_t>(axis.extent);
+                    if (last.a_stride == axis.a_stride * extent && last.b_stride == axis.b_stride * extent &&
+                        last.c_stride == axis.c_stride * extent)
+                    {
+                        last.extent *= axis.extent;
+                        last.a_stride = axis.a_stride;
+                        last.b_stride = axis.b_stride;
+                        last.c_stride = axis.c_stride;
+                        continue;
+                    }
+                }
+                res.push_back(axis);
+            }
+            return res;
+        }
+
+        // Removes the innermost axis of a group, which becomes a dimension of
+        // the matrix product. An empty group is a dimension of extent 1.
+        inline contraction_axis pop_contraction_axis(contraction_axes& axes)
+        {
+            if (axes.empty())
+            {
+                return contraction_axis{1, 0, 0, 0};
+            }
+            contraction_axis res = axes.back();
+            axes.pop_back();
+            return res;
+        }
+
+        inline std::size_t contraction_size(const contraction_axes& axes)
+        {
+            std::size_t res = 1;
+            for (const auto& axis : axes)
+            {
+                res *= axis.extent;
+            }
+            return res;
+        }
+
+        inline void contraction_offsets(const contraction_axes& axes, std::size_t index,
+                                        std::ptrdiff_t& a, std::ptrdiff_t& b, std::ptrdiff_t& c)
+        {
+            for (std::size_t i = axes.size(); i != 0; --i)
+            {
+                const contraction_axis& axis = axes[i - 1];
+                std::size_t idx = index % axis.extent;
+                index /= axis.extent;
+                a += gemm_offset(idx, axis.a_stride);
+                b += gemm_offset(idx, axis.b_stride);
+                c += gemm_offset(idx, axis.c_stride);
+            }
+        }
+
+        /**
+         * Computes the contraction of a and b whose result has the given
+         * labels. The labels shared by a, b and the result are batched, the
+         * labels of the result found in a single operand are kept, and the
+         * labels missing in the result are summed over. The innermost axes of
+         * these groups are computed as a matrix product, the remaining ones
+         * are looped over, the independent loops being split among the
+         * workers.
+         */
+        template <class T>
+        inline product_result_t<T> contract(contraction_operand<T> a, contraction_operand<T> b,
+                                            const dynamic_shape<std::size_t>& labels)
+        {
+            merge_repeated_labels(a);
+            merge_repeated_labels(b);
+
+            std::size_t a_dim = a.labels.size();
+            std::size_t b_dim = b.labels.size();
+            std::size_t dim = labels.size();
+
+            dynamic_shape<std::size_t> shape(dim);
+            for (std::size_t i = 0; i < dim; ++i)
+            {
+                if (std::find(labels.cbegin(), labels.cbegin() + std::ptrdiff_t(i), labels[i]) != labels.cbegin() + std::ptrdiff_t(i))
+                {
+                    throw std::runtime_error("Repeated subscript in the output of a contraction.");
+                }
+                std::size_t ia = find_label(a, labels[i]);
+                std::size_t ib = find_label(b, labels[i]);
+                if (ia == a_dim && ib == b_dim)
+                {
+                    throw std::runtime_error("Output subscript of a contraction not found in its operands.");
+                }
+                if (ia != a_dim && ib != b_dim && a.shape[ia] != b.shape[ib])
+                {
+                    throw std::runtime_error("Mismatched extents for a batched subscript.");
+                }
+                shape[i] = ia != a_dim ? a.shape[ia] : b.shape[ib];
+            }
+
+            product_result_t<T> res;
+            res.resize(shape);
+
+            contraction_axes batch_axes, m_axes, n_axes, k_axes;
+            for (std::size_t i = 0; i < dim; ++i)
+            {
+                std::size_t ia = find_label(a, labels[i]);
+                std::size_t ib = find_label(b, labels[i]);
+                contraction_axis axis = {shape[i],
+                                         ia != a_dim ? a.strides[ia] : 0,
+                                         ib != b_dim ? b.strides[ib] : 0,
+                                         static_cast<std::ptrdiff_t>(res.strides()[i])};
+                if (ia != a_dim && ib != b_dim)
+                {
+                    batch_axes.push_back(axis);
+                }
+                else if (ia != a_dim)
+                {
+                    m_axes.push_back(axis);
+                }
+                else
+                {
+                    n_axes.push_back(axis);
+                }
+            }
+            for (std::size_t ia = 0; ia < a_dim; ++ia)
+            {
+                if (std::find(labels.cbegin(), labels.cend(), a.labels[ia]) == labels.cend())
+                {
+                    std::size_t ib = find_label(b, a.labels[ia]);
+                    if (ib != b_dim && a.shape[ia] != b.shape[ib])
+                    {
+                        throw std::runtime_error("Mismatched extents for a contracted subscript.");
+                    }
+                    k_axes.push_back({a.shape[ia], a.strides[ia], ib != b_dim ? b.strides[ib] : 0, 0});
+                }
+            }
+            for (std::size_t ib = 0; ib < b_dim; ++ib)
+            {
+                if (std::find(labels.cbegin(), labels.cend(), b.labels[ib]) == labels.cend() &&
+                    find_label(a, b.labels[ib]) == a_dim)
+                {
+                    k_axes.push_back({b.shape[ib], 0, b.strides[ib], 0});
+                }
+            }
+
+            if (res.size() == 0)
+            {
+                return res;
+            }
+            std::size_t k_size = contraction_size(k_axes);
+            if (k_size == 0)
+            {
+                std::fill(res.begin(), res.end(), T(0));
+                return res;
+            }
+
+            batch_axes = collapse_contraction_axes(batch_axes);
+            m_axes = collapse_contraction_axes(m_axes);
+            n_axes = collapse_contraction_axes(n_axes);
+            k_axes = collapse_contraction_axes(k_axes);
+            contraction_axis m = pop_contraction_axis(m_axes);
+            contraction_axis n = pop_contraction_axis(n_axes);
+            contraction_axis k = pop_contraction_axis(k_axes);
+
+            contraction_axes outer_axes = std::move(batch_axes);
+            outer_axes.insert(outer_axes.end(), m_axes.cbegin(), m_axes.cend());
+            outer_axes.insert(outer_axes.end(), n_axes.cbegin(), n_axes.cend());
+            std::size_t outer_size = contraction_size(outer_axes);
+            std::size_t inner_size = contraction_size(k_axes);
+
+            bool parallel = parallel_enabled(res.size() * k_size);
+            bool outer_parallel = parallel && outer_size > 1;
+            bool inner_parallel = parallel && !outer_parallel;
+            T* c = res.data();
+            auto run_outer = [&](std::size_t first, std::size_t last) {
+                for (std::size_t o = first; o < last; ++o)
+                {
+                    std::ptrdiff_t oa = 0, ob = 0, oc = 0;
+                    contraction_offsets(outer_axes, o, oa, ob, oc);
+                    for (std::size_t r = 0; r < inner_size; ++r)
+                    {
+                        std::ptrdiff_t ra = oa, rb = ob, rc = oc;
+                        contraction_offsets(k_axes, r, ra, rb, rc);
+                        gemm(m.extent, n.extent, k.extent,
+                             a.data + ra, m.a_stride, k.a_stride,
+                             b.data + rb, k.b_stride, n.b_stride,
+                             c + rc, m.c_stride, n.c_stride,
+                             r != 0, inner_parallel);
+                    }
+                }
+            };
+            if (outer_parallel)
+            {
+                parallel_for(std::size_t(0), outer_size, std::size_t(1), run_outer);
+            }
+            else
+            {
+                run_outer(std::size_t(0), outer_size);
+            }
+            return res;
+        }
+
+        // The operand of a single operand contraction is contracted with the
+        // scalar 1.
+        template <class T>
+        inline contraction_operand<T> contraction_unit(const T& one)
+        {
+            contraction_operand<T> res;
+            res.data = &one;
+            return res;
+        }
+
+        inline dynamic_shape<std::size_t> contraction_labels(const std::string& subscripts)
+        {
+            dynamic_shape<std::size_t> res(subscripts.size());
+            std::transform(subscripts.cbegin(), subscripts.cend(), res.begin(),
+                           [](char c) { return static_cast<std::size_t>(static_cast<unsigned char>(c)); });
+            return res;
+        }
+
+        // Splits einsum subscripts into the terms of the operands and the
+        // term of the result, which is made of the subscripts appearing once
+        // in alphabetical order when it is not specified.
+        inline std::vector<std::string> parse_einsum(const std::string& subscripts, std::size_t n_operands)
+        {
+            std::string spec;
+            std::copy_if(subscripts.cbegin(), subscripts.cend(), std::back_inserter(spec), [](char c) { return c != ' '; });
+            if (spec.find('.') != std::string::npos)
+            {
+                throw std::runtime_error("Ellipsis is not supported in einsum subscripts.");
+            }
+
+            std::size_t arrow = spec.find("->");
+            std::string inputs = spec.substr(0, arrow);
+            std::vector<std::string> res;
+            std::size_t first = 0;
+            while (true)
+            {
+                std::size_t comma = inputs.find(',', first);
+                res.push_back(inputs.substr(first, comma == std::string::npos ? std::string::npos : comma - first));
+                if (comma == std::string::npos)
+                {
+                    break;
+                }
+                first = comma + 1;
+            }
+            if (res.size() != n_operands)
+            {
+                throw std::runtime_error("Number of einsum terms does not match the number of operands.");
+            }
+
+            std::string output;
+            if (arrow != std::string::npos)
+            {
+                output = spec.substr(arrow + 2);
+            }
+            else
+            {
+                std::string all_labels = inputs;
+                all_labels.erase(std::remove(all_labels.begin(), all_labels.end(), ','), all_labels.end());
+                std::sort(all_labels.begin(), all_labels.end());
+                for (std::size_t i = 0; i < all_labels.size(); ++i)
+                {
+                    if (std::count(all_labels.cbegin(), all_labels.cend(), all_labels[i]) == 1)
+                    {
+                        output.push_back(all_labels[i]);
+                    }
+                }
+            }
+            res.push_back(output);
+
+            for (const auto& term : res)
+            {
+                auto is_label = [](char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); };
+                if (!std::all_of(term.cbegin(), term.cend(), is_label))
+                {
+                    throw std::runtime_error("Invalid einsum subscripts: " + subscripts);
+                }
+            }
+            return res;
+        }
+
+        template <class T>
+        inline void set_contraction_labels(contraction_operand<T>& op, const std::string& term)
+        {
+            if (term.size() != op.shape.size())
+            {
+                throw std::runtime_error("Number of einsum subscripts does not match the dimension of its operand.");
+            }
+            op.labels = contraction_labels(term);
+        }
+
+        template <class T, class A1, class A2>
+        inline product_result_t<T> tensordot_impl(contraction_operand<T> a, contraction_operand<T> b,
+                                                  const A1& axes1, const A2& axes2)
+        {
+            std::size_t a_dim = a.shape.size();
+            std::size_t b_dim = b.shape.size();
+            if (axes1.size() != axes2.size())
+            {
+                throw std::runtime_error("tensordot: the axes of both operands must have the same length.");
+            }
+            // The axes of a are labelled 0 ... a_dim - 1, the axes of b
+            // a_dim ... a_dim + b_dim - 1 unless they are contracted.
+            for (std::size_t i = 0; i < b_dim; ++i)
+            {
+                b.labels[i] = a_dim + i;
+            }
+            auto it2 = axes2.begin();
+            for (auto it1 = axes1.begin(); it1 != axes1.end(); ++it1, ++it2)
+            {
+                std::size_t ax1 = static_cast<std::size_t>(*it1);
+                std::size_t ax2 = static_cast<std::size_t>(*it2);
+                if (ax1 >= a_dim || ax2 >= b_dim)
+                {
+                    throw std::runtime_error("tensordot: axis out of bounds.");
+                }
+                if (a.shape[ax1] != b.shape[ax2])
+                {
+                    throw std::runtime_error("tensordot: contracted axes must have the same extent.");
+                }
+                b.labels[ax2] = ax1;
+            }
+            dynamic_shape<std::size_t> labels;
+            for (std::size_t i = 0; i < a_dim; ++i)
+            {
+                if (find_label(b, i) == b_dim)
+                {
+                    labels.push_back(i);
+                }
+            }
+            for (std::size_t i = 0; i < b_dim; ++i)
+            {
+                if (b.labels[i] >= a_dim)
+                {
+                    labels.push_back(b.labels[i]);
+                }
+            }
+            return contract(std::move(a), std::move(b), labels);
+        }
+
+        // Products of fixed size containers, whose loop bounds are known at
+        // compile time so that the compiler fully unrolls small products.
+        template <std::size_t M, std::size_t K, std::size_t N, class A, class B, class C>
+        inline void fixed_gemm(const A& a, const B& b, C& c)
+        {
+            using value_type = typename C::value_type;
+            for (std::size_t i = 0; i < M; ++i)
+            {
+                for (std::size_t j = 0; j < N; ++j)
+                {
+                    c(i, j) = value_type(0);
+                }
+                for (std::size_t p = 0; p < K; ++p)
+                {
+                    value_type aip = a(i, p);
+                    for (std::size_t j = 0; j < N; ++j)
+                    {
+                        c(i, j) += aip * b(p, j);
+                    }
+                }
+            }
+        }
+
+        template <std::size_t M, std::size_t K, class A, class B, class C>
+        inline void fixed_gemv(const A& a, const B& b, C& c)
+        {
+            using value_type = typename C::value_type;
+            for (std::size_t i = 0; i < M; ++i)
+            {
+                value_type res = value_type(0);
+                for (std::size_t p = 0; p < K; ++p)
+                {
+                    res += a(i, p) * b(p);
+                }
+                c(i) = res;
+            }
+        }
+    }
+
+    /**************************
+     * product implementation *
+     **************************/
+
+    /**
+     * @defgroup xproduct Tensor products
+     */
+
+    /**
+     * @ingroup xproduct
+     * @brief Dot product of two expressions.
+     *
+     * Follows the semantic of numpy.dot: the product of two 1-D expressions
+     * is their inner product, a 0-D result, and the last axis of \a e1 is
+     * otherwise contracted with the only axis of \a e2 if it is 1-D, or its
+     * second to last axis. 2-D operands give their matrix product.
+     * Expressions exposing their data and strides are read in place, whatever
+     * their layout, the other ones are evaluated first.
+     * @param e1 the first operand
+     * @param e2 the second operand
+     * @return an xarray holding the result
+     */
+    template <class E1, class E2>
+    inline auto dot(const xexpression<E1>& e1, const xexpression<E2>& e2)
+    {
+        using value_type = detail::product_value_type_t<E1, E2>;
+        const auto& a = detail::strided_argument<value_type>(e1.derived_cast());
+        const auto& b = detail::strided_argument<value_type>(e2.derived_cast());
+        std::size_t a_dim = a.dimension();
+        std::size_t b_dim = b.dimension();
+        if (a_dim == 0 || b_dim == 0)
+        {
+            throw std::runtime_error("dot: the operands must have at least one dimension.");
+        }
+        std::array<std::size_t, 1> axes1 = {a_dim - 1};
+        std::array<std::size_t, 1> axes2 = {b_dim == 1 ? std::size_t(0) : b_dim - 2};
+        return detail::tensordot_impl(detail::make_contraction_operand<value_type>(a),
+                                      detail::make_contraction_operand<value_type>(b),
+                                      axes1, axes2);
+    }
+
+    /**
+     * @ingroup xproduct
+     * @brief Matrix product of two 2-D fixed containers, computed with loops
+     * whose bounds are known at compile time.
+     */
+    template <class T, std::size_t M, std::size_t K, std::size_t N, layout_type L1, layout_type L2, class Tag>
+    inline auto dot(const xfixed_container<T, fixed_shape<M, K>, L1, Tag>& a,
+                    const xfixed_container<T, fixed_shape<K, N>, L2, Tag>& b)
+    {
+        xfixed_container<T, fixed_shape<M, N>, L1, Tag> res;
+        detail::fixed_gemm<M, K, N>(a, b, res);
+        return res;
+    }
+
+    /**
+     * @ingroup xproduct
+     * @brief Product of a 2-D fixed container by a 1-D fixed container,
+     * computed with loops whose bounds are known at compile time.
+     */
+    template <class T, std::size_t M, std::size_t K, layout_type L1, layout_type L2, class Tag>
+    inline auto dot(const xfixed_container<T, fixed_shape<M, K>, L1, Tag>& a,
+                    const xfixed_container<T, fixed_shape<K>, L2, Tag>& b)
+    {
+        xfixed_container<T, fixed_shape<M>, L1, Tag> res;
+        detail::fixed_gemv<M, K>(a, b, res);
+        return res;
+    }
+
+    /**
+     * @ingroup xproduct
+     * @brief Outer product of two expressions.
+     *
+     * The operands are flattened, the result is the 2-D expression
+     * whose element (i, j) is the product of the i-th element of \a e1 by
+     * the j-th element of \a e2.
+     * @param e1 the first operand
+     * @param e2 the second operand
+     * @return an xarray holding the result
+     */
+    template <class E1, class E2>
+    inline auto outer(const xexpression<E1>& e1, const xexpression<E2>& e2)
+    {
+        using value_type = detail::product_value_type_t<E1, E2>;
+        const auto& a = detail::strided_argument<value_type>(e1.derived_cast());
+        const auto& b = detail::strided_argument<value_type>(e2.derived_cast());
+        std::array<std::size_t, 0> no_axes = {};
+        auto res = detail::tensordot_impl(detail::make_contraction_operand<value_type>(a),
+                                          detail::make_contraction_operand<value_type>(b),
+                                          no_axes, no_axes);
+        res.reshape(std::array<std::size_t, 2>({a.size(), b.size()}));
+        return res;
+    }
+
+    /**
+     * @ingroup xproduct
+     * @brief Matrix product of two expressions.
+     *
+     * Follows the semantic of numpy.matmul: the operands are stacks of
+     * matrices held by their two last axes, whose leading axes are
+     * broadcast. A 1-D operand is promoted to a matrix by prepending (for
+     * \a e1) or appending (for \a e2) an axis, which is removed from the
+     * result. The matrices of the stack are split among the workers.
+     * @param e1 the first operand
+     * @param e2 the second operand
+     * @return an xarray holding the result
+     */
+    template <class E1, class E2>
+    inline auto matmul(const xexpression<E1>& e1, const xexpression<E2>& e2)
+    {
+        using value_type = detail::product_value_type_t<E1, E2>;
+        const auto& da = detail::strided_argument<value_type>(e1.derived_cast());
+        const auto& db = detail::strided_argument<value_type>(e2.derived_cast());
+        auto a = detail::make_contraction_operand<value_type>(da);
+        auto b = detail::make_contraction_operand<value_type>(db);
+        std::size_t a_dim = a.shape.size();
+        std::size_t b_dim = b.shape.size();
+        if (a_dim == 0 || b_dim == 0)
+        {
+            throw std::runtime_error("matmul: the operands must have at least one dimension.");
+        }
+
+        // Labels: 0 for the rows of e1, 1 for the contracted axis, 2 for the
+        // columns of e2 and 3 + i for the i-th axis of the stack.
+        std::size_t a_batch = a_dim > 2 ? a_dim - 2 : 0;
+        std::size_t b_batch = b_dim > 2 ? b_dim - 2 : 0;
+        std::size_t n_batch = (std::max)(a_batch, b_batch);
+        for (std::size_t i = 0; i < a_batch; ++i)
+        {
+            a.labels[i] = 3 + n_batch - a_batch + i;
+        }
+        for (std::size_t i = 0; i < b_batch; ++i)
+        {
+            b.labels[i] = 3 + n_batch - b_batch + i;
+        }
+        if (a_dim == 1)
+        {
+            a.labels[0] = 1;
+        }
+        else
+        {
+            a.labels[a_dim - 2] = 0;
+            a.labels[a_dim - 1] = 1;
+        }
+        if (b_dim == 1)
+        {
+            b.labels[0] = 1;
+        }
+        else
+        {
+            b.labels[b_dim - 2] = 1;
+            b.labels[b_dim - 1] = 2;
+        }
+
+        // Broadcasts the axes of the stack
+        for (std::size_t i = 0; i < n_batch; ++i)
+        {
+            std::size_t ia = detail::find_label(a, 3 + i);
+            std::size_t ib = detail::find_label(b, 3 + i);
+            if (ia == a_dim || ib == b_dim || a.shape[ia] == b.shape[ib])
+            {
+                continue;
+            }
+            if (a.shape[ia] == 1)
+            {
+                a.shape[ia] = b.shape[ib];
+                a.strides[ia] = 0;
+            }
+            else if (b.shape[ib] == 1)
+            {
+                b.shape[ib] = a.shape[ia];
+                b.strides[ib] = 0;
+            }
+            else
+            {
+                throw std::runtime_error("matmul: the stacks of matrices cannot be broadcast.");
+            }
+        }
+        if (a.shape[detail::find_label(a, 1)] != b.shape[detail::find_label(b, 1)])
+        {
+            throw std::runtime_error("matmul: mismatched extents for the contracted axis.");
+        }
+
+        dynamic_shape<std::size_t> labels;
+        for (std::size_t i = 0; i < n_batch; ++i)
+        {
+            labels.push_back(3 + i);
+        }
+        if (a_dim > 1)
+        {
+            labels.push_back(0);
+        }
+        if (b_dim > 1)
+        {
+            labels.push_back(2);
+        }
+        return detail::contract(std::move(a), std::move(b), labels);
+    }
+
+    /**
+     * @ingroup xproduct
+     * @brief Matrix product of two 2-D fixed containers, computed with loops
+     * whose bounds are known at compile time.
+     */
+    template <class T, std::size_t M, std::size_t K, std::size_t N, layout_type L1, layout_type L2, class Tag>
+    inline auto matmul(const xfixed_container<T, fixed_shape<M, K>, L1, Tag>& a,
+                       const xfixed_container<T, fixed_shape<K, N>, L2, Tag>& b)
+    {
+        return dot(a, b);
+    }
+
+    /**
+     * @ingroup xproduct
+     * @brief Tensor product of two expressions over their \a naxes last
+     * (for \a e1) and first (for \a e2) axes.
+     * @param e1 the first operand
+     * @param e2 the second operand
+     * @param naxes the number of contracted axes
+     * @return an xarray whose axes are the remaining axes of \a e1 followed
+     * by the remaining axes of \a e2
+     */
+    template <class E1, class E2>
+    inline auto tensordot(const xexpression<E1>& e1, const xexpression<E2>& e2, std::size_t naxes)
+    {
+        using value_type = detail::product_value_type_t<E1, E2>;
+        const auto& a = detail::strided_argument<value_type>(e1.derived_cast());
+        const auto& b = detail::strided_argument<value_type>(e2.derived_cast());
+        if (naxes > a.dimension() || naxes > b.dimension())
+        {
+            throw std::runtime_error("tensordot: too many contracted axes.");
+        }
+        std::vector<std::size_t> axes1(naxes), axes2(naxes);
+        for (std::size_t i = 0; i < naxes; ++i)
+        {
+            axes1[i] = a.dimension() - naxes + i;
+            axes2[i] = i;
+        }
+        return detail::tensordot_impl(detail::make_contraction_operand<value_type>(a),
+                                      detail::make_contraction_operand<value_type>(b),
+                                      axes1, axes2);
+    }
+
+    /**
+     * @ingroup xproduct
+     * @brief Tensor product of two expressions over the given axes.
+     *
+     * The i-th axis of \a axes1 is contracted with the i-th axis of \a axes2.
+     * The contraction is computed as a batch of matrix products, with a
+     * cache blocked, vectorized and multithreaded kernel.
+     * @param e1 the first operand
+     * @param e2 the second operand
+     * @param axes1 the contracted axes of \a e1
+     * @param axes2 the contracted axes of \a e2
+     * @return an xarray whose axes are the remaining axes of \a e1 followed
+     * by the remaining axes of \a e2
+     */
+    template <class E1, class E2, class A1, class A2>
+    inline auto tensordot(const xexpression<E1>& e1, const xexpression<E2>& e2, const A1& axes1, const A2& axes2)
+    {
+        using value_type = detail::product_value_type_t<E1, E2>;
+        const auto& a = detail::strided_argument<value_type>(e1.derived_cast());
+        const auto& b = detail::strided_argument<value_type>(e2.derived_cast());
+        return detail::tensordot_impl(detail::make_contraction_operand<value_type>(a),
+                                      detail::make_contraction_operand<value_type>(b),
+                                      axes1, axes2);
+    }
+
+    template <class E1, class E2>
+    inline auto tensordot(const xexpression<E1>& e1, const xexpression<E2>& e2,
+                          std::initializer_list<std::size_t> axes1, std::initializer_list<std::size_t> axes2)
+    {
+        return tensordot(e1, e2, std::vector<std::size_t>(axes1), std::vector<std::size_t>(axes2));
+    }
+
+    /**
+     * @ingroup xproduct
+     * @brief Einstein summation over a single expression.
+     *
+     * Supports transpositions (``"ij->ji"``), diagonals (``"ii->i"``),
+     * traces (``"ii"``) and sums over axes (``"ij->i"``). When the output
+     * subscripts are omitted, they are the subscripts appearing once, in
+     * alphabetical order. Ellipsis is not supported.
+     * @param subscripts the subscripts of the operand and of the result
+     * @param e the operand
+     * @return an xarray holding the result
+     */
+    template <class E>
+    inline auto einsum(const std::string& subscripts, const xexpression<E>& e)
+    {
+        using value_type = typename E::value_type;
+        auto terms = detail::parse_einsum(subscripts, 1);
+        const auto& a = detail::strided_argument<value_type>(e.derived_cast());
+        auto op = detail::make_contraction_operand<value_type>(a);
+        detail::set_contraction_labels(op, terms[0]);
+        value_type one = value_type(1);
+        return detail::contract(std::move(op), detail::contraction_unit(one),
+                                detail::contraction_labels(terms[1]));
+    }
+
+    /**
+     * @ingroup xproduct
+     * @brief Einstein summation over two expressions.
+     *
+     * For instance ``"ij,jk->ik"`` is a matrix product, ``"bij,bjk->bik"`` a
+     * batched matrix product and ``"i,i"`` an inner product. Subscripts
+     * missing in the output are summed over, the computation is done as a
+     * batch of matrix products.
+     * @param subscripts the subscripts of the operands and of the result
+     * @param e1 the first operand
+     * @param e2 the second operand
+     * @return an xarray holding the result
+     */
+    template <class E1, class E2>
+    inline auto einsum(const std::string& subscripts, const xexpression<E1>& e1, const xexpression<E2>& e2)
+    {
+        using value_type = detail::product_value_type_t<E1, E2>;
+        auto terms = detail::parse_einsum(subscripts, 2);
+        const auto& a = detail::strided_argument<value_type>(e1.derived_cast());
+        const auto& b = detail::strided_argument<value_type>(e2.derived_cast());
+        auto op1 = detail::make_contraction_operand<value_type>(a);
+        auto op2 = detail::make_contraction_operand<value_type>(b);
+        detail::set_contraction_labels(op1, terms[0]);
+        detail::set_contraction_labels(op2, terms[1]);
+        return detail::contract(std::move(op1), std::move(op2),
+                                detail::contraction_labels(terms[2]));
+    }
+}
+
+#endif
@@ -13,7 +13,12 @@
 #ifndef XTENSOR_RANDOM_HPP
 #define XTENSOR_RANDOM_HPP
 
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <functional>
+#include <iterator>
+#include <limits>
 #include <random>
 #include <utility>
 
@@ -36,6 +41,66 @@ namespace xt
         default_engine_type& get_default_random_engine();
         void seed(seed_type seed);
 
+        /**
+         * @class philox_engine
+         * @brief Counter-based random number engine.
+         *
+         * Implements the Philox4x32-10 generator of Salmon et al., "Parallel
+         * random numbers: as easy as 1, 2, 3" (2011). Its state is a 64-bit
+         * key, set by the seed, and a 64-bit counter: the block of four
+         * 32-bit numbers of a counter is a function of the key and of this
+         * counter only, so that any block can be computed independently.
+         *
+         * The engine satisfies the requirements of a uniform random bit
+         * generator and can be used sequentially like the standard engines.
+         * When passed to rand, randint or randn, it reserves a block per
+         * element instead: the element of flat row-major index i is computed
+         * from the block of counter c + i, where c is the counter of the
+         * engine when the function is called. Such generators can be
+         * evaluated in any order, and are assigned in parallel with results
+         * independent of the number of threads.
+         */
+        class philox_engine
+        {
+        public:
+
+            using result_type = std::uint32_t;
+            using key_type = std::array<std::uint32_t, 2>;
+            using block_type = std::array<std::uint32_t, 4>;
+
+            static constexpr std::uint64_t default_seed = 20111115u;
+
+            explicit philox_engine(std::uint64_t seed = default_seed) noexcept;
+
+            void seed(std::uint64_t seed = default_seed) noexcept;
+
+            static constexpr result_type min() noexcept
+            {
+                return (std::numeric_limits<result_type>::min)();
+            }
+
+            static constexpr result_type max() noexcept
+            {
+                return (std::numeric_limits<result_type>::max)();
+            }
+
+            result_type operator()() noexcept;
+            void discard(unsigned long long z) noexcept;
+
+            block_type block(std::uint64_t counter) const noexcept;
+
+            const key_type& key() const noexcept;
+            std::uint64_t counter() const noexcept;
+            void set_counter(std::uint64_t counter) noexcept;
+
+        private:
+
+            key_type m_key;
+            std::uint64_t m_counter;
+            block_type m_block;
+            std::size_t m_index;
+        };
+
         template <class T, class S, class E = random::default_engine_type>
         auto rand(const S& shape, T lower = 0, T upper = 1,
                   E& engine = random::get_default_random_engine());
@@ -110,6 +175,151 @@ namespace xt
         private:
             std::function<value_type()> m_generator;
         };
+
+        // The generator draws from a shared engine: elements must be
+        // computed one after the other.
+        template <class T, class R, class S>
+        struct forbid_parallel_assign<xgenerator<random_impl<T>, R, S>> : std::true_type
+        {
+        };
+
+        // Uniform number in [0, 1) made of the high bits of (hi, lo).
+        template <class T>
+        inline T unit_real(std::uint32_t hi, std::uint32_t lo) noexcept
+        {
+            constexpr int digits = std::numeric_limits<T>::digits < 53 ? std::numeric_limits<T>::digits : 53;
+            std::uint64_t bits = ((std::uint64_t(hi) << 32) | lo) >> (64 - digits);
+            return static_cast<T>(bits) * (T(1) / static_cast<T>(std::uint64_t(1) << digits));
+        }
+
+        // Maps a block of a philox_engine to a number of the distribution D.
+        template <class D>
+        struct counter_distribution;
+
+        template <class T>
+        struct counter_distribution<std::uniform_real_distribution<T>>
+        {
+            static T value(const std::uniform_real_distribution<T>& d, const random::philox_engine::block_type& b) noexcept
+            {
+                return d.a() + (d.b() - d.a()) * unit_real<T>(b[0], b[1]);
+            }
+        };
+
+        template <class T>
+        struct counter_distribution<std::uniform_int_distribution<T>>
+        {
+            static T value(const std::uniform_int_distribution<T>& d, const random::philox_engine::block_type& b) noexcept
+            {
+                // The bias of the modulo is at most range / 2^64
+                std::uint64_t range = static_cast<std::uint64_t>(d.b()) - static_cast<std::uint64_t>(d.a()) + 1u;
+                std::uint64_t x = (std::uint64_t(b[0]) << 32) | b[1];
+                return static_cast<T>(static_cast<std::uint64_t>(d.a()) + (range == 0 ? x : x % range));
+            }
+        };
+
+        // Box-Muller transform of two uniform numbers.
+        template <class T>
+        struct counter_distribution<std::normal_distribution<T>>
+        {
+            static T value(const std::normal_distribution<T>& d, const random::philox_engine::block_type& b) noexcept
+            {
+                T u1 = T(1) - unit_real<T>(b[0], b[1]);
+                T u2 = unit_real<T>(b[2], b[3]);
+                T radius = std::sqrt(T(-2) * std::log(u1));
+                return d.mean() + d.stddev() * radius * std::cos(T(2) * T(3.14159265358979323846) * u2);
+            }
+        };
+
+        template <class D>
+        class counter_random_impl
+        {
+        public:
+
+            using value_type = typename D::result_type;
+            using size_type = std::size_t;
+
+            template <class S>
+            counter_random_impl(const D& dist, const random::philox_engine& engine, const S& shape)
+                : m_dist(dist), m_engine(engine), m_counter(engine.counter()),
+                  m_strides(static_cast<size_type>(std::distance(std::begin(shape), std::end(shape))))
+            {
+                // Row-major strides, null along the broadcast dimensions
+                size_type stride = 1;
+                auto extent = std::end(shape);
+                for (auto it = m_strides.rbegin(); it != m_strides.rend(); ++it)
+                {
+                    size_type n = static_cast<size_type>(*(--extent));
+                    *it = n == 1 ? 0 : stride;
+                    stride *= n;
+                }
+            }
+
+            inline value_type operator()() const
+            {
+                size_type idx[1] = {0ul};
+                return access_impl(std::begin(idx), std::end(idx));
+            }
+
+            template <class... Args>
+            inline value_type operator()(Args... args) const
+            {
+                size_type idx[sizeof...(Args)] = {static_cast<size_type>(args)...};
+                return access_impl(std::begin(idx), std::end(idx));
+            }
+
+            template <class It>
+            inline value_type element(It first, It last) const
+            {
+                return access_impl(first, last);
+            }
+
+        private:
+
+            // The indices are matched with the trailing dimensions.
+            template <class It>
+            inline value_type access_impl(It first, It last) const
+            {
+                size_type n = static_cast<size_type>(std::distance(first, last));
+                size_type dim = m_strides.size();
+                if (n > dim)
+                {
+                    std::advance(first, static_cast<std::ptrdiff_t>(n - dim));
+                    n = dim;
+                }
+                std::uint64_t index = 0;
+                for (auto stride = m_strides.cend() - static_cast<std::ptrdiff_t>(n); first != last; ++first, ++stride)
+                {
+                    index += static_cast<std::uint64_t>(*first) * static_cast<std::uint64_t>(*stride);
+                }
+                return counter_distribution<D>::value(m_dist, m_engine.block(m_counter + index));
+            }
+
+            D m_dist;
+            random::philox_engine m_engine;
+            std::uint64_t m_counter;
+            svector<size_type, 4> m_strides;
+        };
+
+        template <class D, class E, class S>
+        inline auto make_random_generator(const D& dist, E& engine, const S& shape)
+        {
+            using value_type = typename D::result_type;
+            return make_xgenerator(random_impl<value_type>(std::bind(dist, std::ref(engine))), shape);
+        }
+
+        // Reserves one block of the engine per element of the generator.
+        template <class D, class S>
+        inline auto make_random_generator(const D& dist, random::philox_engine& engine, const S& shape)
+        {
+            std::uint64_t size = 1;
+            for (auto it = std::begin(shape); it != std::end(shape); ++it)
+            {
+                size *= static_cast<std::uint64_t>(*it);
+            }
+            counter_random_impl<D> f(dist, engine, shape);
+            engine.set_counter(engine.counter() + size);
+            return make_xgenerator(std::move(f), shape);
+        }
     }
 
     namespace random
@@ -132,11 +342,121 @@ namespace xt
             get_default_random_engine().seed(seed);
         }
 
+        /********************************
+         * philox_engine implementation *
+         ********************************/
+
+        /**
+         * Builds an engine with the key @p seed and the counter 0.
+         * @param seed The seed
+         */
+        inline philox_engine::philox_engine(std::uint64_t seed) noexcept
+            : m_key(), m_counter(0), m_block(), m_index(0)
+        {
+            this->seed(seed);
+        }
+
+        /**
+         * Sets the key of the engine to @p seed and resets its counter.
+         * @param seed The seed
+         */
+        inline void philox_engine::seed(std::uint64_t seed) noexcept
+        {
+            m_key = {static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)};
+            set_counter(0);
+        }
+
+        /**
+         * Returns the next number of the sequence, the blocks of the
+         * successive counters being read in order.
+         */
+        inline auto philox_engine::operator()() noexcept -> result_type
+        {
+            if (m_index == m_block.size())
+            {
+                m_block = block(m_counter++);
+                m_index = 0;
+            }
+            return m_block[m_index++];
+        }
+
+        /**
+         * Advances the sequence by @p z numbers.
+         */
+        inline void philox_engine::discard(unsigned long long z) noexcept
+        {
+            std::size_t remaining = m_block.size() - m_index;
+            if (z <= remaining)
+            {
+                m_index += static_cast<std::size_t>(z);
+                return;
+            }
+            z -= remaining;
+            set_counter(m_counter + static_cast<std::uint64_t>(z / m_block.size()));
+            m_block = block(m_counter++);
+            m_index = static_cast<std::size_t>(z % m_block.size());
+        }
+
+        /**
+         * Returns the block of four numbers of @p counter, ten rounds of
+         * the Philox4x32 bijection keyed by the seed.
+         */
+        inline auto philox_engine::block(std::uint64_t counter) const noexcept -> block_type
+        {
+            constexpr std::uint64_t multiplier_0 = 0xD2511F53u;
+            constexpr std::uint64_t multiplier_1 = 0xCD9E8D57u;
+            constexpr std::uint32_t weyl_0 = 0x9E3779B9u;
+            constexpr std::uint32_t weyl_1 = 0xBB67AE85u;
+
+            block_type ctr = {static_cast<std::uint32_t>(counter), static_cast<std::uint32_t>(counter >> 32), 0u, 0u};
+            key_type key = m_key;
+            for (std::size_t round = 0; round < 10; ++round)
+            {
+                if (round != 0)
+                {
+                    key[0] += weyl_0;
+                    key[1] += weyl_1;
+                }
+                std::uint64_t p0 = multiplier_0 * ctr[0];
+                std::uint64_t p1 = multiplier_1 * ctr[2];
+                ctr = {static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0], static_cast<std::uint32_t>(p1),
+                       static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1], static_cast<std::uint32_t>(p0)};
+            }
+            return ctr;
+        }
+
+        /**
+         * Returns the key of the engine.
+         */
+        inline auto philox_engine::key() const noexcept -> const key_type&
+        {
+            return m_key;
+        }
+
+        /**
+         * Returns the counter of the next block to generate.
+         */
+        inline std::uint64_t philox_engine::counter() const noexcept
+        {
+            return m_counter;
+        }
+
+        /**
+         * Sets the counter of the next block to generate to @p counter.
+         */
+        inline void philox_engine::set_counter(std::uint64_t counter) noexcept
+        {
+            m_counter = counter;
+            m_index = m_block.size();
+        }
+
         /**
          * xexpression with specified @p shape containing uniformly distributed random numbers
          * in the interval from @p lower to @p upper, excluding upper.
          *
          * Numbers are drawn from @c std::uniform_real_distribution.
+         * With a philox_engine, each element is computed from its index instead,
+         * and the expression can be evaluated in parallel.
          *
          * @param shape shape of resulting xexpression
          * @param lower lower bound
@@ -148,7 +468,7 @@ namespace xt
         inline auto rand(const S& shape, T lower, T upper, E& engine)
         {
             std::uniform_real_distribution<T> dist(lower, upper);
-            return detail::make_xgenerator(detail::random_impl<T>(std::bind(dist, std::ref(engine))), shape);
+            return detail::make_random_generator(dist, engine, shape);
         }
 
         /**
@@ -156,6 +476,8 @@ namespace xt
          * random integers in the interval from @p lower to @p upper, excluding upper.
          *
          * Numbers are drawn from @c std::uniform_int_distribution.
+         * With a philox_engine, each element is computed from its index instead,
+         * and the expression can be evaluated in parallel.
          *
          * @param shape shape of resulting xexpression
          * @param lower lower bound
@@ -167,7 +489,7 @@ namespace xt
         inline auto randint(const S& shape, T lower, T upper, E& engine)
         {
             std::uniform_int_distribution<T> dist(lower, upper - 1);
-            return detail::make_xgenerator(detail::random_impl<T>(std::bind(dist, std::ref(engine))), shape);
+            return detail::make_random_generator(dist, engine, shape);
         }
 
         /**
@@ -176,6 +498,8 @@ namespace xt
          * standard deviation @p std_dev.
          *
          * Numbers are drawn from @c std::normal_distribution.
+         * With a philox_engine, each element is computed from its index instead,
+         * and the expression can be evaluated in parallel.
          *
          * @param shape shape of resulting xexpression
          * @param mean mean of normal distribution
@@ -187,7 +511,7 @@ namespace xt
         inline auto randn(const S& shape, T mean, T std_dev, E& engine)
         {
             std::normal_distribution<T> dist(mean, std_dev);
-            return detail::make_xgenerator(detail::random_impl<T>(std::bind(dist, std::ref(engine))), shape);
+            return detail::make_random_generator(dist, engine, shape);
         }
 
 #ifdef X_OLD_CLANG
@@ -195,42 +519,42 @@ namespace xt
         inline auto rand(std::initializer_list<I> shape, T lower, T upper, E& engine)
         {
             std::uniform_real_distribution<T> dist(lower, upper);
-            return detail::make_xgenerator(detail::random_impl<T>(std::bind(dist, std::ref(engine))), shape);
+            return detail::make_random_generator(dist, engine, shape);
         }
 
         template <class T, class I, class E>
         inline auto randint(std::initializer_list<I> shape, T lower, T upper, E& engine)
         {
             std::uniform_int_distribution<T> dist(lower, upper - 1);
-            return detail::make_xgenerator(detail::random_impl<T>(std::bind(dist, std::ref(engine))), shape);
+            return detail::make_random_generator(dist, engine, shape);
         }
 
         template <class T, class I, class E>
         inline auto randn(std::initializer_list<I> shape, T mean, T std_dev, E& engine)
         {
             std::normal_distribution<T> dist(mean, std_dev);
-            return detail::make_xgenerator(detail::random_impl<T>(std::bind(dist, std::ref(engine))), shape);
+            return detail::make_random_generator(dist, engine, shape);
         }
 #else
         template <class T, class I, std::size_t L, class E>
         inline auto rand(const I (&shape)[L], T lower, T upper, E& engine)
         {
             std::uniform_real_distribution<T> dist(lower, upper);
-            return detail::make_xgenerator(detail::random_impl<T>(std::bind(dist, std::ref(engine))), shape);
+            return detail::make_random_generator(dist, engine, shape);
         }
 
         template <class T, class I, std::size_t L, class E>
         inline auto randint(const I (&shape)[L], T lower, T upper, E& engine)
         {
             std::uniform_int_distribution<T> dist(lower, upper - 1);
-            return detail::make_xgenerator(detail::random_impl<T>(std::bind(dist, std::ref(engine))), shape);
+            return detail::make_random_generator(dist, engine, shape);
         }
 
         template <class T, class I, std::size_t L, class E>
         inline auto randn(const I (&shape)[L], T mean, T std_dev, E& engine)
         {
             std::normal_distribution<T> dist(mean, std_dev);
-            return detail::make_xgenerator(detail::random_impl<T>(std::bind(dist, std::ref(engine))), shape);
+            return detail::make_random_generator(dist, engine, shape);
         }
 #endif
 
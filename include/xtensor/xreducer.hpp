@@ -10,7 +10,9 @@
 #define XTENSOR_REDUCER_HPP
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
+#include <functional>
 #include <initializer_list>
 #include <iterator>
 #include <stdexcept>
@@ -24,11 +26,14 @@
 #include <xtl/xfunctional.hpp>
 #include <xtl/xsequence.hpp>
 
+#include "xassign.hpp"
 #include "xbuilder.hpp"
 #include "xexpression.hpp"
 #include "xgenerator.hpp"
 #include "xiterable.hpp"
+#include "xparallel.hpp"
 #include "xreducer.hpp"
+#include "xtensor_simd.hpp"
 #include "xutils.hpp"
 
 namespace xt
@@ -76,6 +81,340 @@ namespace xt
         using type = xtensor<result_type, sizeof...(N) - NX, L>;
     };
 
+    /************************
+     * xreducer_simd_traits *
+     ************************/
+
+    /**
+     * @class xreducer_simd_traits
+     * @brief Traits class for reducing functors that can be applied on batches.
+     *
+     * Immediate reductions accumulate with xsimd batches when this traits
+     * is specialized for the reducing functor, which is then assumed to be
+     * associative. Specializations must provide the \c value_type the
+     * functor operates on, and a static \c apply method taking the functor
+     * and two batches.
+     *
+     * @tparam F the reducing functor type.
+     */
+    template <class F>
+    struct xreducer_simd_traits
+    {
+        static constexpr bool value = false;
+        using value_type = void;
+    };
+
+    template <class T>
+    struct xreducer_simd_traits<std::plus<T>>
+    {
+        static constexpr bool value = true;
+        using value_type = T;
+
+        template <class B>
+        static B apply(const std::plus<T>&, const B& b1, const B& b2)
+        {
+            return b1 + b2;
+        }
+    };
+
+    template <class T>
+    struct xreducer_simd_traits<std::multiplies<T>>
+    {
+        static constexpr bool value = true;
+        using value_type = T;
+
+        template <class B>
+        static B apply(const std::multiplies<T>&, const B& b1, const B& b2)
+        {
+            return b1 * b2;
+        }
+    };
+
+    namespace detail
+    {
+        // Elements of type T are reduced into a result of type R with batches
+        // of R: when T and R differ (e.g. the promoted sum of floats), the
+        // elements are converted before being reduced.
+        template <class F, class IF, class T, class R>
+        struct is_simd_reducer
+            : std::integral_constant<bool,
+                                     xreducer_simd_traits<F>::value &&
+                                         std::is_same<typename xreducer_simd_traits<F>::value_type, R>::value &&
+                                         std::is_same<IF, xtl::identity>::value &&
+                                         std::is_arithmetic<T>::value && !std::is_same<T, bool>::value &&
+                                         std::is_arithmetic<R>::value && !std::is_same<R, bool>::value>
+        {
+        };
+
+        // Lazy reducers over expressions providing batches are assigned by
+        // reducing these batches directly, see xreducer::assign_to.
+        template <class F, class CT>
+        struct is_simd_reducer_assignable
+        {
+            using xexpression_type = std::decay_t<CT>;
+            using value_type = typename xexpression_type::value_type;
+            using reduce_functor_type = typename std::decay_t<F>::reduce_functor_type;
+            using init_functor_type = typename std::decay_t<F>::init_functor_type;
+            using result_type = std::decay_t<decltype(std::declval<reduce_functor_type>()(
+                std::declval<init_functor_type>()(std::declval<value_type>()), std::declval<value_type>()))>;
+            static constexpr bool value = is_simd_reducer<reduce_functor_type, init_functor_type,
+                                                          value_type, result_type>::value &&
+                xsimd::simd_traits<value_type>::size > 1 &&
+                xexpression_type::contiguous_layout &&
+                !forbid_simd_assign<xexpression_type>::value;
+        };
+
+        constexpr std::size_t reducer_simd_accumulators = 4;
+
+        // Reduces the size (> 0) contiguous elements starting at first.
+        template <class R, class F, class IF, class It>
+        inline R reduce_contiguous(const F& f, const IF& init, It first, std::size_t size, std::false_type)
+        {
+            // for unknown reasons it's much faster to use a temporary variable and
+            // std::accumulate here -- probably some cache behavior
+            R tmp;
+            tmp = init(*first);
+            return std::accumulate(first + 1, first + std::ptrdiff_t(size), tmp, f);
+        }
+
+        // Reduces size (> 0) elements with independent batch accumulators, which
+        // hide the latency of the reducing operation and are merged and
+        // horizontally reduced at the end. load(i) returns the batch starting
+        // at the i-th element, element(i) the i-th element.
+        template <class T, class F, class L, class EL>
+        inline T reduce_batches(const F& f, std::size_t size, L&& load, EL&& element)
+        {
+            using traits = xreducer_simd_traits<F>;
+            using simd_type = xsimd::simd_type<T>;
+            constexpr std::size_t simd_size = xsimd::simd_traits<T>::size;
+            constexpr std::size_t n_acc = reducer_simd_accumulators;
+
+            std::size_t i = 0;
+            T res;
+            if (size >= n_acc * simd_size)
+            {
+                std::array<simd_type, n_acc> acc;
+                for (std::size_t k = 0; k < n_acc; ++k)
+                {
+                    acc[k] = load(k * simd_size);
+                }
+                for (i = n_acc * simd_size; i + n_acc * simd_size <= size; i += n_acc * simd_size)
+                {
+                    for (std::size_t k = 0; k < n_acc; ++k)
+                    {
+                        acc[k] = traits::apply(f, acc[k], load(i + k * simd_size));
+                    }
+                }
+                for (std::size_t k = 1; k < n_acc; ++k)
+                {
+                    acc[0] = traits::apply(f, acc[0], acc[k]);
+                }
+                for (; i + simd_size <= size; i += simd_size)
+                {
+                    acc[0] = traits::apply(f, acc[0], load(i));
+                }
+                std::array<T, simd_size> lanes;
+                xsimd::store_simd(lanes.data(), acc[0], unaligned_mode());
+                res = std::accumulate(lanes.cbegin() + 1, lanes.cend(), lanes[0], f);
+            }
+            else
+            {
+                res = element(0);
+                i = 1;
+            }
+            for (; i < size; ++i)
+            {
+                res = f(res, element(i));
+            }
+            return res;
+        }
+
+        template <class R, class T, class F, class L, class EL>
+        inline R reduce_converted_batches(const F& f, std::size_t size, L&& load, EL&& element, std::true_type)
+        {
+            return reduce_batches<R>(f, size, std::forward<L>(load), std::forward<EL>(element));
+        }
+
+        // Same as reduce_batches, except that load(i) and element(i) return
+        // elements of type T, which are converted to R by blocks before being
+        // reduced.
+        template <class R, class T, class F, class L, class EL>
+        inline R reduce_converted_batches(const F& f, std::size_t size, L&& load, EL&& element, std::false_type)
+        {
+            constexpr std::size_t simd_size = xsimd::simd_traits<T>::size;
+            // multiple of any batch size
+            constexpr std::size_t block_size = 512;
+
+            std::array<T, simd_size> lanes;
+            std::array<R, block_size> buffer;
+            auto cast = [](const T& v) { return static_cast<R>(v); };
+            R res = R();
+            for (std::size_t first = 0; first < size; first += block_size)
+            {
+                std::size_t n = (std::min)(block_size, size - first);
+                std::size_t j = 0;
+                for (; j + simd_size <= n; j += simd_size)
+                {
+                    xsimd::store_simd(lanes.data(), load(first + j), unaligned_mode());
+                    std::transform(lanes.cbegin(), lanes.cend(), buffer.begin() + std::ptrdiff_t(j), cast);
+                }
+                for (; j < n; ++j)
+                {
+                    buffer[j] = cast(element(first + j));
+                }
+                R partial = reduce_batches<R>(f, n,
+                                              [&buffer](std::size_t i) { return xsimd::load_simd(buffer.data() + i, unaligned_mode()); },
+                                              [&buffer](std::size_t i) { return buffer[i]; });
+                res = first == 0 ? partial : f(res, partial);
+            }
+            return res;
+        }
+
+        template <class R, class F, class IF, class T>
+        inline R reduce_contiguous(const F& f, const IF&, const T* first, std::size_t size, std::true_type)
+        {
+            return reduce_converted_batches<R, T>(f, size,
+                                                  [first](std::size_t i) { return xsimd::load_simd(first + i, unaligned_mode()); },
+                                                  [first](std::size_t i) { return first[i]; },
+                                                  std::is_same<T, R>());
+        }
+
+        // Loads the batch of R starting at src, converting its elements when
+        // T is not R.
+        template <class R, class T>
+        inline xsimd::simd_type<R> load_converted(const T* src, std::true_type)
+        {
+            return xsimd::load_simd(src, unaligned_mode());
+        }
+
+        template <class R, class T>
+        inline xsimd::simd_type<R> load_converted(const T* src, std::false_type)
+        {
+            std::array<R, xsimd::simd_traits<R>::size> buffer;
+            std::transform(src, src + buffer.size(), buffer.begin(), [](const T& v) { return static_cast<R>(v); });
+            return xsimd::load_simd(buffer.data(), unaligned_mode());
+        }
+
+        template <class R, class T>
+        inline xsimd::simd_type<R> load_converted(const T* src)
+        {
+            return load_converted<R>(src, std::is_same<T, R>());
+        }
+
+        // Reduces the sizeof...(I) + 1 elements starting at first, the number of
+        // elements being known at compile time.
+        template <class R, class F, class IF, class It>
+        inline R reduce_fixed(const F&, const IF& init, It first, std::index_sequence<>)
+        {
+            return static_cast<R>(init(*first));
+        }
+
+        template <class R, class F, class IF, class It, std::size_t... I>
+        inline R reduce_fixed(const F& f, const IF& init, It first, std::index_sequence<I...>)
+        {
+            R res = static_cast<R>(init(*first));
+            auto dummy = {(res = f(res, first[I + 1]))...};
+            (void) dummy;
+            return res;
+        }
+
+        // Reduces the n_rows rows of size elements starting at first and spaced
+        // by stride into dst. When merge is false, dst is overwritten.
+        template <class R, class F, class IF, class It, class O>
+        inline void reduce_strided(const F& f, const IF& init, It first, std::size_t n_rows, std::size_t stride,
+                                   O dst, std::size_t size, bool merge, std::false_type)
+        {
+            auto dst_last = dst + std::ptrdiff_t(size);
+            std::transform(dst, dst_last, first, dst,
+                           [merge, &init, &f](auto&& v1, auto&& v2) {
+                                return merge ?
+                                    f(v1, v2) :
+                                    // cast because return type of identity function is not upcasted
+                                    static_cast<R>(init(v2));
+                           });
+
+            for (std::size_t i = 1; i < n_rows; ++i)
+            {
+                first += std::ptrdiff_t(stride);
+                std::transform(dst, dst_last, first, dst, f);
+            }
+        }
+
+        // Accumulates N consecutive batches of each row in registers, so that
+        // dst is loaded and stored once.
+        template <std::size_t N, class F, class T, class R>
+        inline void reduce_strided_batches(const F& f, const T* first, std::size_t n_rows, std::size_t stride,
+                                           R* dst, bool merge)
+        {
+            using traits = xreducer_simd_traits<F>;
+            using simd_type = xsimd::simd_type<R>;
+            constexpr std::size_t simd_size = xsimd::simd_traits<R>::size;
+
+            std::array<simd_type, N> acc;
+            std::size_t row = 0;
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                acc[k] = merge ? xsimd::load_simd(dst + k * simd_size, unaligned_mode()) :
+                                 load_converted<R>(first + k * simd_size);
+            }
+            if (!merge)
+            {
+                first += stride;
+                row = 1;
+            }
+            for (; row < n_rows; ++row, first += stride)
+            {
+                for (std::size_t k = 0; k < N; ++k)
+                {
+                    acc[k] = traits::apply(f, acc[k], load_converted<R>(first + k * simd_size));
+                }
+            }
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                xsimd::store_simd(dst + k * simd_size, acc[k], unaligned_mode());
+            }
+        }
+
+        template <class R, class F, class IF, class T>
+        inline void reduce_strided(const F& f, const IF&, const T* first, std::size_t n_rows, std::size_t stride,
+                                   R* dst, std::size_t size, bool merge, std::true_type)
+        {
+            constexpr std::size_t simd_size = xsimd::simd_traits<R>::size;
+            constexpr std::size_t n_acc = reducer_simd_accumulators;
+
+            std::size_t j = 0;
+            for (; j + n_acc * simd_size <= size; j += n_acc * simd_size)
+            {
+                reduce_strided_batches<n_acc>(f, first + j, n_rows, stride, dst + j, merge);
+            }
+            for (; j + simd_size <= size; j += simd_size)
+            {
+                reduce_strided_batches<1>(f, first + j, n_rows, stride, dst + j, merge);
+            }
+            for (; j < size; ++j)
+            {
+                const T* src = first + j;
+                std::size_t row = 0;
+                R res;
+                if (merge)
+                {
+                    res = dst[j];
+                }
+                else
+                {
+                    res = static_cast<R>(*src);
+                    src += stride;
+                    row = 1;
+                }
+                for (; row < n_rows; ++row, src += stride)
+                {
+                    res = f(res, *src);
+                }
+                dst[j] = res;
+            }
+        }
+    }
+
     template <class F, class E, class X>
     auto reduce_immediate(F&& f, E&& e, X&& axes)
     {
@@ -95,6 +434,8 @@ namespace xt
         auto init_fct = std::get<1>(f);
         auto merge_fct = std::get<2>(f);
 
+        using simd_reduce = detail::is_simd_reducer<reduce_functor_type, init_functor_type, expr_value_type, result_type>;
+
         shape_type result_shape;
         resize_container(result_shape, e.dimension() - axes.size());
 
@@ -116,10 +457,40 @@ namespace xt
         // Fast track for complete reduction
         if (e.dimension() == axes.size())
         {
-            auto begin = e.storage().begin();
-            result_type tmp = init_fct(*begin);
-            ++begin;
-            result.data()[0] = std::accumulate(begin, e.storage().end(), tmp, reduce_fct);
+            auto begin = e.data();
+            std::size_t size = e.size();
+            constexpr std::size_t fixed = fixed_size<std::decay_t<E>>::value;
+            constexpr bool unroll = fixed != 0 && fixed <= XTENSOR_FIXED_UNROLL_SIZE;
+            if (unroll)
+            {
+                result.data()[0] = detail::reduce_fixed<result_type>(reduce_fct, init_fct, begin,
+                                                                     std::make_index_sequence<unroll ? fixed - 1 : 0>());
+                return result;
+            }
+            if (parallel_enabled(size))
+            {
+                // Each worker reduces a contiguous chunk of the storage, the partial
+                // results are then merged in order.
+                std::size_t n_chunks = (std::min)(size, 4 * parallel_concurrency());
+                uvector<result_type> partials(n_chunks);
+                parallel_for(std::size_t(0), n_chunks, std::size_t(1), [&](std::size_t first, std::size_t last) {
+                    for (std::size_t c = first; c < last; ++c)
+                    {
+                        std::size_t chunk_first = size * c / n_chunks;
+                        std::size_t chunk_last = size * (c + 1) / n_chunks;
+                        partials[c] = detail::reduce_contiguous<result_type>(reduce_fct, init_fct, begin + chunk_first,
+                                                                             chunk_last - chunk_first, simd_reduce());
+                    }
+                });
+                result_type tmp = partials[0];
+                for (std::size_t c = 1; c < n_chunks; ++c)
+                {
+                    tmp = merge_fct(tmp, partials[c]);
+                }
+                result.data()[0] = tmp;
+                return result;
+            }
+            result.data()[0] = detail::reduce_contiguous<result_type>(reduce_fct, init_fct, begin, size, simd_reduce());
             return result;
         }
 
@@ -217,86 +588,124 @@ namespace xt
         auto out = result.data();
         auto out_begin = result.data();
 
-        std::ptrdiff_t next_stride = 0;
-
-        std::pair<bool, std::ptrdiff_t> idx_res(false, 0);
-
-        // Remark: eventually some modifications here to make conditions faster where merge + accumulate is the
-        // same function (e.g. check std::is_same<decltype(merge_fct), decltype(reduce_fct)>::value) ...
-
-        auto merge_border = out;
-        bool merge = false;
+        // Each iteration of the outer loop reduces a contiguous block of block_size
+        // elements of the input into the output.
+        std::size_t block_size = inner_stride * outer_loop_size;
 
-        // TODO there could be some performance gain by removing merge checking
-        //      when axes.size() == 1 and even next_idx could be removed for something simpler (next_stride always the same)
-        //      best way to do this would be to create a function that takes (begin, out, outer_loop_size, inner_loop_size, next_idx_lambda)
-        // Decide if going about it row-wise or col-wise
-        if (inner_stride == 1)
-        {
-            while (idx_res.first != true)
+        // Reduces the block starting at first into [dst + inner_first, dst + inner_last).
+        // When merge_dst is true, the block is merged with the current values of dst.
+        auto reduce_block = [&](auto first, auto dst, bool merge_dst, std::size_t inner_first, std::size_t inner_last) {
+            // Decide if going about it row-wise or col-wise
+            if (inner_stride == 1)
             {
-                // for unknown reasons it's much faster to use a temporary variable and
-                // std::accumulate here -- probably some cache behavior
-                result_type tmp;
-                tmp = init_fct(*begin);
-                tmp = std::accumulate(begin + 1, begin + outer_loop_size, tmp, reduce_fct);
+                result_type tmp = detail::reduce_contiguous<result_type>(reduce_fct, init_fct, first,
+                                                                         outer_loop_size, simd_reduce());
 
                 // use merge function if necessary
-                *out = merge ? merge_fct(*out, tmp) : tmp;
-
-                begin += outer_loop_size;
-
-                idx_res = next_idx();
-                next_stride = idx_res.second;
-                out = out_begin + next_stride;
+                *dst = merge_dst ? merge_fct(*dst, tmp) : tmp;
+            }
+            else
+            {
+                detail::reduce_strided<result_type>(reduce_fct, init_fct, first + inner_first, outer_loop_size,
+                                                    inner_stride, dst + inner_first, inner_last - inner_first,
+                                                    merge_dst, simd_reduce());
+            }
+        };
 
-                if (out > merge_border)
+        if (parallel_enabled(e.size()))
+        {
+            // The output is distributed among the workers: a work item owns the
+            // output elements of a set of kept indices (and possibly a slice of
+            // the inner loop), and reduces all the blocks contributing to them
+            // in the same order as the serial loop below.
+            std::size_t n_iter_dims = iter_shape.size();
+            xindex kept_dims, reduced_dims;
+            std::size_t n_kept = 1, n_reduced = 1;
+            for (std::size_t d = 0; d < n_iter_dims; ++d)
+            {
+                if (iter_strides[d] != 0)
                 {
-                    // looped over once
-                    merge = false;
-                    merge_border = out;
+                    kept_dims.push_back(d);
+                    n_kept *= iter_shape[d];
                 }
                 else
                 {
-                    merge = true;
-                }
-            };
-        }
-        else
-        {
-            while (idx_res.first != true)
-            {
-                std::transform(out, out + inner_loop_size, begin, out,
-                               [merge, &init_fct, &merge_fct, &reduce_fct](auto&& v1, auto&& v2) {
-                                    return merge ?
-                                        reduce_fct(v1, v2) :
-                                        // cast because return type of identity function is not upcasted
-                                        static_cast<result_type>(init_fct(v2));
-                               });
-
-                begin += inner_stride;
-                for (std::size_t i = 1; i < outer_loop_size; ++i)
-                {
-                    std::transform(out, out + inner_loop_size, begin, out, reduce_fct);
-                    begin += inner_stride;
+                    reduced_dims.push_back(d);
+                    n_reduced *= iter_shape[d];
                 }
+            }
 
-                idx_res = next_idx();
-                next_stride = idx_res.second;
-                out = out_begin + next_stride;
+            std::size_t n_inner_chunks = 1;
+            std::size_t min_work_items = 4 * parallel_concurrency();
+            if (inner_stride != 1 && n_kept < min_work_items)
+            {
+                n_inner_chunks = (std::min)(inner_loop_size, (min_work_items + n_kept - 1) / n_kept);
+            }
 
-                if (out > merge_border)
+            auto unravel_dims = [&iter_shape](std::size_t index, const xindex& dims, xindex& idx) {
+                for (std::size_t i = dims.size(); i != 0; --i)
                 {
-                    // looped over once
-                    merge = false;
-                    merge_border = out;
+                    std::size_t d = dims[i - 1];
+                    idx[d] = index % iter_shape[d];
+                    index /= iter_shape[d];
                 }
-                else
+            };
+
+            parallel_for(std::size_t(0), n_kept * n_inner_chunks, std::size_t(1), [&](std::size_t first, std::size_t last) {
+                xindex idx(n_iter_dims);
+                for (std::size_t w = first; w < last; ++w)
                 {
-                    merge = true;
+                    std::size_t chunk = w % n_inner_chunks;
+                    std::size_t inner_first = inner_loop_size * chunk / n_inner_chunks;
+                    std::size_t inner_last = inner_loop_size * (chunk + 1) / n_inner_chunks;
+                    unravel_dims(w / n_inner_chunks, kept_dims, idx);
+                    for (std::size_t r = 0; r < n_reduced; ++r)
+                    {
+                        unravel_dims(r, reduced_dims, idx);
+                        std::size_t block_index = 0, out_offset = 0;
+                        for (std::size_t d = 0; d < n_iter_dims; ++d)
+                        {
+                            block_index = block_index * iter_shape[d] + idx[d];
+                            out_offset += idx[d] * iter_strides[d];
+                        }
+                        reduce_block(begin + block_index * block_size, out_begin + out_offset,
+                                     r != 0, inner_first, inner_last);
+                    }
                 }
-            };
+            });
+            return result;
         }
+
+        std::ptrdiff_t next_stride = 0;
+
+        std::pair<bool, std::ptrdiff_t> idx_res(false, 0);
+
+        // Remark: eventually some modifications here to make conditions faster where merge + accumulate is the
+        // same function (e.g. check std::is_same<decltype(merge_fct), decltype(reduce_fct)>::value) ...
+
+        auto merge_border = out;
+        bool merge = false;
+
+        while (idx_res.first != true)
+        {
+            reduce_block(begin, out, merge, std::size_t(0), inner_loop_size);
+            begin += block_size;
+
+            idx_res = next_idx();
+            next_stride = idx_res.second;
+            out = out_begin + next_stride;
+
+            if (out > merge_border)
+            {
+                // looped over once
+                merge = false;
+                merge_border = out;
+            }
+            else
+            {
+                merge = true;
+            }
+        };
         return result;
     }
 
@@ -459,8 +868,14 @@ namespace xt
         template <class S>
         const_stepper stepper_end(const S& shape, layout_type) const noexcept;
 
+        template <class E, class FCT = F, class = std::enable_if_t<detail::is_simd_reducer_assignable<FCT, CT>::value, int>>
+        void assign_to(xexpression<E>& e) const;
+
     private:
 
+        template <class E>
+        bool assign_simd(E& e) const;
+
         CT m_e;
         reduce_functor_type m_reduce;
         init_functor_type m_init;
@@ -859,6 +1274,90 @@ namespace xt
         return const_stepper(*this, offset, true, l);
     }
 
+    /**
+     * Assigns the reducer to the specified expression. When the reduced axes
+     * are the innermost ones of the layout of the underlying expression and
+     * the latter does not broadcast, each element of the result is computed
+     * by reducing batches of the underlying expression, which is never
+     * evaluated in memory. Otherwise the generic assignment is used.
+     * @param e the expression to assign to
+     */
+    template <class F, class CT, class X>
+    template <class E, class FCT, class>
+    inline void xreducer<F, CT, X>::assign_to(xexpression<E>& e) const
+    {
+        using e_shape_type = typename E::shape_type;
+        using e_size_type = typename E::size_type;
+        E& de = e.derived_cast();
+        e_shape_type shape = xtl::make_sequence<e_shape_type>(dimension(), e_size_type(0));
+        broadcast_shape(shape, true);
+        de.resize(std::move(shape));
+        if (!assign_simd(de))
+        {
+            xt::assign_data(e, *this, false);
+        }
+    }
+
+    template <class F, class CT, class X>
+    template <class E>
+    inline bool xreducer<F, CT, X>::assign_simd(E& e) const
+    {
+        using expr_value_type = typename xexpression_type::value_type;
+        using simd_type = xsimd::simd_type<expr_value_type>;
+        constexpr layout_type L = xexpression_type::static_layout;
+        constexpr bool same_layout = E::contiguous_layout && E::static_layout == L &&
+            (L == layout_type::row_major || L == layout_type::column_major);
+        if (!same_layout)
+        {
+            return false;
+        }
+
+        size_type dim = m_e.dimension();
+        size_type n_axes = m_axes.size();
+        size_type reduced_size = 1;
+        for (size_type i = 0; i < n_axes; ++i)
+        {
+            size_type expected = L == layout_type::row_major ? dim - n_axes + i : i;
+            if (static_cast<size_type>(m_axes[i]) != expected)
+            {
+                return false;
+            }
+            reduced_size *= m_e.shape()[expected];
+        }
+
+        dynamic_shape<std::size_t> strides(dim);
+        compute_strides(m_e.shape(), L, strides);
+        if (reduced_size == 0 || !m_e.is_trivial_broadcast(strides))
+        {
+            return false;
+        }
+
+        // Element i of the result reduces the reduced_size consecutive
+        // elements of the underlying expression starting at i * reduced_size.
+        auto reduce_range = [this, &e, reduced_size](size_type first, size_type last) {
+            for (size_type i = first; i < last; ++i)
+            {
+                size_type offset = i * reduced_size;
+                e.data_element(i) = detail::reduce_converted_batches<value_type, expr_value_type>(
+                    m_reduce, reduced_size,
+                    [this, offset](std::size_t j) { return m_e.template load_simd<unaligned_mode, simd_type>(offset + j); },
+                    [this, offset](std::size_t j) { return m_e.data_element(offset + j); },
+                    std::is_same<expr_value_type, value_type>());
+            }
+        };
+
+        size_type size = e.size();
+        if (!detail::forbid_parallel_assign<xexpression_type>::value && parallel_enabled(m_e.size()))
+        {
+            parallel_for(size_type(0), size, size_type(1), reduce_range);
+        }
+        else
+        {
+            reduce_range(size_type(0), size);
+        }
+        return true;
+    }
+
     /***********************************
      * xreducer_stepper implementation *
      ***********************************/
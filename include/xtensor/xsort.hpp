@@ -10,85 +10,749 @@
 #define XTENSOR_SORT_HPP
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "xarray.hpp"
 #include "xeval.hpp"
+#include "xhistogram.hpp"
+#include "xparallel.hpp"
 #include "xslice.hpp"  // for xnone
 #include "xstrided_view.hpp"
 #include "xtensor.hpp"
 
 namespace xt
 {
-    template <class E>
-    auto sort(const xexpression<E>& e, placeholders::xtuph /*t*/)
+    /*! sorting_method enum selecting the algorithm of sort and argsort */
+    enum class sorting_method
     {
-        using value_type = typename E::value_type;
-        const auto de = e.derived_cast();
-        E ev;
-        ev.resize({de.size()});
-
-        std::copy(de.cbegin(), de.cend(), ev.begin());
-        std::sort(ev.begin(), ev.end());
-
-        return ev;
-    }
+        /*! radix sort for lanes of at least 1024 integral or floating-point values, comparison sort otherwise */
+        automatic,
+        /*! comparison sort, stable for argsort */
+        comparison,
+        /*! radix sort, for integral or floating-point values only */
+        radix
+    };
 
     namespace detail
     {
-        template <class E, class F>
-        void call_over_leading_axis(E& ev, F&& fct)
+        template <class It, class Compare, class Sort>
+        inline void parallel_sort_impl(It first, It last, Compare comp, Sort sort_fct)
         {
-            using value_type = typename E::value_type;
-            std::size_t n_iters = 1;
-            std::ptrdiff_t secondary_stride;
-            if (ev.layout() == layout_type::row_major)
+            std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+            if (!parallel_enabled(size))
+            {
+                sort_fct(first, last, comp);
+                return;
+            }
+
+            // Each worker sorts a chunk, the sorted chunks are then merged
+            // pairwise, the merges of a same round running concurrently.
+            std::size_t n_chunks = (std::min)(size, parallel_concurrency());
+            auto bound = [first, size, n_chunks](std::size_t c) {
+                return first + static_cast<std::ptrdiff_t>(size * c / n_chunks);
+            };
+            parallel_for(std::size_t(0), n_chunks, std::size_t(1), [&](std::size_t c_first, std::size_t c_last) {
+                for (std::size_t c = c_first; c < c_last; ++c)
+                {
+                    sort_fct(bound(c), bound(c + 1), comp);
+                }
+            });
+            for (std::size_t width = 1; width < n_chunks; width *= 2)
+            {
+                std::size_t n_merges = (n_chunks + 2 * width - 1) / (2 * width);
+                parallel_for(std::size_t(0), n_merges, std::size_t(1), [&](std::size_t m_first, std::size_t m_last) {
+                    for (std::size_t m = m_first; m < m_last; ++m)
+                    {
+                        std::size_t lo = 2 * width * m;
+                        std::size_t mid = (std::min)(lo + width, n_chunks);
+                        std::size_t hi = (std::min)(lo + 2 * width, n_chunks);
+                        std::inplace_merge(bound(lo), bound(mid), bound(hi), comp);
+                    }
+                });
+            }
+        }
+
+        template <class It, class Compare>
+        inline void parallel_sort(It first, It last, Compare comp)
+        {
+            parallel_sort_impl(first, last, comp, [](It f, It l, Compare c) { std::sort(f, l, c); });
+        }
+
+        template <class It, class Compare>
+        inline void parallel_stable_sort(It first, It last, Compare comp)
+        {
+            parallel_sort_impl(first, last, comp, [](It f, It l, Compare c) { std::stable_sort(f, l, c); });
+        }
+
+        template <class F>
+        inline void parallel_positions(std::size_t size, F&& f)
+        {
+            if (parallel_enabled(size))
+            {
+                parallel_for(std::size_t(0), size, std::size_t(1), f);
+            }
+            else
+            {
+                f(std::size_t(0), size);
+            }
+        }
+
+        /*********************
+         * radix sort helpers *
+         *********************/
+
+        constexpr std::size_t radix_sort_threshold = 1024;
+        constexpr std::size_t radix_digit_bits = 8;
+        constexpr std::size_t radix_size = std::size_t(1) << radix_digit_bits;
+        // Minimum number of elements per chunk when a lane is sorted
+        // concurrently.
+        constexpr std::size_t radix_chunk_size = std::size_t(1) << 16;
+
+        template <std::size_t N>
+        struct radix_uint;
+
+        template <>
+        struct radix_uint<4>
+        {
+            using type = std::uint32_t;
+        };
+
+        template <>
+        struct radix_uint<8>
+        {
+            using type = std::uint64_t;
+        };
+
+        // Maps the values of T to unsigned keys with the same order.
+        template <class T, class = void>
+        struct radix_traits : std::false_type
+        {
+        };
+
+        // Integers: the sign bit is flipped.
+        template <class T>
+        struct radix_traits<T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>>
+            : std::true_type
+        {
+            using key_type = std::make_unsigned_t<T>;
+            static constexpr key_type sign_mask = std::is_signed<T>::value ?
+                static_cast<key_type>(key_type(1) << (8 * sizeof(T) - 1)) : key_type(0);
+
+            static key_type to_key(T v) noexcept
+            {
+                return static_cast<key_type>(static_cast<key_type>(v) ^ sign_mask);
+            }
+
+            static T from_key(key_type k) noexcept
+            {
+                return static_cast<T>(static_cast<key_type>(k ^ sign_mask));
+            }
+
+            static key_type to_order_key(T v) noexcept
+            {
+                return to_key(v);
+            }
+        };
+
+        // IEEE floating-point numbers: all the bits of the negative numbers
+        // are flipped, only the sign bit of the positive ones. to_key is a
+        // bijection placing -0 before +0, and negative NaNs before -inf.
+        // to_order_key gives the order of the comparison sorts instead: -0
+        // and +0 share their key, and all the NaNs are placed after +inf.
+        template <class T>
+        struct radix_traits<T, std::enable_if_t<std::is_floating_point<T>::value && std::numeric_limits<T>::is_iec559 &&
+                                                (sizeof(T) == 4 || sizeof(T) == 8)>>
+            : std::true_type
+        {
+            using key_type = typename radix_uint<sizeof(T)>::type;
+            static constexpr key_type sign_mask = key_type(1) << (8 * sizeof(T) - 1);
+
+            static key_type to_key(T v) noexcept
+            {
+                key_type bits;
+                std::memcpy(&bits, &v, sizeof(T));
+                return (bits & sign_mask) ? static_cast<key_type>(~bits) : static_cast<key_type>(bits | sign_mask);
+            }
+
+            static T from_key(key_type k) noexcept
+            {
+                key_type bits = (k & sign_mask) ? static_cast<key_type>(k & ~sign_mask) : static_cast<key_type>(~k);
+                T v;
+                std::memcpy(&v, &bits, sizeof(T));
+                return v;
+            }
+
+            static key_type to_order_key(T v) noexcept
+            {
+                if (std::isnan(v))
+                {
+                    return static_cast<key_type>(~key_type(0));
+                }
+                return v == T(0) ? to_key(T(0)) : to_key(v);
+            }
+        };
+
+        // Order of the comparison sorts, placing NaNs after the other values.
+        template <class T, class = void>
+        struct nan_last_less
+        {
+            bool operator()(const T& a, const T& b) const
+            {
+                return a < b;
+            }
+        };
+
+        template <class T>
+        struct nan_last_less<T, std::enable_if_t<std::is_floating_point<T>::value>>
+        {
+            bool operator()(const T& a, const T& b) const
+            {
+                return a < b || (std::isnan(b) && !std::isnan(a));
+            }
+        };
+
+        // Moves the NaNs of [first, last) to its end and returns the end of
+        // the other values.
+        template <class T>
+        inline T* partition_nans(T* first, T* last, std::true_type /*floating*/)
+        {
+            return std::partition(first, last, [](const T& v) { return !std::isnan(v); });
+        }
+
+        template <class T>
+        inline T* partition_nans(T*, T* last, std::false_type /*floating*/)
+        {
+            return last;
+        }
+
+        template <class K>
+        inline std::size_t radix_digit(K key, std::size_t pass) noexcept
+        {
+            return static_cast<std::size_t>(static_cast<K>(key >> (pass * radix_digit_bits)) & K(radix_size - 1));
+        }
+
+        /**
+         * Stable LSD radix sort of keys, one pass per byte. The positions
+         * in idx, if not null, are moved along with the keys. The digit
+         * histograms of all the passes are computed in a single read, the
+         * passes where all the keys share the same digit are skipped. Long
+         * ranges are split into chunks histogrammed and scattered
+         * concurrently, each chunk writing at offsets computed from the
+         * histograms of the previous chunks.
+         */
+        template <class K>
+        inline void radix_sort_keys(K* keys, std::size_t* idx, std::size_t size)
+        {
+            constexpr std::size_t n_passes = sizeof(K);
+            std::size_t n_chunks = 1;
+            if (parallel_enabled(size))
+            {
+                n_chunks = (std::max)(std::size_t(1), (std::min)(parallel_concurrency(), size / radix_chunk_size));
+            }
+            auto bound = [size, n_chunks](std::size_t c) { return size * c / n_chunks; };
+            auto run_chunks = [n_chunks](auto&& f) {
+                if (n_chunks == 1)
+                {
+                    f(std::size_t(0), std::size_t(1));
+                }
+                else
+                {
+                    parallel_for(std::size_t(0), n_chunks, std::size_t(1), f);
+                }
+            };
+
+            // counts[(c * n_passes + p) * radix_size + d]: number of keys
+            // of chunk c whose digit p is d
+            std::vector<std::size_t> counts(n_chunks * n_passes * radix_size, std::size_t(0));
+            auto histogram = [&counts, &bound](const K* src, std::size_t c, std::size_t first_pass, std::size_t last_pass) {
+                std::size_t* h = counts.data() + c * n_passes * radix_size;
+                for (std::size_t i = bound(c); i < bound(c + 1); ++i)
+                {
+                    for (std::size_t p = first_pass; p < last_pass; ++p)
+                    {
+                        ++h[p * radix_size + radix_digit(src[i], p)];
+                    }
+                }
+            };
+            run_chunks([&histogram, keys](std::size_t c_first, std::size_t c_last) {
+                for (std::size_t c = c_first; c < c_last; ++c)
+                {
+                    histogram(keys, c, 0, n_passes);
+                }
+            });
+
+            uvector<K> key_buffer(size);
+            uvector<std::size_t> idx_buffer(idx != nullptr ? size : std::size_t(0));
+            K* src = keys;
+            K* dst = key_buffer.data();
+            std::size_t* idx_src = idx;
+            std::size_t* idx_dst = idx_buffer.data();
+            bool permuted = false;
+            for (std::size_t p = 0; p < n_passes; ++p)
+            {
+                std::array<std::size_t, radix_size> total;
+                total.fill(std::size_t(0));
+                for (std::size_t c = 0; c < n_chunks; ++c)
+                {
+                    const std::size_t* h = counts.data() + (c * n_passes + p) * radix_size;
+                    for (std::size_t d = 0; d < radix_size; ++d)
+                    {
+                        total[d] += h[d];
+                    }
+                }
+                if (std::find(total.cbegin(), total.cend(), size) != total.cend())
+                {
+                    continue;
+                }
+
+                // The chunks of the original order have been histogrammed,
+                // those of the permuted keys must be histogrammed again.
+                if (permuted && n_chunks > 1)
+                {
+                    run_chunks([&](std::size_t c_first, std::size_t c_last) {
+                        for (std::size_t c = c_first; c < c_last; ++c)
+                        {
+                            std::size_t* h = counts.data() + (c * n_passes + p) * radix_size;
+                            std::fill(h, h + radix_size, std::size_t(0));
+                            histogram(src, c, p, p + 1);
+                        }
+                    });
+                }
+
+                std::size_t offset = 0;
+                for (std::size_t d = 0; d < radix_size; ++d)
+                {
+                    for (std::size_t c = 0; c < n_chunks; ++c)
+                    {
+                        std::size_t& h = counts[(c * n_passes + p) * radix_size + d];
+                        std::size_t n = h;
+                        h = offset;
+                        offset += n;
+                    }
+                }
+
+                run_chunks([&](std::size_t c_first, std::size_t c_last) {
+                    for (std::size_t c = c_first; c < c_last; ++c)
+                    {
+                        std::size_t* h = counts.data() + (c * n_passes + p) * radix_size;
+                        for (std::size_t i = bound(c); i < bound(c + 1); ++i)
+                        {
+                            std::size_t pos = h[radix_digit(src[i], p)]++;
+                            dst[pos] = src[i];
+                            if (idx_src != nullptr)
+                            {
+                                idx_dst[pos] = idx_src[i];
+                            }
+                        }
+                    }
+                });
+                std::swap(src, dst);
+                std::swap(idx_src, idx_dst);
+                permuted = true;
+            }
+
+            if (src != keys)
+            {
+                std::copy(src, src + size, keys);
+                if (idx != nullptr)
+                {
+                    std::copy(idx_src, idx_src + size, idx);
+                }
+            }
+        }
+
+        template <class T>
+        inline void radix_sort(T* first, T* last)
+        {
+            using traits = radix_traits<T>;
+            using key_type = typename traits::key_type;
+            last = partition_nans(first, last, std::is_floating_point<T>());
+            std::size_t size = static_cast<std::size_t>(last - first);
+            uvector<key_type> keys(size);
+            key_type* k = keys.data();
+            parallel_positions(size, [first, k](std::size_t b, std::size_t e) {
+                std::transform(first + b, first + e, k + b, &traits::to_key);
+            });
+            radix_sort_keys(k, static_cast<std::size_t*>(nullptr), size);
+            parallel_positions(size, [first, k](std::size_t b, std::size_t e) {
+                std::transform(k + b, k + e, first + b, &traits::from_key);
+            });
+        }
+
+        // Fills [idx, idx + (last - first)) with the stable order of [first, last).
+        template <class T>
+        inline void radix_argsort(const T* first, const T* last, std::size_t* idx)
+        {
+            using traits = radix_traits<T>;
+            using key_type = typename traits::key_type;
+            std::size_t size = static_cast<std::size_t>(last - first);
+            uvector<key_type> keys(size);
+            key_type* k = keys.data();
+            parallel_positions(size, [first, k, idx](std::size_t b, std::size_t e) {
+                std::transform(first + b, first + e, k + b, &traits::to_order_key);
+                std::iota(idx + b, idx + e, b);
+            });
+            radix_sort_keys(k, idx, size);
+        }
+
+        template <class T>
+        inline void check_sorting_method(sorting_method method)
+        {
+            if (method == sorting_method::radix && !radix_traits<T>::value)
+            {
+                throw std::runtime_error("Radix sort requires integral or floating-point values.");
+            }
+        }
+
+        inline bool use_radix_sort(sorting_method method, std::size_t size) noexcept
+        {
+            return method == sorting_method::radix ||
+                (method == sorting_method::automatic && size >= radix_sort_threshold);
+        }
+
+        template <class T>
+        inline void sort_lane(T* first, T* last, sorting_method method, std::true_type /*radix*/)
+        {
+            if (use_radix_sort(method, static_cast<std::size_t>(last - first)))
             {
-                n_iters = std::accumulate(ev.shape().begin(), ev.shape().end() - 1,
-                                          std::size_t(1), std::multiplies<>());
-                secondary_stride = static_cast<std::ptrdiff_t>(ev.strides()[ev.dimension() - 2]);
+                radix_sort(first, last);
             }
             else
             {
-                n_iters = std::accumulate(ev.shape().begin() + 1, ev.shape().end(),
-                                          std::size_t(1), std::multiplies<>());
-                secondary_stride = static_cast<std::ptrdiff_t>(ev.strides()[1]);
+                parallel_sort(first, last, nan_last_less<T>());
             }
+        }
+
+        template <class T>
+        inline void sort_lane(T* first, T* last, sorting_method, std::false_type /*radix*/)
+        {
+            parallel_sort(first, last, nan_last_less<T>());
+        }
+
+        template <class T>
+        inline void sort_lane(T* first, T* last, sorting_method method)
+        {
+            sort_lane(first, last, method, radix_traits<T>());
+        }
+
+        template <class T>
+        inline void argsort_lane(const T* first, const T* last, std::size_t* idx, sorting_method method, std::true_type /*radix*/)
+        {
+            if (use_radix_sort(method, static_cast<std::size_t>(last - first)))
+            {
+                radix_argsort(first, last, idx);
+            }
+            else
+            {
+                argsort_lane(first, last, idx, method, std::false_type());
+            }
+        }
+
+        template <class T>
+        inline void argsort_lane(const T* first, const T* last, std::size_t* idx, sorting_method, std::false_type /*radix*/)
+        {
+            std::size_t size = static_cast<std::size_t>(last - first);
+            std::iota(idx, idx + size, std::size_t(0));
+            nan_last_less<T> comp;
+            parallel_stable_sort(idx, idx + size, [first, comp](std::size_t a, std::size_t b) { return comp(first[a], first[b]); });
+        }
+
+        template <class T>
+        inline void argsort_lane(const T* first, const T* last, std::size_t* idx, sorting_method method)
+        {
+            argsort_lane(first, last, idx, method, radix_traits<T>());
+        }
 
-            std::ptrdiff_t offset = 0;
+        // Partitions [first, last) so that the elements at the positions of the
+        // sorted sequence kth are the ones of the sorted range.
+        template <class It, class K, class Compare>
+        inline void nth_elements(It first, It last, const K& kth, Compare comp)
+        {
+            It lo = first;
+            for (std::size_t k : kth)
+            {
+                It nth = first + static_cast<std::ptrdiff_t>(k);
+                std::nth_element(lo, nth, last, comp);
+                lo = nth + 1;
+            }
+        }
 
-            for (std::size_t i = 0; i < n_iters; ++i, offset += secondary_stride)
+        template <class C, std::enable_if_t<!std::is_integral<C>::value, int> = 0>
+        inline std::vector<std::size_t> sorted_kth(const C& kth_container, std::size_t size)
+        {
+            std::vector<std::size_t> kth;
+            for (auto k : kth_container)
             {
-                fct(ev.data() + offset, ev.data() + offset + secondary_stride);
+                kth.push_back(static_cast<std::size_t>(k));
             }
+            std::sort(kth.begin(), kth.end());
+            kth.erase(std::unique(kth.begin(), kth.end()), kth.end());
+            if (!kth.empty() && kth.back() >= size)
+            {
+                throw std::runtime_error("kth " + std::to_string(kth.back()) + " out of bounds for partition.");
+            }
+            return kth;
+        }
+
+        template <class I, std::enable_if_t<std::is_integral<I>::value, int> = 0>
+        inline std::vector<std::size_t> sorted_kth(I kth, std::size_t size)
+        {
+            return sorted_kth(std::array<std::size_t, 1>({static_cast<std::size_t>(kth)}), size);
         }
 
+        // The lanes of a contiguous container along an axis: lane l starts
+        // at offset(l) and its elements are inner apart. Consecutive lanes
+        // sharing the same outer index are interleaved in memory.
+        struct lane_layout
+        {
+            std::size_t size;
+            std::size_t inner;
+            std::size_t n_lanes;
+
+            std::size_t offset(std::size_t lane) const noexcept
+            {
+                return (lane / inner) * size * inner + lane % inner;
+            }
+        };
+
         template <class E>
-        inline std::size_t leading_axis(const E& e)
+        inline lane_layout get_lane_layout(const E& ev, std::size_t axis)
+        {
+            if (axis >= ev.dimension())
+            {
+                throw std::runtime_error("Axis " + std::to_string(axis) + " out of bounds.");
+            }
+            const auto& shape = ev.shape();
+            std::size_t inner = 1;
+            if (ev.layout() == layout_type::row_major)
+            {
+                inner = std::accumulate(shape.cbegin() + std::ptrdiff_t(axis) + 1, shape.cend(),
+                                        std::size_t(1), std::multiplies<std::size_t>());
+            }
+            else if (ev.layout() == layout_type::column_major)
+            {
+                inner = std::accumulate(shape.cbegin(), shape.cbegin() + std::ptrdiff_t(axis),
+                                        std::size_t(1), std::multiplies<std::size_t>());
+            }
+            else
+            {
+                throw std::runtime_error("Layout not supported.");
+            }
+            std::size_t size = shape[axis];
+            std::size_t n_lanes = size == 0 ? 0 : ev.size() / size;
+            return lane_layout{size, inner, n_lanes};
+        }
+
+        constexpr std::size_t lane_block_size = 16;
+
+        // Calls f(first, last) on blocks of at most block_size interleaved
+        // lanes [first, last). The blocks are distributed across the workers
+        // when there are enough of them, otherwise f may parallelize the
+        // processing of each lane.
+        template <class F>
+        inline void for_each_lane_block(const lane_layout& lanes, std::size_t block_size, F&& f)
         {
-            if (e.layout() == layout_type::row_major)
+            if (lanes.n_lanes == 0)
+            {
+                return;
+            }
+            std::size_t inner = lanes.inner;
+            std::size_t block = (std::min)(block_size, inner);
+            std::size_t blocks_per_outer = (inner + block - 1) / block;
+            std::size_t n_blocks = lanes.n_lanes / inner * blocks_per_outer;
+            auto run_blocks = [&f, inner, block, blocks_per_outer](std::size_t b_first, std::size_t b_last) {
+                for (std::size_t b = b_first; b < b_last; ++b)
+                {
+                    std::size_t outer = b / blocks_per_outer;
+                    std::size_t first = outer * inner + (b % blocks_per_outer) * block;
+                    f(first, (std::min)(first + block, (outer + 1) * inner));
+                }
+            };
+            if (n_blocks >= parallel_concurrency() && parallel_enabled(lanes.n_lanes * lanes.size))
             {
-                return e.dimension() - 1;
+                parallel_for(std::size_t(0), n_blocks, std::size_t(1), run_blocks);
             }
-            else if (e.layout() == layout_type::column_major)
+            else
             {
-                return 0;
+                run_blocks(std::size_t(0), n_blocks);
             }
-            throw std::runtime_error("Layout not supported.");
         }
+
+        // Calls f(first, last, l) for each lane l of data, where [first, last)
+        // holds the elements of l contiguously. Strided lanes are gathered by
+        // blocks into a scratch buffer, reading whole rows of the interleaved
+        // lanes instead of transposing the container, and scattered back
+        // when Writeback is true.
+        template <bool Writeback, class T, class F>
+        inline void for_each_lane(T* data, const lane_layout& lanes, F&& f)
+        {
+            using value_type = std::remove_const_t<T>;
+            std::size_t size = lanes.size;
+            std::size_t inner = lanes.inner;
+            for_each_lane_block(lanes, lane_block_size, [data, &lanes, &f, size, inner](std::size_t first, std::size_t last) {
+                if (inner == 1)
+                {
+                    for (std::size_t l = first; l < last; ++l)
+                    {
+                        T* lane = data + lanes.offset(l);
+                        f(lane, lane + size, l);
+                    }
+                    return;
+                }
+                std::size_t n = last - first;
+                T* base = data + lanes.offset(first);
+                std::vector<value_type> scratch(n * size);
+                for (std::size_t j = 0; j < size; ++j)
+                {
+                    const T* row = base + j * inner;
+                    for (std::size_t b = 0; b < n; ++b)
+                    {
+                        scratch[b * size + j] = row[b];
+                    }
+                }
+                for (std::size_t b = 0; b < n; ++b)
+                {
+                    value_type* lane = scratch.data() + b * size;
+                    f(lane, lane + size, first + b);
+                }
+                xtl::mpl::static_if<Writeback>([&](auto self) {
+                    for (std::size_t j = 0; j < size; ++j)
+                    {
+                        value_type* row = self(base) + j * inner;
+                        for (std::size_t b = 0; b < n; ++b)
+                        {
+                            row[b] = scratch[b * size + j];
+                        }
+                    }
+                }, [](auto) {});
+            });
+        }
+
+        // Copies the elements of e in XTENSOR_DEFAULT_LAYOUT order into
+        // a 1-D tensor.
+        template <class E>
+        inline auto flatten_copy(const E& e)
+        {
+            auto res = xtensor<typename E::value_type, 1>::from_shape({e.size()});
+            std::copy(e.cbegin(), e.cend(), res.begin());
+            return res;
+        }
+
+        template <class T>
+        struct argsort_result_type
+        {
+            using type = xarray<std::size_t, T::static_layout>;
+        };
+
+        template <class T, std::size_t N, layout_type L>
+        struct argsort_result_type<xtensor<T, N, L>>
+        {
+            using type = xtensor<std::size_t, N, L>;
+        };
+
+        // Fills each lane of the result with the indices written by
+        // fct(first, last, idx) for the lane [first, last) of ev along axis.
+        template <class E, class F>
+        inline auto index_lanes(const E& ev, const lane_layout& lanes, F&& fct)
+        {
+            using value_type = typename E::value_type;
+            using result_type = typename argsort_result_type<E>::type;
+            result_type res(ev.shape(), ev.layout());
+            std::size_t* res_data = res.data();
+            std::size_t inner = lanes.inner;
+            for_each_lane<false>(ev.data(), lanes, [res_data, &lanes, &fct, inner](const value_type* first, const value_type* last, std::size_t l) {
+                std::size_t* out = res_data + lanes.offset(l);
+                if (inner == 1)
+                {
+                    fct(first, last, out);
+                    return;
+                }
+                std::vector<std::size_t> idx(static_cast<std::size_t>(last - first));
+                fct(first, last, idx.data());
+                for (std::size_t j = 0; j < idx.size(); ++j)
+                {
+                    out[j * inner] = idx[j];
+                }
+            });
+            return res;
+        }
+
+        // Fills each lane of the result with the indices of the lane of ev
+        // along axis reordered by fct(first, last, comp), where comp orders
+        // the indices as nan_last_less orders the values.
+        template <class E, class F>
+        inline auto arg_lanes(const E& ev, const lane_layout& lanes, F&& fct)
+        {
+            using value_type = typename E::value_type;
+            return index_lanes(ev, lanes, [&fct](const value_type* first, const value_type* last, std::size_t* idx) {
+                std::size_t* idx_last = idx + (last - first);
+                std::iota(idx, idx_last, std::size_t(0));
+                nan_last_less<value_type> comp;
+                fct(idx, idx_last, [first, comp](std::size_t a, std::size_t b) { return comp(first[a], first[b]); });
+            });
+        }
+    }
+
+    /**
+     * Sort the flattened xexpression.
+     * The elements are copied into a one-dimensional container, which
+     * is sorted with ``std::sort`` or a radix sort depending on \a method.
+     *
+     * @param e xexpression to sort
+     * @param method sorting algorithm
+     *
+     * @return sorted one-dimensional array (copy)
+     */
+    template <class E>
+    auto sort(const xexpression<E>& e, placeholders::xtuph /*t*/, sorting_method method = sorting_method::automatic)
+    {
+        using value_type = typename E::value_type;
+        detail::check_sorting_method<value_type>(method);
+        const auto& de = e.derived_cast();
+        E ev;
+        ev.resize({de.size()});
+
+        std::copy(de.cbegin(), de.cend(), ev.begin());
+        detail::sort_lane(ev.data(), ev.data() + ev.size(), method);
+
+        return ev;
     }
 
     /**
-     * Sort xexpression (optionally along axis)
+     * Sort xexpression along axis.
      * The sort is performed using the ``std::sort`` functions.
      * A copy of the xexpression is created and returned.
+     * When a parallel backend is enabled, the lanes are sorted
+     * concurrently, and long lanes are sorted with a parallel
+     * merge sort. Lanes along a non-leading axis are sorted by
+     * blocks, without transposing the expression.
+     *
+     * By default, lanes of integral or floating-point values with at
+     * least 1024 elements are sorted with a LSD radix sort instead,
+     * which runs in linear time. \a method forces either algorithm.
+     * Both algorithms place NaNs at the end of the lanes.
      *
      * @param e xexpression to sort
      * @param axis axis along which sort is performed
+     * @param method sorting algorithm
      *
      * @return sorted array (copy)
      */
     template <class E>
-    auto sort(const xexpression<E>& e, std::size_t axis)
+    auto sort(const xexpression<E>& e, std::size_t axis, sorting_method method = sorting_method::automatic)
     {
         using eval_type = typename E::temporary_type;
         using value_type = typename E::value_type;
@@ -97,51 +761,239 @@ namespace xt
 
         if (de.dimension() == 1)
         {
-            return sort(de, xnone());
+            return sort(de, xnone(), method);
         }
 
-        eval_type ev;
+        detail::check_sorting_method<value_type>(method);
+        eval_type ev = de;
+        auto lanes = detail::get_lane_layout(ev, axis);
+        detail::for_each_lane<true>(ev.data(), lanes, [method](value_type* first, value_type* last, std::size_t) {
+            detail::sort_lane(first, last, method);
+        });
+        return ev;
+    }
 
-        if (axis != detail::leading_axis(ev))
-        {
-            auto axis_numbers = arange<std::size_t>(de.shape().size());
-            std::vector<std::size_t> permutation(axis_numbers.begin(), axis_numbers.end());
-            permutation.erase(permutation.begin() + std::ptrdiff_t(axis));
-            if (de.layout() == layout_type::row_major)
-            {
-                permutation.push_back(axis);
-            }
-            else
-            {
-                permutation.insert(permutation.begin(), axis);
-            }
+    template <class E>
+    auto sort(const xexpression<E>& e)
+    {
+        const auto& de = e.derived_cast();
+        return sort(de, de.dimension() - 1);
+    }
 
-            // TODO find a more clever way to get reverse permutation?
-            std::vector<std::size_t> reverse_permutation;
-            for (auto el : axis_numbers)
-            {
-                auto it = std::find(permutation.begin(), permutation.end(), el);
-                reverse_permutation.push_back(std::size_t(std::distance(permutation.begin(), it)));
-            }
+    /**
+     * Returns the indices that would sort the xexpression along the
+     * given axis. The sort is stable: equal elements keep their
+     * relative order. As for sort, long lanes of integral or
+     * floating-point values are sorted with a radix sort unless
+     * \a method specifies otherwise. Both algorithms give the same
+     * indices: -0 and +0 compare equal, and NaNs are placed last.
+     *
+     * @param e xexpression to argsort
+     * @param axis axis along which argsort is performed
+     * @param method sorting algorithm
+     *
+     * @return array of indices with the same shape as e
+     */
+    template <class E>
+    auto argsort(const xexpression<E>& e, std::size_t axis, sorting_method method = sorting_method::automatic)
+    {
+        using value_type = typename E::value_type;
+        detail::check_sorting_method<value_type>(method);
+        auto&& ev = eval(e.derived_cast());
+        return detail::index_lanes(ev, detail::get_lane_layout(ev, axis), [method](const value_type* first, const value_type* last, std::size_t* idx) {
+            detail::argsort_lane(first, last, idx, method);
+        });
+    }
+
+    template <class E>
+    auto argsort(const xexpression<E>& e)
+    {
+        const auto& de = e.derived_cast();
+        return argsort(de, de.dimension() - 1);
+    }
+
+    /**
+     * Returns the indices that would sort the flattened xexpression.
+     *
+     * @param e xexpression to argsort
+     * @param method sorting algorithm
+     *
+     * @return 1-D tensor of indices into the flattened expression
+     */
+    template <class E>
+    auto argsort(const xexpression<E>& e, placeholders::xtuph /*t*/, sorting_method method = sorting_method::automatic)
+    {
+        return argsort(detail::flatten_copy(e.derived_cast()), 0, method);
+    }
+
+    /**
+     * Partially sorts the xexpression along the given axis: in each lane,
+     * the elements at the positions in kth_container are the ones of the
+     * sorted lane, the smaller elements are before them and the greater
+     * ones after, in an unspecified order. As in sort, NaNs are placed
+     * after the other values. This runs in linear time, using
+     * ``std::nth_element``.
+     *
+     * @param e xexpression to partition
+     * @param kth_container position, or container of positions, of the
+     *        elements to put in sorted position
+     * @param axis axis along which the partition is performed
+     *
+     * @return partitioned array (copy)
+     */
+    template <class E, class C>
+    auto partition(const xexpression<E>& e, const C& kth_container, std::size_t axis)
+    {
+        using eval_type = typename E::temporary_type;
+        using value_type = typename E::value_type;
+
+        eval_type ev = e.derived_cast();
+        auto lanes = detail::get_lane_layout(ev, axis);
+        std::vector<std::size_t> kth = detail::sorted_kth(kth_container, lanes.size);
+        detail::for_each_lane<true>(ev.data(), lanes, [&kth](value_type* first, value_type* last, std::size_t) {
+            detail::nth_elements(first, last, kth, detail::nan_last_less<value_type>());
+        });
+        return ev;
+    }
+
+    template <class E, class C>
+    auto partition(const xexpression<E>& e, const C& kth)
+    {
+        const auto& de = e.derived_cast();
+        return partition(de, kth, de.dimension() - 1);
+    }
+
+    /**
+     * Partially sorts the flattened xexpression, see partition.
+     *
+     * @param e xexpression to partition
+     * @param kth positions of the elements to put in sorted position
+     *
+     * @return partitioned 1-D tensor
+     */
+    template <class E, class C>
+    auto partition(const xexpression<E>& e, const C& kth, placeholders::xtuph /*t*/)
+    {
+        return partition(detail::flatten_copy(e.derived_cast()), kth, 0);
+    }
+
+    /**
+     * Returns the indices that would partition the xexpression along the
+     * given axis, see partition.
+     *
+     * @param e xexpression to argpartition
+     * @param kth_container position, or container of positions, of the
+     *        elements to put in sorted position
+     * @param axis axis along which the partition is performed
+     *
+     * @return array of indices with the same shape as e
+     */
+    template <class E, class C>
+    auto argpartition(const xexpression<E>& e, const C& kth_container, std::size_t axis)
+    {
+        auto&& ev = eval(e.derived_cast());
+        auto lanes = detail::get_lane_layout(ev, axis);
+        std::vector<std::size_t> kth = detail::sorted_kth(kth_container, lanes.size);
+        return detail::arg_lanes(ev, lanes, [&kth](auto first, auto last, auto comp) {
+            detail::nth_elements(first, last, kth, comp);
+        });
+    }
 
-            ev = transpose(de, permutation);
-            detail::call_over_leading_axis(ev, [](auto begin, auto end) { std::sort(begin, end); });
-            ev = transpose(ev, reverse_permutation);
-            return ev;
+    template <class E, class C>
+    auto argpartition(const xexpression<E>& e, const C& kth)
+    {
+        const auto& de = e.derived_cast();
+        return argpartition(de, kth, de.dimension() - 1);
+    }
+
+    /**
+     * Returns the indices that would partition the flattened xexpression.
+     *
+     * @param e xexpression to argpartition
+     * @param kth positions of the elements to put in sorted position
+     *
+     * @return 1-D tensor of indices into the flattened expression
+     */
+    template <class E, class C>
+    auto argpartition(const xexpression<E>& e, const C& kth, placeholders::xtuph /*t*/)
+    {
+        return argpartition(detail::flatten_copy(e.derived_cast()), kth, 0);
+    }
+
+    /**
+     * Returns the median of the flattened xexpression, computed
+     * with partition. For an even number of elements, this is the
+     * mean of the two middle elements. As for the mean, the result is
+     * a floating-point value, even for integral expressions. NaNs are
+     * ordered after the other values, as in sort.
+     *
+     * @param e input xexpression
+     */
+    template <class E>
+    auto median(const xexpression<E>& e)
+    {
+        using result_type = std::common_type_t<typename E::value_type, double>;
+        const auto& de = e.derived_cast();
+        std::size_t size = de.size();
+        if (size == 0)
+        {
+            throw std::runtime_error("Median of an empty expression.");
+        }
+        std::size_t half = size / 2;
+        if (size % 2 == 0)
+        {
+            auto values = partition(de, std::array<std::size_t, 2>({half - 1, half}), xnone());
+            return (static_cast<result_type>(values(half - 1)) + static_cast<result_type>(values(half))) / result_type(2);
         }
         else
         {
-            ev = de;
-            detail::call_over_leading_axis(ev, [](auto begin, auto end) { std::sort(begin, end); });
-            return ev;
+            auto values = partition(de, half, xnone());
+            return static_cast<result_type>(values(half));
         }
     }
 
+    /**
+     * Returns the medians of the xexpression along the given axis,
+     * computed with partition. The medians are floating-point values,
+     * even for integral expressions.
+     *
+     * @param e input xexpression
+     * @param axis axis along which the medians are computed
+     */
     template <class E>
-    auto sort(const xexpression<E>& e)
+    auto median(const xexpression<E>& e, std::size_t axis)
     {
+        using result_type = std::common_type_t<typename E::value_type, double>;
         const auto& de = e.derived_cast();
-        return sort(de, de.dimension() - 1);
+        if (axis >= de.dimension())
+        {
+            throw std::runtime_error("Axis " + std::to_string(axis) + " out of bounds.");
+        }
+        std::size_t size = de.shape()[axis];
+        if (size == 0)
+        {
+            throw std::runtime_error("Median of an empty expression.");
+        }
+        std::size_t half = size / 2;
+        slice_vector sv_low(de.dimension(), all());
+        slice_vector sv_high(de.dimension(), all());
+        sv_low[axis] = std::ptrdiff_t(half) - 1;
+        sv_high[axis] = std::ptrdiff_t(half);
+
+        xarray<result_type> res;
+        if (size % 2 == 0)
+        {
+            auto values = partition(de, std::array<std::size_t, 2>({half - 1, half}), axis);
+            res = strided_view(values, sv_low);
+            res += strided_view(values, sv_high);
+            res /= result_type(2);
+        }
+        else
+        {
+            auto values = partition(de, half, axis);
+            res = strided_view(values, sv_high);
+        }
+        return res;
     }
 
     namespace detail
@@ -149,13 +1001,13 @@ namespace xt
         template <class T>
         struct argfunc_result_type
         {
-            using type = xarray<std::size_t>;
+            using type = xarray<std::size_t, T::static_layout>;
         };
 
-        template <class T, std::size_t N>
-        struct argfunc_result_type<xtensor<T, N>>
+        template <class T, std::size_t N, layout_type L>
+        struct argfunc_result_type<xtensor<T, N, L>>
         {
-            using type = xtensor<std::size_t, N - 1>;
+            using type = xtensor<std::size_t, N - 1, L>;
         };
 
         template <class IT, class F>
@@ -183,6 +1035,8 @@ namespace xt
                            std::forward<F>(f));
         }
 
+        constexpr std::size_t arg_func_block_size = 256;
+
         template <class E, class F>
         typename argfunc_result_type<E>::type
         arg_func_impl(const E& e, std::size_t axis, F&& cmp)
@@ -195,54 +1049,39 @@ namespace xt
                 return arg_func_impl(e, std::forward<F>(cmp));
             }
 
-            xt::dynamic_shape<std::size_t> new_shape = e.shape();
-            new_shape.erase(new_shape.begin() + std::ptrdiff_t(axis));
+            auto lanes = get_lane_layout(e, axis);
+            typename result_type::shape_type new_shape;
+            xt::resize_container(new_shape, e.dimension() - 1);
+            std::copy(e.shape().cbegin(), e.shape().cbegin() + std::ptrdiff_t(axis), new_shape.begin());
+            std::copy(e.shape().cbegin() + std::ptrdiff_t(axis) + 1, e.shape().cend(), new_shape.begin() + std::ptrdiff_t(axis));
 
-            result_type result(new_shape);
-            auto result_iter = result.begin();
+            // The lanes are ordered as the elements of the result
+            result_type result(new_shape, e.layout());
+            std::size_t* res_data = result.data();
+            const value_type* data = e.data();
 
-            auto arg_func_lambda = [&result_iter, &cmp](auto begin, auto end) {
-                std::size_t idx = 0;
-                value_type val = *begin;
-                ++begin;
-                for (std::size_t i = 1; begin != end; ++begin, ++i)
+            // Interleaved lanes are scanned together, row by row, so that
+            // the comparisons run over contiguous elements.
+            for_each_lane_block(lanes, arg_func_block_size, [&](std::size_t first, std::size_t last) {
+                std::size_t n = last - first;
+                const value_type* base = data + lanes.offset(first);
+                std::size_t* idx = res_data + first;
+                std::vector<value_type> val(base, base + n);
+                std::fill(idx, idx + n, std::size_t(0));
+                for (std::size_t j = 1; j < lanes.size; ++j)
                 {
-                    if (cmp(*begin, val))
+                    const value_type* row = base + j * lanes.inner;
+                    for (std::size_t b = 0; b < n; ++b)
                     {
-                        val = *begin;
-                        idx = i;
+                        if (cmp(row[b], val[b]))
+                        {
+                            val[b] = row[b];
+                            idx[b] = j;
+                        }
                     }
                 }
-                *result_iter = idx;
-                ++result_iter;
-            };
-
-            if (axis != detail::leading_axis(e))
-            {
-                E input;
-                auto axis_numbers = arange<std::size_t>(e.shape().size());
-                std::vector<std::size_t> permutation(axis_numbers.cbegin(), axis_numbers.cend());
-                permutation.erase(permutation.begin() + std::ptrdiff_t(axis));
-                if (input.layout() == layout_type::row_major)
-                {
-                    permutation.push_back(axis);
-                }
-                else
-                {
-                    permutation.insert(permutation.begin(), axis);
-                }
-                // Note we create a copy
-                input = transpose(e, permutation);
-
-                detail::call_over_leading_axis(input, arg_func_lambda);
-                return result;
-            }
-            else
-            {
-                auto&& input = eval(e);
-                detail::call_over_leading_axis(input, arg_func_lambda);
-                return result;
-            }
+            });
+            return result;
         }
     }
 
@@ -294,22 +1133,244 @@ namespace xt
         return detail::arg_func_impl(ed, axis, std::greater<value_type>());
     }
 
+    namespace detail
+    {
+        template <class T>
+        struct unique_result
+        {
+            std::vector<T> values;
+            std::vector<std::size_t> counts;
+            uvector<std::size_t> inverse;
+        };
+
+        template <class T>
+        using has_integral_unique = std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value>;
+
+        // Ranges of values up to this size are counted in a table indexed
+        // by value rather than hashed.
+        inline std::size_t unique_table_size(std::size_t size) noexcept
+        {
+            return (std::max)(std::size_t(2) * size, std::size_t(1) << 16);
+        }
+
+        /**
+         * Unique values of a small range: the values are counted in a table
+         * indexed by their offset to the minimum, with per-worker tables for
+         * large inputs. The table then maps each value to its rank among
+         * the unique values.
+         */
+        template <class T>
+        inline void unique_table(const T* data, std::size_t size, T lo, std::size_t range, unique_result<T>& res, bool with_inverse)
+        {
+            using unsigned_type = std::make_unsigned_t<T>;
+            auto offset = [lo](T v) {
+                return static_cast<std::size_t>(static_cast<unsigned_type>(static_cast<unsigned_type>(v) - static_cast<unsigned_type>(lo)));
+            };
+            std::vector<std::size_t> table(range, std::size_t(0));
+            chunked_histogram(table.data(), range, size, [data, &offset](std::size_t first, std::size_t last, std::size_t* counts) {
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    ++counts[offset(data[i])];
+                }
+            });
+
+            std::size_t rank = 0;
+            for (std::size_t b = 0; b < range; ++b)
+            {
+                if (table[b] != 0)
+                {
+                    res.values.push_back(static_cast<T>(static_cast<unsigned_type>(static_cast<unsigned_type>(lo) + b)));
+                    res.counts.push_back(table[b]);
+                    table[b] = rank++;
+                }
+            }
+
+            if (with_inverse)
+            {
+                res.inverse = uvector<std::size_t>(size);
+                std::size_t* inverse = res.inverse.data();
+                parallel_positions(size, [data, inverse, &table, &offset](std::size_t first, std::size_t last) {
+                    for (std::size_t i = first; i < last; ++i)
+                    {
+                        inverse[i] = table[offset(data[i])];
+                    }
+                });
+            }
+        }
+
+        /**
+         * Unique values of a wide range: the distinct values are collected
+         * in a hash table in order of first occurrence, then only them are
+         * sorted.
+         */
+        template <class T>
+        inline void unique_hash(const T* data, std::size_t size, unique_result<T>& res, bool with_inverse)
+        {
+            std::unordered_map<T, std::size_t> ids;
+            std::vector<T> distinct;
+            std::vector<std::size_t> counts;
+            uvector<std::size_t> first_ids(with_inverse ? size : std::size_t(0));
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                auto inserted = ids.emplace(data[i], distinct.size());
+                std::size_t id = inserted.first->second;
+                if (inserted.second)
+                {
+                    distinct.push_back(data[i]);
+                    counts.push_back(0);
+                }
+                ++counts[id];
+                if (with_inverse)
+                {
+                    first_ids[i] = id;
+                }
+            }
+
+            std::vector<std::size_t> order(distinct.size());
+            std::iota(order.begin(), order.end(), std::size_t(0));
+            std::sort(order.begin(), order.end(), [&distinct](std::size_t i, std::size_t j) { return distinct[i] < distinct[j]; });
+            std::vector<std::size_t> ranks(distinct.size());
+            for (std::size_t r = 0; r < order.size(); ++r)
+            {
+                res.values.push_back(distinct[order[r]]);
+                res.counts.push_back(counts[order[r]]);
+                ranks[order[r]] = r;
+            }
+
+            if (with_inverse)
+            {
+                res.inverse = std::move(first_ids);
+                std::size_t* inverse = res.inverse.data();
+                parallel_positions(size, [inverse, &ranks](std::size_t first, std::size_t last) {
+                    for (std::size_t i = first; i < last; ++i)
+                    {
+                        inverse[i] = ranks[inverse[i]];
+                    }
+                });
+            }
+        }
+
+        template <class T>
+        inline void unique_impl(const T* data, std::size_t size, unique_result<T>& res, bool with_inverse, std::true_type)
+        {
+            if (size == 0)
+            {
+                return;
+            }
+            using unsigned_type = std::make_unsigned_t<T>;
+            auto minmax = std::minmax_element(data, data + size);
+            T lo = *minmax.first;
+            unsigned_type span = static_cast<unsigned_type>(static_cast<unsigned_type>(*minmax.second) - static_cast<unsigned_type>(lo));
+            if (static_cast<unsigned long long>(span) < static_cast<unsigned long long>(unique_table_size(size)))
+            {
+                unique_table(data, size, lo, static_cast<std::size_t>(span) + 1, res, with_inverse);
+            }
+            else
+            {
+                unique_hash(data, size, res, with_inverse);
+            }
+        }
+
+        /**
+         * Unique values of other types: the positions are sorted by value,
+         * the runs of equal values are then walked in order.
+         */
+        template <class T>
+        inline void unique_impl(const T* data, std::size_t size, unique_result<T>& res, bool with_inverse, std::false_type)
+        {
+            std::vector<std::size_t> order(size);
+            std::iota(order.begin(), order.end(), std::size_t(0));
+            parallel_sort(order.begin(), order.end(), [data](std::size_t i, std::size_t j) { return data[i] < data[j]; });
+            if (with_inverse)
+            {
+                res.inverse = uvector<std::size_t>(size);
+            }
+            for (std::size_t k = 0; k < size; ++k)
+            {
+                const T& v = data[order[k]];
+                if (k == 0 || res.values.back() < v)
+                {
+                    res.values.push_back(v);
+                    res.counts.push_back(0);
+                }
+                ++res.counts.back();
+                if (with_inverse)
+                {
+                    res.inverse[order[k]] = res.values.size() - 1;
+                }
+            }
+        }
+
+        template <class E>
+        inline auto unique_values(const E& e, bool with_inverse)
+        {
+            using value_type = typename E::value_type;
+            auto&& values = flat_values(e);
+            unique_result<value_type> res;
+            unique_impl(values.data() + values.data_offset(), values.size(), res, with_inverse, has_integral_unique<value_type>());
+            return res;
+        }
+
+        template <class T, class C>
+        inline xtensor<T, 1> to_tensor(const C& c)
+        {
+            auto res = xtensor<T, 1>::from_shape({c.size()});
+            std::copy(c.cbegin(), c.cend(), res.begin());
+            return res;
+        }
+    }
+
     /**
      * Find unique elements of a xexpression. This returns a flattened xtensor with
-     * sorted, unique elements from the original expression.
+     * sorted, unique elements from the original expression. The unique values of
+     * integers are counted in a table indexed by value when their range is small
+     * compared to the number of elements, and collected in a hash table otherwise,
+     * so that only the distinct values are sorted.
      *
      * @param e input xexpression (will be flattened)
      */
     template <class E>
     auto unique(const xexpression<E>& e)
     {
-        auto sorted = sort(e, xnone());
-        auto end = std::unique(sorted.begin(), sorted.end());
-        std::size_t sz = static_cast<std::size_t>(std::distance(sorted.begin(), end));
-        // TODO check if we can shrink the vector without reallocation
-        auto result = xtensor<typename E::value_type, 1>::from_shape({sz});
-        std::copy(sorted.begin(), end, result.begin());
-        return result;
+        auto res = detail::unique_values(e.derived_cast(), false);
+        return detail::to_tensor<typename E::value_type>(res.values);
+    }
+
+    /**
+     * Find unique elements of a xexpression and the number of times
+     * each of them occurs.
+     *
+     * @param e input xexpression (will be flattened)
+     *
+     * @return pair of 1-D tensors: the sorted unique elements and their
+     *         numbers of occurrences
+     * @sa unique
+     */
+    template <class E>
+    auto unique_counts(const xexpression<E>& e)
+    {
+        auto res = detail::unique_values(e.derived_cast(), false);
+        return std::make_pair(detail::to_tensor<typename E::value_type>(res.values),
+                              detail::to_tensor<std::size_t>(res.counts));
+    }
+
+    /**
+     * Find unique elements of a xexpression and the indices that
+     * reconstruct the flattened xexpression from them.
+     *
+     * @param e input xexpression (will be flattened)
+     *
+     * @return pair of 1-D tensors: the sorted unique elements and, for
+     *         each element of the flattened xexpression, the index of its
+     *         value among the unique elements
+     * @sa unique
+     */
+    template <class E>
+    auto unique_inverse(const xexpression<E>& e)
+    {
+        auto res = detail::unique_values(e.derived_cast(), true);
+        return std::make_pair(detail::to_tensor<typename E::value_type>(res.values),
+                              detail::to_tensor<std::size_t>(res.inverse));
     }
 }
 
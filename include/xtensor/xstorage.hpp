@@ -18,6 +18,7 @@
 #include <type_traits>
 
 #include "xexception.hpp"
+#include "xparallel.hpp"
 #include "xtensor_simd.hpp"
 #include "xutils.hpp"
 
@@ -169,14 +170,43 @@ namespace xt
             pointer res = alloc.allocate(size);
             if (!xtrivially_default_constructible<value_type>::value)
             {
-                for (pointer p = res; p != res + size; ++p)
+                if (std::is_trivially_copyable<value_type>::value)
                 {
-                    alloc.construct(p, value_type());
+                    // e.g. std::complex, value-initialized by the workers
+                    parallel_fill(res, res + size, value_type());
+                }
+                else
+                {
+                    for (pointer p = res; p != res + size; ++p)
+                    {
+                        alloc.construct(p, value_type());
+                    }
                 }
             }
             return res;
         }
 
+        template <class I, class T, class Tag>
+        inline void uninitialized_copy(I first, I last, T* output, Tag)
+        {
+            std::uninitialized_copy(first, last, output);
+        }
+
+        // Large copies of trivially copyable elements are split among the
+        // workers, which also first touch the destination memory.
+        template <class I, class T>
+        inline void uninitialized_copy(I first, I last, T* output, std::random_access_iterator_tag)
+        {
+            if (std::is_trivially_copyable<T>::value)
+            {
+                parallel_copy(first, last, output);
+            }
+            else
+            {
+                std::uninitialized_copy(first, last, output);
+            }
+        }
+
         template <class A>
         inline void safe_destroy_deallocate(A& alloc, typename A::pointer ptr, typename A::size_type size)
         {
@@ -204,7 +234,7 @@ namespace xt
         if (size != size_type(0))
         {
             p_begin = m_allocator.allocate(size);
-            std::uninitialized_copy(first, last, p_begin);
+            detail::uninitialized_copy(first, last, p_begin, typename std::iterator_traits<I>::iterator_category());
             p_end = p_begin + size;
         }
     }
@@ -253,7 +283,15 @@ namespace xt
         {
             p_begin = m_allocator.allocate(count);
             p_end = p_begin + count;
-            std::uninitialized_fill(p_begin, p_end, value);
+            if (std::is_trivially_copyable<value_type>::value)
+            {
+                // Freshly allocated memory is first touched by the workers
+                parallel_fill(p_begin, p_end, value);
+            }
+            else
+            {
+                std::uninitialized_fill(p_begin, p_end, value);
+            }
         }
     }
 
@@ -305,7 +343,7 @@ namespace xt
             resize_impl(rhs.size());
             if (xtrivially_default_constructible<value_type>::value)
             {
-                std::uninitialized_copy(rhs.p_begin, rhs.p_end, p_begin);
+                detail::uninitialized_copy(rhs.p_begin, rhs.p_end, p_begin, std::random_access_iterator_tag());
             }
             else
             {
@@ -396,7 +396,7 @@ namespace xt
     template <class CT, class S, layout_type L, class FS>
     inline void xstrided_view<CT, S, L, FS>::assign_temporary_impl(temporary_type&& tmp)
     {
-        std::copy(tmp.cbegin(), tmp.cend(), this->begin());
+        xt::assign_data(*this, tmp, false);
     }
 
     /**
@@ -807,7 +807,6 @@ namespace xt
             flat_expression_adaptor(CT& e)
                 : m_e(e)
             {
-                resize_container(m_index, m_e.dimension());
                 resize_container(m_strides, m_e.dimension());
                 m_size = compute_size(m_e.shape());
                 // Fallback to XTENSOR_DEFAULT_LAYOUT when the underlying layout is not
@@ -820,20 +819,19 @@ namespace xt
             flat_expression_adaptor(CT& e, FS&& strides, layout_type layout)
                 : m_e(e), m_strides(xtl::forward_sequence<shape_type>(strides)), m_layout(layout)
             {
-                resize_container(m_index, m_e.dimension());
                 m_size = e.size();
             }
 
             reference operator[](std::size_t idx)
             {
-                m_index = detail::unravel_noexcept(idx, m_strides, m_layout);
-                return m_e.element(m_index.cbegin(), m_index.cend());
+                auto index = detail::unravel_noexcept(idx, m_strides, m_layout);
+                return m_e.element(index.cbegin(), index.cend());
             }
 
             const_reference operator[](std::size_t idx) const
             {
-                m_index = detail::unravel_noexcept(idx, m_strides, m_layout);
-                return m_e.element(m_index.cbegin(), m_index.cend());
+                auto index = detail::unravel_noexcept(idx, m_strides, m_layout);
+                return m_e.element(index.cbegin(), index.cend());
             }
 
             size_type size() const
@@ -875,7 +873,6 @@ namespace xt
 
             CT& m_e;
             shape_type m_strides;
-            mutable index_type m_index;
             size_type m_size;
             layout_type m_layout;
         };
@@ -17,6 +17,7 @@
 
 #include "xbuffer_adaptor.hpp"
 #include "xcontainer.hpp"
+#include "xparallel.hpp"
 #include "xsemantic.hpp"
 
 namespace xt
@@ -261,7 +262,7 @@ namespace xt
         : base_type()
     {
         base_type::resize(shape, l);
-        std::fill(m_storage.begin(), m_storage.end(), value);
+        parallel_fill(m_storage.begin(), m_storage.end(), value);
     }
 
     /**
@@ -288,7 +289,7 @@ namespace xt
         : base_type()
     {
         base_type::resize(shape, strides);
-        std::fill(m_storage.begin(), m_storage.end(), value);
+        parallel_fill(m_storage.begin(), m_storage.end(), value);
     }
 
     /**
@@ -31,12 +31,32 @@
     xt::svector<typename XTENSOR_DATA_SHAPE_CONTAINER(T, EA)::size_type, 4, SA>
 #endif
 
+#ifndef XTENSOR_PARALLEL_THRESHOLD
+#define XTENSOR_PARALLEL_THRESHOLD 32768
+#endif
+
+#ifndef XTENSOR_ASSIGN_TILE_SIZE
+#define XTENSOR_ASSIGN_TILE_SIZE 64
+#endif
+
+#ifndef XTENSOR_FIXED_UNROLL_SIZE
+#define XTENSOR_FIXED_UNROLL_SIZE 64
+#endif
+
 #ifndef XTENSOR_DEFAULT_ALLOCATOR
 #ifdef XTENSOR_ALLOC_TRACKING
     #ifndef XTENSOR_ALLOC_TRACKING_POLICY
         #define XTENSOR_ALLOC_TRACKING_POLICY xt::alloc_tracking::policy::print
     #endif
-    #ifdef XTENSOR_USE_XSIMD
+    #if defined(XTENSOR_USE_ARENA)
+        #include "xallocator.hpp"
+        #define XTENSOR_DEFAULT_ALLOCATOR(T) \
+            xt::tracking_allocator<T, xt::arena_allocator<T>, XTENSOR_ALLOC_TRACKING_POLICY>
+    #elif defined(XTENSOR_USE_HUGEPAGES)
+        #include "xallocator.hpp"
+        #define XTENSOR_DEFAULT_ALLOCATOR(T) \
+            xt::tracking_allocator<T, xt::hugepage_allocator<T>, XTENSOR_ALLOC_TRACKING_POLICY>
+    #elif defined(XTENSOR_USE_XSIMD)
         #include <xsimd/xsimd.hpp>
         #define XTENSOR_DEFAULT_ALLOCATOR(T) \
             xt::tracking_allocator<T, xsimd::aligned_allocator<T, XSIMD_DEFAULT_ALIGNMENT>, XTENSOR_ALLOC_TRACKING_POLICY>
@@ -45,7 +65,15 @@
             xt::tracking_allocator<T, std::allocator<T>, XTENSOR_ALLOC_TRACKING_POLICY>
     #endif
 #else
-    #ifdef XTENSOR_USE_XSIMD
+    #if defined(XTENSOR_USE_ARENA)
+    #include "xallocator.hpp"
+    #define XTENSOR_DEFAULT_ALLOCATOR(T) \
+        xt::arena_allocator<T>
+    #elif defined(XTENSOR_USE_HUGEPAGES)
+    #include "xallocator.hpp"
+    #define XTENSOR_DEFAULT_ALLOCATOR(T) \
+        xt::hugepage_allocator<T>
+    #elif defined(XTENSOR_USE_XSIMD)
     #include <xsimd/xsimd.hpp>
     #define XTENSOR_DEFAULT_ALLOCATOR(T) \
         xsimd::aligned_allocator<T, XSIMD_DEFAULT_ALIGNMENT>
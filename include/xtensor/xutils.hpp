@@ -11,13 +11,18 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <complex>
 #include <cstddef>
 #include <initializer_list>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <tuple>
 #include <type_traits>
+#include <typeinfo>
 #include <utility>
 #include <vector>
 
@@ -531,6 +536,20 @@ namespace xt
         constexpr static bool value = decltype(test<T>(std::declval<const std::add_pointer_t<typename T::value_type>>()))::value == true;
     };
 
+    /**************
+     * fixed_size *
+     **************/
+
+    /**
+     * Number of elements of the container type T when it is known at compile
+     * time, 0 otherwise. Specialized for the fixed containers and adaptors
+     * in xfixed.hpp.
+     */
+    template <class T>
+    struct fixed_size : std::integral_constant<std::size_t, 0>
+    {
+    };
+
     /******************
      * enable_if_type *
      ******************/
@@ -933,10 +952,269 @@ namespace xt
         enum policy
         {
             print,
-            assert
+            assert,
+            statistics
+        };
+
+        /**
+         * Allocation counters of an element type or of a tag, as
+         * returned by snapshot().
+         */
+        struct counters
+        {
+            std::string name;
+            std::size_t allocations;
+            std::size_t deallocations;
+            std::size_t allocated_bytes;
+            std::size_t deallocated_bytes;
+        };
+
+        /**
+         * Number of buckets of the allocation size histogram. Bucket
+         * @c i counts the allocations of @c s bytes with
+         * <tt>2^(i-1) <= s < 2^i</tt>, bucket 0 the empty ones.
+         */
+        constexpr std::size_t histogram_size = 8 * sizeof(std::size_t) + 1;
+
+        /**
+         * Statistics gathered by the tracking allocators using the
+         * statistics policy.
+         */
+        struct statistics_snapshot
+        {
+            std::vector<counters> types;
+            std::vector<counters> tags;
+            std::size_t live_bytes;
+            std::size_t peak_bytes;
+            std::array<std::size_t, histogram_size> histogram;
+        };
+
+        statistics_snapshot snapshot();
+        void reset();
+
+        class scoped_tag
+        {
+        public:
+
+            explicit scoped_tag(const std::string& name);
+            ~scoped_tag();
+
+            scoped_tag(const scoped_tag&) = delete;
+            scoped_tag& operator=(const scoped_tag&) = delete;
+
+        private:
+
+            void* p_previous;
+        };
+    }
+
+    namespace detail
+    {
+        struct alloc_counters
+        {
+            std::atomic<std::size_t> allocations{0};
+            std::atomic<std::size_t> deallocations{0};
+            std::atomic<std::size_t> allocated_bytes{0};
+            std::atomic<std::size_t> deallocated_bytes{0};
         };
+
+        struct alloc_registry
+        {
+            using entry_type = std::pair<std::string, std::unique_ptr<alloc_counters>>;
+
+            std::mutex mutex;
+            std::vector<entry_type> types;
+            std::vector<entry_type> tags;
+            std::atomic<std::size_t> live_bytes{0};
+            std::atomic<std::size_t> peak_bytes{0};
+            std::array<std::atomic<std::size_t>, alloc_tracking::histogram_size> histogram;
+
+            alloc_registry()
+            {
+                for (auto& h : histogram)
+                {
+                    h.store(0, std::memory_order_relaxed);
+                }
+            }
+
+            alloc_counters& get(std::vector<entry_type>& entries, const std::string& name)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                auto it = std::find_if(entries.begin(), entries.end(), [&name](const entry_type& e) { return e.first == name; });
+                if (it == entries.end())
+                {
+                    entries.emplace_back(name, std::unique_ptr<alloc_counters>(new alloc_counters()));
+                    return *entries.back().second;
+                }
+                return *(it->second);
+            }
+        };
+
+        inline alloc_registry& get_alloc_registry()
+        {
+            static alloc_registry registry;
+            return registry;
+        }
+
+        inline alloc_counters*& current_alloc_tag() noexcept
+        {
+            static thread_local alloc_counters* tag = nullptr;
+            return tag;
+        }
+
+        template <class T>
+        inline alloc_counters& alloc_type_counters()
+        {
+            static alloc_counters& counters = get_alloc_registry().get(get_alloc_registry().types, typeid(T).name());
+            return counters;
+        }
+
+        inline std::size_t alloc_histogram_bucket(std::size_t bytes) noexcept
+        {
+            std::size_t res = 0;
+            for (; bytes != 0; bytes >>= 1)
+            {
+                ++res;
+            }
+            return res;
+        }
+
+        // The counters of the type are looked up by the caller: the lookup
+        // may allocate, hence throw.
+        inline void record_allocation(alloc_counters& counters, std::size_t bytes) noexcept
+        {
+            counters.allocations.fetch_add(1, std::memory_order_relaxed);
+            counters.allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+            if (alloc_counters* tag = current_alloc_tag())
+            {
+                tag->allocations.fetch_add(1, std::memory_order_relaxed);
+                tag->allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+            }
+            alloc_registry& registry = get_alloc_registry();
+            registry.histogram[alloc_histogram_bucket(bytes)].fetch_add(1, std::memory_order_relaxed);
+            std::size_t live = registry.live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            std::size_t peak = registry.peak_bytes.load(std::memory_order_relaxed);
+            while (live > peak && !registry.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        inline void record_deallocation(alloc_counters& counters, std::size_t bytes) noexcept
+        {
+            counters.deallocations.fetch_add(1, std::memory_order_relaxed);
+            counters.deallocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+            if (alloc_counters* tag = current_alloc_tag())
+            {
+                tag->deallocations.fetch_add(1, std::memory_order_relaxed);
+                tag->deallocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+            }
+            get_alloc_registry().live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        }
+
+        inline std::vector<alloc_tracking::counters> snapshot_alloc_counters(const std::vector<alloc_registry::entry_type>& entries)
+        {
+            std::vector<alloc_tracking::counters> res;
+            res.reserve(entries.size());
+            for (const auto& e : entries)
+            {
+                res.push_back({e.first,
+                               e.second->allocations.load(std::memory_order_relaxed),
+                               e.second->deallocations.load(std::memory_order_relaxed),
+                               e.second->allocated_bytes.load(std::memory_order_relaxed),
+                               e.second->deallocated_bytes.load(std::memory_order_relaxed)});
+            }
+            return res;
+        }
+
+        inline void reset_alloc_counters(std::vector<alloc_registry::entry_type>& entries) noexcept
+        {
+            for (auto& e : entries)
+            {
+                e.second->allocations.store(0, std::memory_order_relaxed);
+                e.second->deallocations.store(0, std::memory_order_relaxed);
+                e.second->allocated_bytes.store(0, std::memory_order_relaxed);
+                e.second->deallocated_bytes.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    namespace alloc_tracking
+    {
+        /**
+         * Returns the statistics gathered since the start of the program
+         * or the last call to reset(). The element types are named after
+         * <tt>typeid(T).name()</tt>.
+         */
+        inline statistics_snapshot snapshot()
+        {
+            auto& registry = detail::get_alloc_registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            statistics_snapshot res;
+            res.types = detail::snapshot_alloc_counters(registry.types);
+            res.tags = detail::snapshot_alloc_counters(registry.tags);
+            res.live_bytes = registry.live_bytes.load(std::memory_order_relaxed);
+            res.peak_bytes = registry.peak_bytes.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < histogram_size; ++i)
+            {
+                res.histogram[i] = registry.histogram[i].load(std::memory_order_relaxed);
+            }
+            return res;
+        }
+
+        /**
+         * Resets the counters and the histogram, and the peak to the
+         * current number of live bytes.
+         */
+        inline void reset()
+        {
+            auto& registry = detail::get_alloc_registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            detail::reset_alloc_counters(registry.types);
+            detail::reset_alloc_counters(registry.tags);
+            for (auto& h : registry.histogram)
+            {
+                h.store(0, std::memory_order_relaxed);
+            }
+            registry.peak_bytes.store(registry.live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+
+        /**
+         * @class scoped_tag
+         * @brief Attributes allocations to a named call site.
+         *
+         * While a scoped_tag is alive, the allocations and deallocations
+         * performed by the calling thread through tracking allocators
+         * using the statistics policy are also counted in the counters of
+         * the tag. Tags with the same name share their counters; nested
+         * tags hide the outer ones.
+         */
+        inline scoped_tag::scoped_tag(const std::string& name)
+            : p_previous(detail::current_alloc_tag())
+        {
+            auto& registry = detail::get_alloc_registry();
+            detail::current_alloc_tag() = &registry.get(registry.tags, name);
+        }
+
+        inline scoped_tag::~scoped_tag()
+        {
+            detail::current_alloc_tag() = static_cast<detail::alloc_counters*>(p_previous);
+        }
     }
 
+    /**
+     * @class tracking_allocator
+     * @brief Allocator instrumenting the allocations of an underlying
+     * allocator.
+     *
+     * With the print and assert policies, the allocations performed while
+     * alloc_tracking::enabled() is true are respectively printed and
+     * turned into exceptions. The statistics policy always records the
+     * allocations and deallocations; see alloc_tracking::snapshot().
+     *
+     * @tparam T the type of the allocated elements.
+     * @tparam A the underlying allocator.
+     * @tparam P the tracking policy.
+     */
     template <class T, class A, alloc_tracking::policy P>
     struct tracking_allocator
         : private A
@@ -954,6 +1232,15 @@ namespace xt
 
         T* allocate(std::size_t n)
         {
+            if (P == alloc_tracking::statistics)
+            {
+                // The counters are registered before allocating, so that a
+                // failure to register them does not leak the allocation
+                detail::alloc_counters& counters = detail::alloc_type_counters<T>();
+                T* res = base_type::allocate(n);
+                detail::record_allocation(counters, n * sizeof(T));
+                return res;
+            }
             if (alloc_tracking::enabled())
             {
                 if (P == alloc_tracking::print)
@@ -968,7 +1255,15 @@ namespace xt
             return base_type::allocate(n);
         }
 
-        using base_type::deallocate;
+        void deallocate(T* p, std::size_t n)
+        {
+            if (P == alloc_tracking::statistics)
+            {
+                detail::record_deallocation(detail::alloc_type_counters<T>(), n * sizeof(T));
+            }
+            base_type::deallocate(p, n);
+        }
+
         using base_type::construct;
         using base_type::destroy;
 
@@ -9,6 +9,8 @@
 #ifndef TEST_COMMON_HPP
 #define TEST_COMMON_HPP
 
+#include <cstddef>
+
 #include "xtensor/xlayout.hpp"
 #include "xtensor/xstrided_view.hpp"
 
@@ -26,6 +28,15 @@ namespace xt
         return rhs == lhs;
     }
 
+    // Extent to give to one dimension of a test expression whose other
+    // dimensions hold slice_size elements, so that its size exceeds
+    // XTENSOR_PARALLEL_THRESHOLD and the operations on it are split across
+    // workers when a parallel backend is enabled.
+    inline std::size_t parallel_extent(std::size_t slice_size)
+    {
+        return std::size_t(XTENSOR_PARALLEL_THRESHOLD) / slice_size + 1;
+    }
+
     template <class C = dynamic_shape<std::size_t>>
     struct layout_result
     {
@@ -13,6 +13,7 @@
 #include "xtensor/xbuilder.hpp"
 #include "xtensor/xmath.hpp"
 #include "xtensor/xio.hpp"
+#include "test_common.hpp"
 
 namespace xt
 {
@@ -189,4 +190,57 @@ namespace xt
                                    {  9, 90, 990}};
         EXPECT_TRUE(allclose(expected_1, res_1));
     }
-}
\ No newline at end of file
+
+    TEST(xaccumulator, large)
+    {
+        std::size_t n = parallel_extent(2 * 2);
+        xarray<double> a = xt::arange<double>(double(4 * n)) - double(2 * n);
+        a.reshape({std::size_t(2), n, std::size_t(2)});
+        xarray<double, layout_type::column_major> ca = a;
+
+        auto expected_axis = [&a](std::size_t axis) {
+            xarray<double> res = a;
+            for (std::size_t i = 0; i < res.shape()[0]; ++i)
+            {
+                for (std::size_t j = 0; j < res.shape()[1]; ++j)
+                {
+                    for (std::size_t k = 0; k < res.shape()[2]; ++k)
+                    {
+                        std::array<std::size_t, 3> prev = {i, j, k};
+                        if (prev[axis] != 0)
+                        {
+                            --prev[axis];
+                            res(i, j, k) += res[prev];
+                        }
+                    }
+                }
+            }
+            return res;
+        };
+
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            xarray<double> expected = expected_axis(axis);
+            EXPECT_EQ(expected, cumsum(a, axis));
+            EXPECT_EQ(expected, cumsum(ca, axis));
+        }
+
+        xtensor<double, 1> flat = cumsum(a);
+        double acc = 0.;
+        bool flat_ok = true;
+        auto it = a.cbegin();
+        for (std::size_t i = 0; i < flat.size(); ++i, ++it)
+        {
+            acc += *it;
+            flat_ok = flat_ok && (flat(i) == acc);
+        }
+        EXPECT_TRUE(flat_ok);
+
+        xarray<double> b = ones<double>({std::size_t(3), std::size_t(1)});
+        EXPECT_EQ(b, cumsum(b, 1));
+        EXPECT_EQ(b, cumprod(b, 1));
+        xarray<double> expected_b = arange<double>(1., 4.);
+        expected_b.reshape(b.shape());
+        EXPECT_EQ(expected_b, cumsum(b, 0));
+    }
+}
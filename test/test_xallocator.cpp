@@ -0,0 +1,141 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xallocator.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xutils.hpp"
+
+namespace xt
+{
+    using arena_array = xarray<double, layout_type::row_major, arena_allocator<double>>;
+    using arena_tensor = xtensor<double, 2, layout_type::row_major, arena_allocator<double>>;
+
+    inline bool is_arena_aligned(const void* p)
+    {
+        return reinterpret_cast<std::uintptr_t>(p) % XTENSOR_ARENA_ALIGNMENT == 0;
+    }
+
+    TEST(xallocator, without_arena)
+    {
+        EXPECT_EQ(temporary_arena::current(), nullptr);
+        arena_array a = arange<double>(10.);
+        arena_array b = a * 2.;
+        EXPECT_TRUE(is_arena_aligned(b.data()));
+        EXPECT_EQ(b(9), 18.);
+    }
+
+    TEST(xallocator, temporary_arena)
+    {
+        temporary_arena arena(1024);
+        EXPECT_EQ(temporary_arena::current(), &arena);
+        EXPECT_EQ(arena.capacity(), 0u);
+
+        arena_tensor a = ones<double>({4, 5});
+        arena_tensor b = a + a;
+        EXPECT_TRUE(is_arena_aligned(a.data()));
+        EXPECT_TRUE(is_arena_aligned(b.data()));
+        EXPECT_EQ(arena.capacity(), 1024u);
+        EXPECT_EQ(b(3, 4), 2.);
+
+        // Larger than the block size
+        arena_array c = zeros<double>({1000});
+        EXPECT_TRUE(is_arena_aligned(c.data()));
+        EXPECT_GT(arena.capacity(), 1024u + 1000 * sizeof(double));
+    }
+
+    TEST(xallocator, nested_arenas)
+    {
+        temporary_arena outer;
+        {
+            temporary_arena inner(512);
+            EXPECT_EQ(temporary_arena::current(), &inner);
+            arena_array a = ones<double>({3, 3});
+            EXPECT_EQ(inner.capacity(), 512u);
+            EXPECT_EQ(outer.capacity(), 0u);
+        }
+        EXPECT_EQ(temporary_arena::current(), &outer);
+        arena_array b = ones<double>({3, 3});
+        EXPECT_GT(outer.capacity(), 0u);
+    }
+
+    TEST(xallocator, recycle)
+    {
+        temporary_arena arena(4096);
+        arena_tensor a = ones<double>({8, 8});
+        for (std::size_t i = 0; i < 100; ++i)
+        {
+            arena_tensor b = a * double(i);
+            arena_tensor c = b + a;
+            EXPECT_EQ(c(7, 7), double(i) + 1.);
+        }
+        // The block holding a is filled once, then the temporaries
+        // always reuse the same block
+        EXPECT_EQ(arena.capacity(), 2 * 4096u);
+    }
+
+    TEST(xallocator, escape_scope)
+    {
+        arena_array res;
+        {
+            temporary_arena arena;
+            arena_array a = arange<double>(6.);
+            // The storage of the temporary is moved into res
+            res = a * 3.;
+        }
+        EXPECT_EQ(temporary_arena::current(), nullptr);
+        ASSERT_EQ(res.size(), 6u);
+        EXPECT_EQ(res(5), 15.);
+        res.resize({12});
+        EXPECT_TRUE(is_arena_aligned(res.data()));
+    }
+
+    TEST(xallocator, allocation_tracking)
+    {
+        using allocator_type = tracking_allocator<double, arena_allocator<double>, alloc_tracking::policy::assert>;
+        using arr_t = xarray<double, layout_type::row_major, allocator_type>;
+
+        temporary_arena arena;
+        arr_t a = {{1, 2, 3}, {5, 6, 7}};
+        alloc_tracking::enable();
+        EXPECT_THROW(arr_t b = a + 123, std::runtime_error);
+        alloc_tracking::disable();
+        arr_t c = a + 123;
+        EXPECT_EQ(c(1, 2), 130.);
+    }
+
+    TEST(xallocator, hugepage_allocator)
+    {
+        using small_array = xarray<double, layout_type::row_major, hugepage_allocator<double>>;
+        small_array a = arange<double>(100.);
+        EXPECT_TRUE(is_arena_aligned(a.data()));
+        EXPECT_EQ(a(99), 99.);
+
+        std::size_t n = XTENSOR_HUGEPAGE_THRESHOLD / sizeof(double) + 3;
+        using large_tensor = xtensor<double, 1, layout_type::row_major, hugepage_allocator<double, true>>;
+        large_tensor b = arange<double>(double(n));
+        large_tensor c = 2. * b;
+#ifndef _WIN32
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(c.data()) % XTENSOR_HUGEPAGE_SIZE, 0u);
+#endif
+        EXPECT_EQ(c(0), 0.);
+        EXPECT_EQ(c(n - 1), 2. * double(n - 1));
+
+        // Shrinking below the threshold goes back to the small allocations
+        c.resize({10});
+        EXPECT_TRUE(is_arena_aligned(c.data()));
+        c.resize({n});
+        c = b;
+        EXPECT_EQ(c(n - 1), double(n - 1));
+    }
+}
@@ -6,6 +6,8 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <numeric>
+
 #include "gtest/gtest.h"
 #include "xtensor/xarray.hpp"
 #include "xtensor/xio.hpp"
@@ -260,4 +262,55 @@ namespace xt
         xarray_dynamic a = {1};
         EXPECT_FALSE((a.begin() == a.end()));
     }
+
+    TEST(xarray, empty_broadcast_assign)
+    {
+        using shape_type = xarray<int>::shape_type;
+        xarray<int> a(shape_type({0, 3}));
+        xarray<int> b = {1, 2, 3};
+        xarray<int> res = a + b;
+        EXPECT_EQ(res.shape(), shape_type({0, 3}));
+
+        xarray<int, layout_type::column_major> cres = a + b;
+        EXPECT_EQ(cres.size(), 0u);
+
+        xarray<int> c(shape_type({2, 0, 3}));
+        xarray<int> d(shape_type({2, 1, 3}), 1);
+        res = c * d;
+        EXPECT_EQ(res.shape(), shape_type({2, 0, 3}));
+    }
+
+    TEST(xarray, collapsed_broadcast_assign)
+    {
+        using shape_type = xarray<int>::shape_type;
+        xarray<int> a(shape_type({2, 3, 1, 4, 5}));
+        xarray<int> b(shape_type({3, 1, 1, 5}));
+        std::iota(a.begin(), a.end(), 0);
+        std::iota(b.begin(), b.end(), 1000);
+        xarray<int> c(shape_type({4, 5}));
+        std::iota(c.begin(), c.end(), 2000);
+
+        xarray<int> res = a + b;
+        xarray<int> res2 = a - c;
+        xarray<int, layout_type::column_major> cres = a + b;
+        xarray<int, layout_type::column_major> ca = a;
+        xarray<int> rres = ca + b;
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                for (std::size_t l = 0; l < 4; ++l)
+                {
+                    for (std::size_t m = 0; m < 5; ++m)
+                    {
+                        int expected = a(i, j, 0, l, m) + b(j, 0, 0, m);
+                        EXPECT_EQ(res(i, j, 0, l, m), expected);
+                        EXPECT_EQ(cres(i, j, 0, l, m), expected);
+                        EXPECT_EQ(rres(i, j, 0, l, m), expected);
+                        EXPECT_EQ(res2(i, j, 0, l, m), a(i, j, 0, l, m) - c(l, m));
+                    }
+                }
+            }
+        }
+    }
 }
@@ -11,6 +11,7 @@
 #include "xtensor/xarray.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xfixed.hpp"
+#include "xtensor/xview.hpp"
 
 #include "xtensor/xio.hpp"
 #include <sstream>
@@ -284,6 +285,78 @@ namespace xt
         ASSERT_TRUE(t == ar);
     }
 
+    TEST(xbuilder, concatenate_assign)
+    {
+        xarray<double> a = arange<double>(24.);
+        a.reshape({2, 3, 4});
+        xarray<int> b = arange<int>(16);
+        b.reshape({2, 2, 4});
+        auto lazy_b = concatenate(xtuple(a, b), 1);
+
+        xarray<double> res = lazy_b;
+        xarray<double, layout_type::column_major> res_cm = lazy_b;
+        xtensor<double, 3> res_t = lazy_b;
+        shape_t expected_shape = {2, 5, 4};
+        ASSERT_EQ(expected_shape, res.shape());
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            for (std::size_t j = 0; j < 5; ++j)
+            {
+                for (std::size_t k = 0; k < 4; ++k)
+                {
+                    double expected = j < 3 ? a(i, j, k) : double(b(i, j - 3, k));
+                    EXPECT_EQ(expected, res(i, j, k));
+                    EXPECT_EQ(expected, res_cm(i, j, k));
+                    EXPECT_EQ(expected, res_t(i, j, k));
+                }
+            }
+        }
+
+        xarray<double> last = concatenate(xtuple(a, a), 2);
+        EXPECT_EQ(a, view(last, all(), all(), range(0, 4)));
+        EXPECT_EQ(a, view(last, all(), all(), range(4, 8)));
+
+        xarray<double> empty = xarray<double>::from_shape({2, 0, 4});
+        xarray<double> with_empty = concatenate(xtuple(a, empty, a), 1);
+        EXPECT_EQ(with_empty, concatenate(xtuple(a, a), 1));
+    }
+
+    TEST(xbuilder, stack_assign)
+    {
+        xarray<double> a = arange<double>(12.);
+        a.reshape({3, 4});
+        xarray<double> b = a * 2.;
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            auto lazy = stack(xtuple(a, b, a + b), axis);
+            xarray<double> res = lazy;
+            xarray<double, layout_type::column_major> res_cm = lazy;
+            ASSERT_EQ(lazy.shape(), res.shape());
+            EXPECT_TRUE(std::equal(lazy.cbegin(), lazy.cend(), res.cbegin()));
+            EXPECT_TRUE(std::equal(lazy.cbegin(), lazy.cend(), res_cm.cbegin()));
+        }
+    }
+
+    TEST(xbuilder, meshgrid_assign)
+    {
+        auto mesh = meshgrid(arange<double>(4.), linspace<double>(0., 1., 3), arange<int>(5));
+        xarray<double> x = std::get<0>(mesh);
+        xarray<double, layout_type::column_major> y = std::get<1>(mesh);
+        xtensor<int, 3> z = std::get<2>(mesh);
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                for (std::size_t k = 0; k < 5; ++k)
+                {
+                    EXPECT_EQ(double(i), x(i, j, k));
+                    EXPECT_EQ(0.5 * double(j), y(i, j, k));
+                    EXPECT_EQ(int(k), z(i, j, k));
+                }
+            }
+        }
+    }
+
     TEST(xbuilder, meshgrid)
     {
         auto mesh = meshgrid(linspace<double>(0.0, 1.0, 3), linspace<double>(0.0, 1.0, 2));
@@ -8,8 +8,10 @@
 
 #include "gtest/gtest.h"
 
-#include <sstream>
+#include <clocale>
 #include <iostream>
+#include <limits>
+#include <sstream>
 
 #include "xtensor/xcsv.hpp"
 #include "xtensor/xmath.hpp" 
@@ -34,6 +36,124 @@ namespace xt
         ASSERT_TRUE(all(equal(res, exp)));
     }
 
+    TEST(xcsv, load_options)
+    {
+        std::string source =
+            "a;b;c\r\n"
+            "1.5;-2;3e2\r\n"
+            "\r\n"
+            "0.25; 7 ;-1.25E-1\r\n";
+
+        std::stringstream source_stream(source);
+        xtensor<double, 2> res = load_csv<double>(source_stream, ';', 1, {2, 0});
+
+        xtensor<double, 2> exp
+            {{300.0, 1.5},
+             {-0.125, 0.25}};
+
+        ASSERT_TRUE(all(equal(res, exp)));
+    }
+
+    TEST(xcsv, load_float_long_double)
+    {
+        // float and long double cells are rounded to their own precision,
+        // not through a double
+        std::stringstream ld_stream("0.1,3.14159265358979323846264338327950288\n");
+        xtensor<long double, 2> ld = load_csv<long double>(ld_stream);
+        EXPECT_EQ(ld(0, 0), 0.1L);
+        EXPECT_EQ(ld(0, 1), 3.14159265358979323846264338327950288L);
+
+        std::stringstream ld_round_trip;
+        ld_round_trip.precision(std::numeric_limits<long double>::max_digits10);
+        long double third = 1.L / 3.L;
+        ld_round_trip << third << "\n";
+        EXPECT_EQ(load_csv<long double>(ld_round_trip)(0, 0), third);
+
+        // slightly above the midpoint of two floats: rounded to a double
+        // first, it becomes the midpoint, which rounds down to even
+        std::stringstream f_stream("0.1,1.000000059604644775390625001\n");
+        xtensor<float, 2> f = load_csv<float>(f_stream);
+        EXPECT_EQ(f(0, 0), 0.1f);
+        EXPECT_EQ(f(0, 1), 1.000000059604644775390625001f);
+    }
+
+    TEST(xcsv, load_int)
+    {
+        std::string source =
+            "1,-2,+3\n"
+            "-2147483648,2147483647,0\n";
+
+        std::stringstream source_stream(source);
+        xtensor<int, 2> res = load_csv<int>(source_stream);
+
+        xtensor<int, 2> exp
+            {{1, -2, 3},
+             {(std::numeric_limits<int>::min)(), (std::numeric_limits<int>::max)(), 0}};
+
+        ASSERT_TRUE(all(equal(res, exp)));
+
+        std::stringstream overflow_stream("2147483648\n");
+        EXPECT_THROW(load_csv<int>(overflow_stream), std::out_of_range);
+    }
+
+    TEST(xcsv, load_invalid)
+    {
+        std::stringstream invalid_stream("1.0,abc\n");
+        EXPECT_THROW(load_csv<double>(invalid_stream), std::runtime_error);
+
+        std::stringstream ragged_stream("1,2\n3\n");
+        EXPECT_THROW(load_csv<double>(ragged_stream), std::runtime_error);
+
+        std::stringstream blank_stream("a,b\n\n1,2\n");
+        EXPECT_THROW(load_csv<double>(blank_stream, ',', 1), std::runtime_error);
+
+        std::stringstream duplicate_stream("1,2,3\n");
+        EXPECT_THROW(load_csv<double>(duplicate_stream, ',', 0, {1, 1}), std::runtime_error);
+    }
+
+    TEST(xcsv, load_locale)
+    {
+        // cells that are not converted by the fast path are parsed in the
+        // C locale, whatever the numeric locale is
+        std::string old_locale = std::setlocale(LC_NUMERIC, nullptr);
+        for (const char* name : {"de_DE.UTF-8", "de_DE", "fr_FR.UTF-8", "fr_FR"})
+        {
+            if (std::setlocale(LC_NUMERIC, name) != nullptr)
+            {
+                break;
+            }
+        }
+
+        std::stringstream source_stream("1e-30,6.02e25,12345678901234567890.5\n");
+        xtensor<double, 2> res = load_csv<double>(source_stream);
+        std::setlocale(LC_NUMERIC, old_locale.c_str());
+
+        ASSERT_EQ(res.shape()[1], 3u);
+        EXPECT_DOUBLE_EQ(res(0, 0), 1e-30);
+        EXPECT_DOUBLE_EQ(res(0, 1), 6.02e25);
+        EXPECT_DOUBLE_EQ(res(0, 2), 12345678901234567890.5);
+    }
+
+    TEST(xcsv, load_large)
+    {
+        std::size_t nbrow = 2 * XTENSOR_PARALLEL_THRESHOLD / 16 + 5;
+        std::stringstream source_stream;
+        for (std::size_t i = 0; i < nbrow; ++i)
+        {
+            source_stream << i << ".5," << -double(i) / 8. << ",1e-3\n";
+        }
+
+        xtensor<double, 2> res = load_csv<double>(source_stream);
+        ASSERT_EQ(res.shape()[0], nbrow);
+        ASSERT_EQ(res.shape()[1], 3u);
+        for (std::size_t i = 0; i < nbrow; ++i)
+        {
+            EXPECT_EQ(res(i, 0), double(i) + 0.5);
+            EXPECT_EQ(res(i, 1), -double(i) / 8.);
+            EXPECT_EQ(res(i, 2), 1e-3);
+        }
+    }
+
     TEST(xcsv, dump_double)
     {
         xtensor<double, 2> data
@@ -11,6 +11,7 @@
 #include "xtensor/xfixed.hpp"
 #include "xtensor/xadapt.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xmath.hpp"
 #include "xtensor/xtensor.hpp"
 
 // On VS2015, when compiling in x86 mode, alignas(T) leads to C2718
@@ -128,6 +129,54 @@ namespace xt
         EXPECT_EQ(a[0], 2);
     }
 
+    TEST(xtensor_fixed, unrolled_assign)
+    {
+        xtensor_fixed<double, xshape<3>> a({1., 2., 3.});
+        xtensor_fixed<double, xshape<3>> b({4., 5., 6.});
+        xtensor_fixed<double, xshape<3>> c = a * b + 1.;
+        EXPECT_EQ(c(0), 5.);
+        EXPECT_EQ(c(1), 11.);
+        EXPECT_EQ(c(2), 19.);
+
+        xtensor_fixed<float, xshape<4, 4>> m;
+        xtensor_fixed<int, xshape<4, 4>> mi;
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            for (std::size_t j = 0; j < 4; ++j)
+            {
+                m(i, j) = float(i * 4 + j);
+                mi(i, j) = int(j);
+            }
+        }
+        xtensor_fixed<float, xshape<4, 4>> res = 2.f * m - 1.f;
+        xtensor_fixed<double, xshape<4, 4>> resd = mi;
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            for (std::size_t j = 0; j < 4; ++j)
+            {
+                EXPECT_EQ(res(i, j), 2.f * float(i * 4 + j) - 1.f);
+                EXPECT_EQ(resd(i, j), double(j));
+            }
+        }
+
+        std::vector<double> v(3);
+        xfixed_adaptor<std::vector<double>&, xshape<3>> ad(v);
+        ad = a + b;
+        EXPECT_EQ(v[0], 5.);
+        EXPECT_EQ(v[2], 9.);
+    }
+
+    TEST(xtensor_fixed, unrolled_reduce)
+    {
+        xtensorf3x4 a({{1, 2, 3, 4}, {5, 6, 7, 8}, {9, 10, 11, 12}});
+        auto s = sum(a, evaluation_strategy::immediate());
+        EXPECT_EQ(s(), 78.);
+
+        xtensor_fixed<double, xshape<1>> b(3.);
+        auto p = prod(b, evaluation_strategy::immediate());
+        EXPECT_EQ(p(), 3.);
+    }
+
     TEST(xtensor_fixed, layout)
     {
         xtensor_fixed<double, xshape<2, 2>, layout_type::row_major> a;
@@ -0,0 +1,141 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cmath>
+#include <type_traits>
+
+#include "gtest/gtest.h"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xfuse.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xtensor.hpp"
+
+namespace xt
+{
+    namespace
+    {
+        // Counts the calls to avoid relying on timings
+        std::size_t square_calls = 0;
+
+        struct counting_square
+        {
+            double operator()(double x) const
+            {
+                ++square_calls;
+                return x * x;
+            }
+        };
+
+        template <class E>
+        auto counted_square(E&& e)
+        {
+            using functor_type = counting_square;
+            using type = xfunction<functor_type, double, const_xclosure_t<E>>;
+            return type(functor_type(), std::forward<E>(e));
+        }
+    }
+
+    TEST(xfuse, common_subexpression)
+    {
+        xarray<double> a = linspace<double>(0., 1., 12);
+        a.reshape({3, 4});
+        xarray<double> b = linspace<double>(1., 2., 12);
+        b.reshape({3, 4});
+        xarray<double> c = linspace<double>(2., 3., 12);
+        c.reshape({3, 4});
+
+        auto f = exp(a) * sin(b) + exp(a) / c;
+        auto fused = fuse(f);
+        EXPECT_EQ(fused.dimension(), 2u);
+        EXPECT_EQ(fused.shape(), f.shape());
+        EXPECT_EQ(fused(1, 2), f(1, 2));
+
+        xarray<double> expected = f;
+        xarray<double> res = fused;
+        EXPECT_EQ(res, expected);
+    }
+
+    TEST(xfuse, evaluation_count)
+    {
+        xtensor<double, 1> a = arange<double>(8.);
+        xtensor<double, 1> b = arange<double>(8.) + 1.;
+
+        square_calls = 0;
+        xtensor<double, 1> expected = counted_square(a) + counted_square(a) * b;
+        EXPECT_EQ(square_calls, 16u);
+
+        square_calls = 0;
+        xtensor<double, 1> res = fuse(counted_square(a) + counted_square(a) * b);
+        EXPECT_EQ(square_calls, 8u);
+        EXPECT_EQ(res, expected);
+
+        // Different operands are not merged
+        square_calls = 0;
+        res = fuse(counted_square(a) + counted_square(b));
+        EXPECT_EQ(square_calls, 16u);
+        EXPECT_EQ(res(3), 9. + 16.);
+    }
+
+    TEST(xfuse, scalars)
+    {
+        xarray<double> a = arange<double>(6.);
+        double s = 2.;
+        xarray<double> expected = (a + s) * (a + s) - (a + 3.) / (a + 3.);
+        xarray<double> res = fuse((a + s) * (a + s) - (a + 3.) / (a + 3.));
+        EXPECT_EQ(res, expected);
+
+        // Same value, different scalars held by reference
+        double t = 2.;
+        res = fuse((a + s) * (a + t));
+        EXPECT_EQ(res(5), 49.);
+    }
+
+    TEST(xfuse, broadcasting)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray<double> b = {10., 20., 30.};
+        xarray<double> expected = exp(b) * a + exp(b);
+        auto fused = fuse(exp(b) * a + exp(b));
+        xarray<double> res = fused;
+        EXPECT_EQ(res, expected);
+
+        xarray<double> stepped(expected.shape());
+        std::copy(fused.cbegin(), fused.cend(), stepped.begin());
+        EXPECT_EQ(stepped, expected);
+
+        xarray<double, layout_type::column_major> cm = fused;
+        EXPECT_EQ(cm, expected);
+    }
+
+    TEST(xfuse, large)
+    {
+        xtensor<double, 1> a = linspace<double>(-1., 1., 1000);
+        xtensor<double, 1> expected = cos(a) * cos(a) + sin(a) * sin(a) + cos(a);
+        xtensor<double, 1> res = fuse(cos(a) * cos(a) + sin(a) * sin(a) + cos(a));
+        EXPECT_EQ(res, expected);
+    }
+
+    TEST(xfuse, unchanged)
+    {
+        xarray<int> a = {1, 2, 3};
+        xarray<double> b = {1., 2., 3.};
+
+        // Mixed value types
+        auto f = a * a + b;
+        auto fused = fuse(f);
+        bool same_type = std::is_same<decltype(fused), decltype(f)>::value;
+        EXPECT_TRUE(same_type);
+        EXPECT_EQ(fused(2), 12.);
+
+        // Single node
+        auto g = exp(b);
+        bool same_single_type = std::is_same<decltype(fuse(g)), decltype(g)>::value;
+        EXPECT_TRUE(same_single_type);
+    }
+}
@@ -0,0 +1,131 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xhistogram.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xrandom.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    TEST(xhistogram, bincount)
+    {
+        xarray<int> a = {{0, 1, 1}, {3, 2, 1}};
+        xtensor<std::size_t, 1> expected = {1, 3, 1, 1};
+        EXPECT_EQ(bincount(a), expected);
+
+        xtensor<std::size_t, 1> padded = {1, 3, 1, 1, 0, 0};
+        EXPECT_EQ(bincount(a, 6), padded);
+        EXPECT_EQ(bincount(a, 2), expected);
+
+        xarray<int> empty = xarray<int>::from_shape({0});
+        EXPECT_EQ(bincount(empty).size(), 0u);
+        EXPECT_EQ(bincount(empty, 3), (xtensor<std::size_t, 1>{0, 0, 0}));
+
+        xarray<int> negative = {1, -1};
+        EXPECT_THROW(bincount(negative), std::runtime_error);
+
+        // Non contiguous input
+        xarray<unsigned int> b = {{0, 5}, {2, 5}, {4, 5}};
+        xtensor<std::size_t, 1> col = {1, 0, 1, 0, 1};
+        EXPECT_EQ(bincount(view(b, all(), 0)), col);
+    }
+
+    TEST(xhistogram, bincount_weights)
+    {
+        xarray<int> a = {0, 1, 1, 3};
+        xarray<double> w = {0.5, 1., 2., 4.};
+        xtensor<double, 1> expected = {0.5, 3., 0., 4.};
+        EXPECT_EQ(bincount(a, w), expected);
+
+        xarray<int> iw = {1, 2, 3, 4};
+        xtensor<double, 1> iexpected = {1., 5., 0., 4.};
+        EXPECT_EQ(bincount(a, iw), iexpected);
+
+        xarray<double> wrong = {1., 2.};
+        EXPECT_THROW(bincount(a, wrong), std::runtime_error);
+    }
+
+    TEST(xhistogram, bincount_large)
+    {
+        std::size_t n = 1000000;
+        xtensor<int, 1> a = random::randint<int>({n}, 0, 100);
+        auto counts = bincount(a);
+        ASSERT_EQ(counts.size(), 100u);
+        EXPECT_EQ(sum(counts)(), n);
+        std::size_t n_zeros = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            n_zeros += static_cast<std::size_t>(a(i) == 0);
+        }
+        EXPECT_EQ(counts(0), n_zeros);
+    }
+
+    TEST(xhistogram, bin_edges)
+    {
+        xarray<double> a = {1., 2., 5.};
+        xtensor<double, 1> edges = {1., 2., 3., 4., 5.};
+        EXPECT_EQ(histogram_bin_edges(a, 4), edges);
+        EXPECT_EQ(histogram_bin_edges(a, 4, 1, 5), edges);
+
+        xarray<int> c = {3, 3};
+        xtensor<double, 1> cedges = {2.5, 3., 3.5};
+        EXPECT_EQ(histogram_bin_edges(c, 2), cedges);
+
+        EXPECT_THROW(histogram_bin_edges(a, 0), std::runtime_error);
+    }
+
+    TEST(xhistogram, histogram)
+    {
+        xarray<double> a = {0., 0.5, 1., 1.5, 2., 3., 4., -1., 10.};
+        xtensor<std::size_t, 1> expected = {2, 2, 1, 2};
+        EXPECT_EQ(histogram(a, 4, 0., 4.), expected);
+
+        xtensor<std::size_t, 1> full = {4, 3, 1, 0, 1};
+        EXPECT_EQ(histogram(a, 5), full);
+
+        xarray<double> nan_values = {0., std::nan(""), 1.};
+        EXPECT_EQ(histogram(nan_values, 2, 0., 1.), (xtensor<std::size_t, 1>{1, 1}));
+
+        EXPECT_THROW(histogram(a, 4, 1., 1.), std::runtime_error);
+    }
+
+    TEST(xhistogram, histogram_edges)
+    {
+        xarray<int> a = {1, 2, 2, 3, 5, 8, 13};
+        xarray<double> edges = {0., 2., 3., 10.};
+        xtensor<std::size_t, 1> expected = {1, 2, 3};
+        EXPECT_EQ(histogram(a, edges), expected);
+
+        xarray<double> one = {1.};
+        EXPECT_THROW(histogram(a, one), std::runtime_error);
+        xarray<double> unsorted = {0., 2., 1.};
+        EXPECT_THROW(histogram(a, unsorted), std::runtime_error);
+    }
+
+    TEST(xhistogram, histogram_large)
+    {
+        std::size_t n = 1000000;
+        std::size_t bins = 37;
+        xtensor<double, 1> a = random::randn<double>({n});
+        auto edges = histogram_bin_edges(a, bins);
+        auto uniform = histogram(a, bins);
+        auto explicit_edges = histogram(a, edges);
+        EXPECT_EQ(uniform, explicit_edges);
+        EXPECT_EQ(sum(uniform)(), n);
+    }
+}
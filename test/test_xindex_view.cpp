@@ -138,4 +138,71 @@ namespace xt
         xarray<double> expected = {{1, 2, 3}, {5, 7, 9}};
         EXPECT_EQ(expected, b);
     }
+
+    TEST(xindex_view, filter_compaction)
+    {
+        xarray<double> a = random::rand<double>({300, 500});
+        auto cond = a > 0.3;
+        std::vector<double> expected;
+        for (auto it = a.cbegin(); it != a.cend(); ++it)
+        {
+            if (*it > 0.3)
+            {
+                expected.push_back(*it);
+            }
+        }
+
+        auto v = filter(a, cond);
+        ASSERT_EQ(expected.size(), v.size());
+        xarray<double> res = v;
+        ASSERT_EQ(expected.size(), res.size());
+        EXPECT_TRUE(std::equal(expected.cbegin(), expected.cend(), res.cbegin()));
+        EXPECT_TRUE(std::equal(expected.cbegin(), expected.cend(), v.cbegin()));
+
+        xarray<double, layout_type::column_major> ac = a;
+        xarray<double> rc = filter(ac, ac > 0.3);
+        EXPECT_TRUE(std::equal(expected.cbegin(), expected.cend(), rc.cbegin()));
+
+        xarray<bool> none = zeros<bool>({300, 500});
+        EXPECT_EQ(0u, filter(a, none).size());
+    }
+
+    TEST(xindex_view, filter_broadcast_condition)
+    {
+        xarray<double> a = {{1, 2, 3}, {4, 5, 6}};
+        xarray<bool> cond = {true, false, true};
+        xarray<double> res = filter(a, cond);
+        xarray<double> expected = {1, 3, 4, 6};
+        EXPECT_EQ(expected, res);
+        filter(a, cond) = 0.;
+        xarray<double> expected_a = {{0, 2, 0}, {0, 5, 0}};
+        EXPECT_EQ(expected_a, a);
+
+        // the selection does not depend on the layout of the expression
+        xarray<double, layout_type::column_major> ca = {{1, 2, 3}, {4, 5, 6}};
+        xarray<double> cres = filter(ca, cond);
+        EXPECT_EQ(expected, cres);
+
+        xarray<double> b = {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}};
+        auto v = view(b, range(0, 2), all());
+        xarray<double> vres = filter(v, cond);
+        EXPECT_EQ(expected, vres);
+        filter(v, cond) = 0.;
+        xarray<double> expected_b = {{0, 2, 0}, {0, 5, 0}, {7, 8, 9}};
+        EXPECT_EQ(expected_b, b);
+    }
+
+    TEST(xindex_view, filtration_large)
+    {
+        xarray<double> a = random::rand<double>({300, 500});
+        xarray<double> expected = where(a >= 0.5, a + 2., a);
+        filtration(a, a >= 0.5) += 2.;
+        EXPECT_EQ(expected, a);
+
+        xarray<double> b = {{1, 5, 3}, {4, 5, 6}};
+        xarray<bool> cond = {true, false, true};
+        filtration(b, broadcast(cond, b.shape())) = 0.;
+        xarray<double> expected_b = {{0, 5, 0}, {0, 5, 0}};
+        EXPECT_EQ(expected_b, b);
+    }
 }
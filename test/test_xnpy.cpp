@@ -10,9 +10,13 @@
 
 #include "xtensor/xnpy.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
 
 #include <fstream>
 #include <cstdint>
+#include <type_traits>
 
 namespace xt
 {
@@ -48,6 +52,41 @@ namespace xt
         EXPECT_TRUE(all(isclose(darr, dfarr_loaded)));
     }
 
+    TEST(xnpy, load_mmap)
+    {
+        xarray<double> darr = {{{ 0.29731723,  0.04380157,  0.94748308},
+                                { 0.85020643,  0.52958618,  0.0598172 },
+                                { 0.77253259,  0.47564231,  0.70274005}},
+                               {{ 0.85998447,  0.61160158,  0.44432939},
+                                { 0.25506765,  0.97420976,  0.15455842},
+                                { 0.05873659,  0.66191764,  0.01448838}},
+                               {{ 0.175919  ,  0.13850365,  0.94059426},
+                                { 0.79941809,  0.5124432 ,  0.51364796},
+                                { 0.25721979,  0.41608858,  0.06255319}}};
+
+        auto darr_mapped = load_npy_mmap<double>("files/xnpy_files/double.npy");
+        EXPECT_TRUE(all(isclose(darr, darr_mapped)));
+        // the pages are mapped read-only, so are the elements
+        EXPECT_TRUE(std::is_const<std::remove_reference_t<decltype(darr_mapped(0, 0, 0))>>::value);
+
+        auto dfarr_mapped = load_npy_mmap<double, layout_type::column_major>("files/xnpy_files/double_fortran.npy");
+        EXPECT_TRUE(all(isclose(darr, dfarr_mapped)));
+
+        auto darr_cow = load_npy_mmap<double, layout_type::dynamic, npy_mmap_mode::copy_on_write>("files/xnpy_files/double.npy");
+        darr_cow(0, 0, 0) = 42.;
+        EXPECT_EQ(darr_cow(0, 0, 0), 42.);
+        auto darr_reloaded = load_npy<double>("files/xnpy_files/double.npy");
+        EXPECT_TRUE(all(isclose(darr, darr_reloaded)));
+
+        darr_cow.reshape({27});
+        darr_cow.resize({4});
+        EXPECT_EQ(darr_cow.size(), 4u);
+
+        EXPECT_THROW(load_npy_mmap<float>("files/xnpy_files/double.npy"), std::runtime_error);
+        auto load_row_major = []() { return load_npy_mmap<double, layout_type::row_major>("files/xnpy_files/double_fortran.npy"); };
+        EXPECT_THROW(load_row_major(), std::runtime_error);
+    }
+
     bool compare_binary_files(std::string fn1, std::string fn2)
     {
         std::ifstream stream1(fn1, std::ios::in | std::ios::binary);
@@ -107,4 +146,52 @@ namespace xt
         EXPECT_TRUE(compare_binary_files(filename, compare_name));
         std::remove(filename.c_str());
     }
-}
\ No newline at end of file
+
+    TEST(xnpy, writer)
+    {
+        std::string filename = get_filename();
+        xarray<double> a = arange<double>(24.);
+        a.reshape({4, 2, 3});
+        xtensor<double, 3, layout_type::column_major> b = a;
+        {
+            npy_writer<double> writer(filename);
+            writer.append(a);
+            writer.append(b);
+            writer.append(2. * a + 1.);
+            writer.append(strided_view(a, {1}));
+            EXPECT_EQ(writer.shape(), std::vector<std::size_t>({13, 2, 3}));
+            EXPECT_THROW(writer.append(strided_view(a, {1, 1})), std::runtime_error);
+            writer.close();
+            EXPECT_FALSE(writer.is_open());
+        }
+        auto loaded = load_npy<double>(filename);
+        ASSERT_EQ(loaded.shape(), std::vector<std::size_t>({13, 2, 3}));
+        EXPECT_EQ(view(loaded, range(0, 4), all(), all()), a);
+        EXPECT_EQ(view(loaded, range(4, 8), all(), all()), a);
+        EXPECT_EQ(view(loaded, range(8, 12), all(), all()), 2. * a + 1.);
+        EXPECT_EQ(strided_view(loaded, {12}), strided_view(a, {1}));
+        std::remove(filename.c_str());
+
+        filename = get_filename();
+        {
+            npy_writer<int> writer(filename, std::vector<std::size_t>());
+            for (int i = 0; i < 5; ++i)
+            {
+                writer.append(xt::xarray<int>(i));
+            }
+            writer.append(arange<int>(5, 100000));
+        }
+        auto loaded_int = load_npy<int>(filename);
+        ASSERT_EQ(loaded_int.shape(), std::vector<std::size_t>({100000}));
+        EXPECT_EQ(loaded_int, arange<int>(100000));
+        std::remove(filename.c_str());
+
+        filename = get_filename();
+        {
+            npy_writer<double> writer(filename);
+        }
+        auto empty = load_npy<double>(filename);
+        EXPECT_EQ(empty.shape(), std::vector<std::size_t>({0}));
+        std::remove(filename.c_str());
+    }
+}
@@ -0,0 +1,144 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <complex>
+#include <numeric>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xbroadcast.hpp"
+#include "xtensor/xparallel.hpp"
+#include "xtensor/xrandom.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    TEST(xparallel, parallel_for)
+    {
+        std::size_t first = 3;
+        std::size_t last = 1003;
+        std::size_t grain = 8;
+        std::vector<int> hits(last, 0);
+        parallel_for(first, last, grain, [&hits, first, grain](std::size_t b, std::size_t e) {
+            EXPECT_EQ((b - first) % grain, 0u);
+            for (std::size_t i = b; i < e; ++i)
+            {
+                ++hits[i];
+            }
+        });
+        EXPECT_EQ(std::accumulate(hits.cbegin(), hits.cbegin() + 3, 0), 0);
+        EXPECT_TRUE(std::all_of(hits.cbegin() + 3, hits.cend(), [](int h) { return h == 1; }));
+    }
+
+    TEST(xparallel, trivial_assign)
+    {
+        std::size_t size = 2 * XTENSOR_PARALLEL_THRESHOLD + 7;
+        xtensor<double, 1> a = arange<double>(double(size));
+        xtensor<double, 1> b = 2. * a + 1.;
+        xtensor<int, 1> c = a;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            EXPECT_EQ(b(i), 2. * double(i) + 1.);
+            EXPECT_EQ(c(i), int(i));
+        }
+    }
+
+    TEST(xparallel, broadcast_assign)
+    {
+        std::size_t n = XTENSOR_PARALLEL_THRESHOLD / 64 + 3;
+        xarray<double> a = arange<double>(double(n));
+        a.reshape({n, std::size_t(1)});
+        xarray<double> b = arange<double>(128.);
+        xarray<double> res = a * 1000. + b;
+        ASSERT_EQ(res.shape()[0], n);
+        ASSERT_EQ(res.shape()[1], 128u);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            for (std::size_t j = 0; j < 128; ++j)
+            {
+                EXPECT_EQ(res(i, j), double(i) * 1000. + double(j));
+            }
+        }
+    }
+
+    TEST(xparallel, view_assign)
+    {
+        xtensor<double, 3> a = zeros<double>({4, 3, XTENSOR_PARALLEL_THRESHOLD / 8});
+        xtensor<double, 2> b = ones<double>({3, XTENSOR_PARALLEL_THRESHOLD / 8});
+        auto v = view(a, 2, all(), all());
+        v = b;
+        EXPECT_EQ(std::accumulate(a.cbegin(), a.cend(), 0.), double(b.size()));
+        EXPECT_TRUE(std::all_of(v.cbegin(), v.cend(), [](double d) { return d == 1.; }));
+    }
+
+    TEST(xparallel, forbid_parallel_random)
+    {
+        using random_type = decltype(random::rand<double>({4}));
+        using view_type = decltype(view(random::rand<double>({4}), range(1, 3)));
+        using broadcast_type = decltype(broadcast(random::rand<double>({4}), {2, 4}));
+        using strided_type = decltype(strided_view(random::rand<double>({4}), slice_vector({range(1, 3)})));
+        using function_type = decltype(view(random::rand<double>({4}), all()) + 1.);
+        EXPECT_TRUE(detail::forbid_parallel_assign<random_type>::value);
+        EXPECT_TRUE(detail::forbid_parallel_assign<view_type>::value);
+        EXPECT_TRUE(detail::forbid_parallel_assign<broadcast_type>::value);
+        EXPECT_TRUE(detail::forbid_parallel_assign<strided_type>::value);
+        EXPECT_TRUE(detail::forbid_parallel_assign<function_type>::value);
+        EXPECT_FALSE(detail::forbid_parallel_assign<decltype(view(std::declval<xtensor<double, 1>&>(), all()))>::value);
+
+        // a generator wrapped in a view draws its elements in order
+        std::size_t size = 2 * XTENSOR_PARALLEL_THRESHOLD + 7;
+        random::seed(17);
+        xtensor<double, 1> expected = random::rand<double>({size});
+        random::seed(17);
+        xtensor<double, 1> res = view(random::rand<double>({size}), all());
+        EXPECT_EQ(res, expected);
+    }
+
+    TEST(xparallel, parallel_fill_copy)
+    {
+        std::size_t size = 2 * XTENSOR_PARALLEL_THRESHOLD + 7;
+        std::vector<double> a(size, 0.);
+        parallel_fill(a.begin() + 1, a.end(), 3.);
+        EXPECT_EQ(a[0], 0.);
+        EXPECT_TRUE(std::all_of(a.cbegin() + 1, a.cend(), [](double d) { return d == 3.; }));
+
+        std::vector<double> b(size + 1, -1.);
+        auto it = parallel_copy(a.cbegin(), a.cend(), b.begin());
+        EXPECT_EQ(it, b.end() - 1);
+        EXPECT_TRUE(std::equal(a.cbegin(), a.cend(), b.cbegin()));
+        EXPECT_EQ(b.back(), -1.);
+
+        std::vector<bool> c(size, false);
+        parallel_fill(c.begin(), c.end(), true);
+        EXPECT_TRUE(std::all_of(c.cbegin(), c.cend(), [](bool v) { return v; }));
+    }
+
+    TEST(xparallel, construction)
+    {
+        std::size_t size = 2 * XTENSOR_PARALLEL_THRESHOLD + 7;
+        xtensor<double, 1> a({size}, 2.5);
+        EXPECT_TRUE(std::all_of(a.cbegin(), a.cend(), [](double d) { return d == 2.5; }));
+
+        xtensor<double, 1> b = full_like(a, 4.);
+        EXPECT_TRUE(std::all_of(b.cbegin(), b.cend(), [](double d) { return d == 4.; }));
+
+        xtensor<double, 1> c = empty_like(a);
+        c = a;
+        xtensor<double, 1> d(c);
+        EXPECT_TRUE(std::all_of(d.cbegin(), d.cend(), [](double x) { return x == 2.5; }));
+
+        xtensor<std::complex<double>, 1> e = xtensor<std::complex<double>, 1>::from_shape({size});
+        EXPECT_TRUE(std::all_of(e.cbegin(), e.cend(), [](std::complex<double> z) { return z == std::complex<double>(); }));
+    }
+}
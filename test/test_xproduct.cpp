@@ -0,0 +1,241 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <cstddef>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xfixed.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xproduct.hpp"
+#include "xtensor/xstrided_view.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    template <class E1, class E2>
+    xarray<double> naive_matmul(const E1& a, const E2& b)
+    {
+        std::size_t m = a.shape()[0];
+        std::size_t k = a.shape()[1];
+        std::size_t n = b.shape()[1];
+        xarray<double> res = zeros<double>({m, n});
+        for (std::size_t i = 0; i < m; ++i)
+        {
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                for (std::size_t p = 0; p < k; ++p)
+                {
+                    res(i, j) += a(i, p) * b(p, j);
+                }
+            }
+        }
+        return res;
+    }
+
+    TEST(xproduct, dot)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray<double> b = {{1., 2.}, {3., 4.}, {5., 6.}};
+        xarray<double> expected = {{22., 28.}, {49., 64.}};
+        EXPECT_EQ(dot(a, b), expected);
+
+        xarray<double> v = {1., 1., 2.};
+        xarray<double> av = {9., 21.};
+        EXPECT_EQ(dot(a, v), av);
+
+        xarray<double> w = {1., 2.};
+        xarray<double> wa = {9., 12., 15.};
+        EXPECT_EQ(dot(w, a), wa);
+
+        auto inner = dot(v, v);
+        EXPECT_EQ(inner.dimension(), 0u);
+        EXPECT_EQ(inner(), 6.);
+    }
+
+    TEST(xproduct, matmul_blocked)
+    {
+        // Sizes larger than the blocks and not multiple of the micro tile
+        std::size_t m = 131, k = 300, n = 77;
+        xarray<double> a = arange<double>(m * k);
+        a.reshape({m, k});
+        a = a / 1000.;
+        xarray<double> b = arange<double>(k * n);
+        b.reshape({k, n});
+        b = 1. - b / 10000.;
+
+        auto res = matmul(a, b);
+        auto expected = naive_matmul(a, b);
+        EXPECT_TRUE(allclose(res, expected));
+
+        // Transposed and column major operands are read in place
+        xarray<double> bt = transpose(b);
+        EXPECT_TRUE(allclose(matmul(a, transpose(bt)), expected));
+        xarray<double, layout_type::column_major> ac = a;
+        EXPECT_TRUE(allclose(matmul(ac, b), expected));
+
+        // Strided views
+        auto av = view(a, range(0, m, 2), all());
+        EXPECT_TRUE(allclose(matmul(av, b), naive_matmul(xarray<double>(av), b)));
+    }
+
+    TEST(xproduct, matmul_stack)
+    {
+        xarray<double> a = arange<double>(2 * 3 * 4);
+        a.reshape({2, 3, 4});
+        xarray<double> b = arange<double>(4 * 5);
+        b.reshape({4, 5});
+        auto res = matmul(a, b);
+        ASSERT_EQ(res.dimension(), 3u);
+        EXPECT_EQ(res.shape()[0], 2u);
+        EXPECT_EQ(res.shape()[1], 3u);
+        EXPECT_EQ(res.shape()[2], 5u);
+        for (std::size_t s = 0; s < 2; ++s)
+        {
+            xarray<double> as = view(a, s, all(), all());
+            xarray<double> rs = view(res, s, all(), all());
+            EXPECT_EQ(rs, naive_matmul(as, b));
+        }
+
+        xarray<double> c = arange<double>(3 * 4 * 2);
+        c.reshape({3, 1, 4, 2});
+        auto res2 = matmul(a, c);
+        ASSERT_EQ(res2.dimension(), 4u);
+        EXPECT_EQ(res2.shape()[0], 3u);
+        EXPECT_EQ(res2.shape()[1], 2u);
+        xarray<double> a1 = view(a, 1, all(), all());
+        xarray<double> c2 = view(c, 2, 0, all(), all());
+        xarray<double> r21 = view(res2, 2, 1, all(), all());
+        EXPECT_EQ(r21, naive_matmul(a1, c2));
+
+        xarray<double> v = {1., 0., 0., 1.};
+        xarray<double> av = matmul(a, v);
+        EXPECT_EQ(av(1, 2), a(1, 2, 0) + a(1, 2, 3));
+
+        xarray<double> d = ones<double>({2, 5});
+        EXPECT_THROW(matmul(a, d), std::runtime_error);
+    }
+
+    TEST(xproduct, matmul_mixed_types)
+    {
+        xarray<int> a = {{1, 2}, {3, 4}};
+        xarray<double> b = {{0.5, 0.}, {0., 0.5}};
+        xarray<double> expected = {{0.5, 1.}, {1.5, 2.}};
+        EXPECT_EQ(matmul(a, b), expected);
+        xarray<int> ia = {{7, 10}, {15, 22}};
+        EXPECT_EQ(matmul(a, a), ia);
+    }
+
+    TEST(xproduct, outer)
+    {
+        xarray<double> a = {1., 2., 3.};
+        xarray<double> b = {{1., 10.}};
+        xarray<double> expected = {{1., 10.}, {2., 20.}, {3., 30.}};
+        EXPECT_EQ(outer(a, b), expected);
+    }
+
+    TEST(xproduct, tensordot)
+    {
+        xarray<double> a = arange<double>(60.);
+        a.reshape({3, 4, 5});
+        xarray<double> b = arange<double>(24.);
+        b.reshape({4, 3, 2});
+
+        auto res = tensordot(a, b, {1, 0}, {0, 1});
+        ASSERT_EQ(res.dimension(), 2u);
+        EXPECT_EQ(res.shape()[0], 5u);
+        EXPECT_EQ(res.shape()[1], 2u);
+        for (std::size_t i = 0; i < 5; ++i)
+        {
+            for (std::size_t j = 0; j < 2; ++j)
+            {
+                double expected = 0.;
+                for (std::size_t k = 0; k < 3; ++k)
+                {
+                    for (std::size_t l = 0; l < 4; ++l)
+                    {
+                        expected += a(k, l, i) * b(l, k, j);
+                    }
+                }
+                EXPECT_EQ(res(i, j), expected);
+            }
+        }
+
+        xarray<double> c = ones<double>({4, 5, 2});
+        auto res2 = tensordot(a, c);
+        EXPECT_EQ(res2.shape()[0], 3u);
+        EXPECT_EQ(res2.shape()[1], 2u);
+        double expected = 0.;
+        for (std::size_t i = 0; i < 20; ++i)
+        {
+            expected += a.data()[20 + i];
+        }
+        EXPECT_EQ(res2(1, 1), expected);
+
+        EXPECT_THROW(tensordot(a, b, {0}, {0}), std::runtime_error);
+    }
+
+    TEST(xproduct, einsum)
+    {
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray<double> b = {{1., 2.}, {3., 4.}, {5., 6.}};
+        xarray<double> ab = {{22., 28.}, {49., 64.}};
+        EXPECT_EQ(einsum("ij,jk->ik", a, b), ab);
+        EXPECT_EQ(einsum("ij,jk", a, b), ab);
+        xarray<double> abt = transpose(ab);
+        EXPECT_EQ(einsum("ij,jk->ki", a, b), abt);
+
+        xarray<double> at = {{1., 4.}, {2., 5.}, {3., 6.}};
+        EXPECT_EQ(einsum("ij->ji", a), at);
+        EXPECT_EQ(einsum("ji", a), at);
+        xarray<double> row_sums = {6., 15.};
+        EXPECT_EQ(einsum("ij->i", a), row_sums);
+
+        xarray<double> m = {{1., 2.}, {3., 4.}};
+        EXPECT_EQ(einsum("ii", m)(), 5.);
+        xarray<double> diag = {1., 4.};
+        EXPECT_EQ(einsum("ii->i", m), diag);
+
+        xarray<double> v = {1., 2., 3.};
+        EXPECT_EQ(einsum("i,i", v, v)(), 14.);
+
+        xarray<double> s = arange<double>(12.);
+        s.reshape({2, 2, 3});
+        xarray<double> t = arange<double>(12.);
+        t.reshape({2, 3, 2});
+        auto st = einsum("bij,bjk->bik", s, t);
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            xarray<double> si = view(s, i, all(), all());
+            xarray<double> ti = view(t, i, all(), all());
+            xarray<double> sti = view(st, i, all(), all());
+            EXPECT_EQ(sti, naive_matmul(si, ti));
+        }
+
+        EXPECT_THROW(einsum("ij,jk->il", a, b), std::runtime_error);
+        EXPECT_THROW(einsum("ijk,jk", a, b), std::runtime_error);
+        EXPECT_THROW(einsum("...i,ij", a, b), std::runtime_error);
+    }
+
+    TEST(xproduct, fixed)
+    {
+        xtensor_fixed<double, xshape<3, 3>> r({{0., -1., 0.}, {1., 0., 0.}, {0., 0., 1.}});
+        xtensor_fixed<double, xshape<3>> p({1., 2., 3.});
+        xtensor_fixed<double, xshape<3>> rp = dot(r, p);
+        EXPECT_EQ(rp(0), -2.);
+        EXPECT_EQ(rp(1), 1.);
+        EXPECT_EQ(rp(2), 3.);
+
+        xtensor_fixed<double, xshape<3, 3>> rr = matmul(r, r);
+        xarray<double> dr = r;
+        EXPECT_EQ(xarray<double>(rr), naive_matmul(dr, dr));
+    }
+}
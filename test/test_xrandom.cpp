@@ -7,8 +7,12 @@
 ****************************************************************************/
 
 #include "gtest/gtest.h"
+
+#include <cstdint>
+
 #include "xtensor/xrandom.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xtensor.hpp"
 #include "xtensor/xview.hpp"
 
 namespace xt
@@ -103,4 +107,81 @@ namespace xt
 #endif
 
     }
+
+    TEST(xrandom, philox_engine)
+    {
+        // Known answer of Philox4x32-10 for a null key and counter
+        random::philox_engine engine(0);
+        random::philox_engine::block_type expected = {0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u};
+        EXPECT_EQ(engine.block(0), expected);
+
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            EXPECT_EQ(engine(), expected[i]);
+        }
+        EXPECT_EQ(engine.counter(), 1u);
+
+        random::philox_engine other(0);
+        other.discard(9);
+        engine();
+        engine.discard(4);
+        EXPECT_EQ(engine(), other());
+
+        std::uniform_int_distribution<int> dist(0, 9);
+        EXPECT_LE(dist(engine), 9);
+    }
+
+    TEST(xrandom, counter_based)
+    {
+        random::philox_engine engine(42);
+        auto r = random::randn<double>({200, 300}, 0., 1., engine);
+        xtensor<double, 2> a = r;
+        xtensor<double, 2> b = r;
+        EXPECT_EQ(a, b);
+        EXPECT_EQ(engine.counter(), 200u * 300u);
+
+        // Elements only depend on their index
+        xtensor<double, 1> row = view(r, 17, all());
+        EXPECT_EQ(row, xtensor<double, 1>(view(a, 17, all())));
+        EXPECT_EQ(r(5, 7), a(5, 7));
+        EXPECT_EQ((r[{5, 7}]), a(5, 7));
+
+        random::philox_engine same(42);
+        xtensor<double, 2> c = random::randn<double>({200, 300}, 0., 1., same);
+        EXPECT_EQ(a, c);
+        xtensor<double, 2> d = random::randn<double>({200, 300}, 0., 1., same);
+        EXPECT_NE(a, d);
+
+        double mean = 0.;
+        double var = 0.;
+        for (auto v : a)
+        {
+            mean += v;
+            var += v * v;
+        }
+        mean /= double(a.size());
+        var = var / double(a.size()) - mean * mean;
+        EXPECT_NEAR(mean, 0., 0.02);
+        EXPECT_NEAR(var, 1., 0.02);
+
+        xtensor<float, 1> u = random::rand<float>({1000}, 2.f, 3.f, engine);
+        xtensor<int, 1> n = random::randint<int>({1000}, -5, 5, engine);
+        for (std::size_t i = 0; i < 1000; ++i)
+        {
+            EXPECT_GE(u(i), 2.f);
+            EXPECT_LT(u(i), 3.f);
+            EXPECT_GE(n(i), -5);
+            EXPECT_LT(n(i), 5);
+        }
+
+        // Parallel assignment does not change the values
+        std::size_t size = 2 * XTENSOR_PARALLEL_THRESHOLD + 3;
+        random::philox_engine large_engine(7);
+        auto large = random::rand<double>({size}, 0., 1., large_engine);
+        xtensor<double, 1> l = large;
+        random::philox_engine sequential(7);
+        sequential.set_counter(size - 1);
+        auto last = random::rand<double>({1}, 0., 1., sequential);
+        EXPECT_EQ(l(size - 1), last(0));
+    }
 }
@@ -12,10 +12,12 @@
 #include "xtensor/xfixed.hpp"
 #include "xtensor/xbuilder.hpp"
 #include "xtensor/xmath.hpp"
+#include "xtensor/xnoalias.hpp"
 #include "xtensor/xreducer.hpp"
 #include "xtensor/xview.hpp" 
 #include "xtensor/xstrided_view.hpp" 
 #include "xtensor/xrandom.hpp" 
+#include "test_common.hpp"
 
 namespace xt
 {
@@ -263,6 +265,132 @@ namespace xt
         EXPECT_EQ(a_lz, a_gd);
     }
 
+    TEST(xreducer, immediate_large)
+    {
+        std::size_t n = parallel_extent(8 * 4);
+        xarray<double> a = xt::arange<double>(double(n * 8 * 4));
+        a.reshape({n, std::size_t(8), std::size_t(4)});
+        xarray<double, layout_type::column_major> ca = a;
+
+        EXPECT_EQ(sum(a)(), sum(a, evaluation_strategy::immediate())());
+        EXPECT_EQ(amax(a)(), amax(a, evaluation_strategy::immediate())());
+
+        xarray<double> a_lz = sum(a, {0});
+        EXPECT_EQ(a_lz, sum(a, {0}, evaluation_strategy::immediate()));
+        EXPECT_EQ(a_lz, sum(ca, {0}, evaluation_strategy::immediate()));
+
+        a_lz = sum(a, {2});
+        EXPECT_EQ(a_lz, sum(a, {2}, evaluation_strategy::immediate()));
+        EXPECT_EQ(a_lz, sum(ca, {2}, evaluation_strategy::immediate()));
+
+        a_lz = sum(a, {0, 2});
+        EXPECT_EQ(a_lz, sum(a, {0, 2}, evaluation_strategy::immediate()));
+        EXPECT_EQ(a_lz, sum(ca, {0, 2}, evaluation_strategy::immediate()));
+
+        a_lz = prod(a / double(n), {1});
+        xarray<double> b = a / double(n);
+        EXPECT_TRUE(allclose(a_lz, prod(b, {1}, evaluation_strategy::immediate())));
+    }
+
+    TEST(xreducer, immediate_simd)
+    {
+        // sizes that are not multiples of the batch sizes exercise the tails
+        // of the vectorized kernels
+        xarray<double> a = xt::arange<double>(-300., 303.) / 7.;
+        a.reshape({std::size_t(9), std::size_t(67)});
+        a(4, 33) = 1000.;
+        a(5, 66) = -1000.;
+        xarray<double, layout_type::column_major> ca = a;
+
+        EXPECT_TRUE(allclose(sum(a), sum(a, evaluation_strategy::immediate())));
+        EXPECT_EQ(amax(a)(), amax(a, evaluation_strategy::immediate())());
+        EXPECT_EQ(amin(ca)(), amin(ca, evaluation_strategy::immediate())());
+
+        for (std::size_t ax = 0; ax < 2; ++ax)
+        {
+            std::array<std::size_t, 1> axes = {ax};
+            EXPECT_TRUE(allclose(sum(a, axes), sum(a, axes, evaluation_strategy::immediate())));
+            EXPECT_TRUE(allclose(sum(a, axes), sum(ca, axes, evaluation_strategy::immediate())));
+            EXPECT_EQ(xarray<double>(amax(a, axes)), amax(a, axes, evaluation_strategy::immediate()));
+            EXPECT_EQ(xarray<double>(amin(a, axes)), amin(ca, axes, evaluation_strategy::immediate()));
+        }
+
+        xarray<int> ia = xt::arange<int>(-200, 403);
+        ia.reshape({std::size_t(9), std::size_t(67)});
+        EXPECT_EQ(xarray<int>(amax(ia, {1})), amax(ia, {1}, evaluation_strategy::immediate()));
+        EXPECT_EQ(xarray<int>(amin(ia, {0})), amin(ia, {0}, evaluation_strategy::immediate()));
+        EXPECT_EQ(xarray<long long>(sum(ia, {1})), sum(ia, {1}, evaluation_strategy::immediate()));
+    }
+
+    TEST(xreducer, promoted_simd)
+    {
+        // floats and ints are summed in double and long long: accumulating
+        // in the type of the elements would lose the small values or overflow
+        std::size_t n = 2003;
+        xtensor<float, 2> a = xt::ones<float>({std::size_t(3), n});
+        xtensor<int, 2> ia = xt::ones<int>({std::size_t(3), n});
+        for (std::size_t j = 0; j < n; j += 2)
+        {
+            a(1, j) = 16777216.f;
+            ia(1, j) = 1 << 30;
+        }
+        double expected = 1002. * 16777216. + 1001.;
+        long long iexpected = 1002LL * (1LL << 30) + 1001LL;
+
+        xtensor<double, 1> r = sum(a, {1}, evaluation_strategy::immediate());
+        EXPECT_EQ(double(n), r(0));
+        EXPECT_EQ(expected, r(1));
+        xtensor<double, 1> lr = sum(a * 1.f, {1});
+        EXPECT_EQ(expected, lr(1));
+        xtensor<float, 1> row = view(a, 1, all());
+        EXPECT_EQ(expected, sum(row, evaluation_strategy::immediate())());
+
+        xtensor<long long, 1> ir = sum(ia, {1}, evaluation_strategy::immediate());
+        EXPECT_EQ(iexpected, ir(1));
+        xtensor<long long, 1> lir = sum(ia + 0, {1});
+        EXPECT_EQ(iexpected, lir(1));
+
+        // strided reduction
+        xtensor<float, 2> ta = transpose(a);
+        xtensor<double, 1> tr = sum(ta, {0}, evaluation_strategy::immediate());
+        EXPECT_EQ(expected, tr(1));
+        xtensor<int, 2> tia = transpose(ia);
+        xtensor<long long, 1> tir = sum(tia, {0}, evaluation_strategy::immediate());
+        EXPECT_EQ(iexpected, tir(1));
+    }
+
+    TEST(xreducer, lazy_simd_assign)
+    {
+        xarray<double> a = xt::arange<double>(-400., 710.) / 11.;
+        a.reshape({std::size_t(5), std::size_t(6), std::size_t(37)});
+        xarray<double> b = xt::arange<double>(1110.) / 13.;
+        b.reshape(a.shape());
+        xarray<double> ab = a * b;
+
+        // reduced axes are innermost
+        xarray<double> r1 = sum(a * b, {2});
+        EXPECT_TRUE(allclose(r1, sum(ab, {2}, evaluation_strategy::immediate())));
+        xtensor<double, 1> r2 = sum(a * b, {1, 2});
+        EXPECT_TRUE(allclose(r2, sum(ab, {1, 2}, evaluation_strategy::immediate())));
+        xarray<double> r3 = amax(a + 1., {1, 2});
+        EXPECT_EQ(r3, amax(a, {1, 2}, evaluation_strategy::immediate()) + 1.);
+        xarray<double> r4;
+        noalias(r4) = amin(a - b, {2});
+        EXPECT_EQ(r4, amin(xarray<double>(a - b), {2}, evaluation_strategy::immediate()));
+
+        xarray<double, layout_type::column_major> ca = a;
+        xarray<double, layout_type::column_major> cr = sum(ca * ca, {0});
+        EXPECT_TRUE(allclose(cr, sum(xarray<double>(a * a), {0}, evaluation_strategy::immediate())));
+
+        // reduced axes are not innermost, or the expression broadcasts
+        xarray<double> r5 = sum(a * b, {0});
+        EXPECT_TRUE(allclose(r5, sum(ab, {0}, evaluation_strategy::immediate())));
+        xarray<double> row = view(b, 0, 0, all());
+        xarray<double> r6 = sum(a * row, {2});
+        xarray<double> arow = a * row;
+        EXPECT_TRUE(allclose(r6, sum(arow, {2}, evaluation_strategy::immediate())));
+    }
+
     TEST(xreducer, chaining_reducers)
     {
         xt::xarray<double> a = {{ 1., 2. },
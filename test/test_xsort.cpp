@@ -6,6 +6,13 @@
  * The full license is in the file LICENSE, distributed with this software. *
  ****************************************************************************/
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
 #include "gtest/gtest.h"
 #include "xtensor/xarray.hpp"
 #include "xtensor/xio.hpp"
@@ -145,4 +152,367 @@ namespace xt
         xarray<double> bbx = {1,2,3,4,5,6,7,8,9};
         EXPECT_EQ(unique(bb), bbx);
     }
+
+    template <class E>
+    void check_unique(const E& e)
+    {
+        using value_type = typename E::value_type;
+        xtensor<value_type, 1> flat = flatten(e);
+        std::vector<value_type> expected(flat.cbegin(), flat.cend());
+        std::sort(expected.begin(), expected.end());
+        expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+        auto values = unique(e);
+        ASSERT_EQ(values.size(), expected.size());
+        EXPECT_TRUE(std::equal(expected.cbegin(), expected.cend(), values.cbegin()));
+
+        auto counts = unique_counts(e);
+        EXPECT_EQ(counts.first, values);
+        ASSERT_EQ(counts.second.size(), values.size());
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            auto n = static_cast<std::size_t>(std::count(flat.cbegin(), flat.cend(), values(i)));
+            EXPECT_EQ(counts.second(i), n);
+        }
+
+        auto inverse = unique_inverse(e);
+        EXPECT_EQ(inverse.first, values);
+        ASSERT_EQ(inverse.second.size(), flat.size());
+        for (std::size_t i = 0; i < flat.size(); ++i)
+        {
+            EXPECT_EQ(values(inverse.second(i)), flat(i));
+        }
+    }
+
+    TEST(xsort, unique_counts_inverse)
+    {
+        xarray<int> a = {{3, -2, 3}, {7, 0, -2}};
+        auto counts = unique_counts(a);
+        xtensor<int, 1> values = {-2, 0, 3, 7};
+        xtensor<std::size_t, 1> n = {2, 1, 2, 1};
+        EXPECT_EQ(counts.first, values);
+        EXPECT_EQ(counts.second, n);
+        auto inverse = unique_inverse(a);
+        xtensor<std::size_t, 1> idx = {2, 0, 2, 3, 1, 0};
+        EXPECT_EQ(inverse.first, values);
+        EXPECT_EQ(inverse.second, idx);
+
+        // Small range of values, counted in a table
+        xarray<int> small = random::randint<int>({100, 100}, -50, 50);
+        check_unique(small);
+        xarray<short> shorts = random::randint<short>({1000}, -1000, 1000);
+        check_unique(shorts);
+
+        // Wide range of values, hashed
+        xarray<long> wide = random::randint<long>({200, 50}, std::numeric_limits<long>::min());
+        check_unique(wide);
+        xarray<long> sparse = {std::numeric_limits<long>::max(), 0, std::numeric_limits<long>::min(), 0};
+        check_unique(sparse);
+
+        // Other types, sorted
+        xarray<double> d = {{1.5, -2., 1.5}, {0., 0., 3.}};
+        check_unique(d);
+        check_unique(view(d, all(), 1));
+
+        xarray<int> empty = xarray<int>::from_shape({0});
+        EXPECT_EQ(unique_counts(empty).first.size(), 0u);
+        EXPECT_EQ(unique_inverse(empty).second.size(), 0u);
+    }
+
+    TEST(xsort, sort_size_one_axis)
+    {
+        xarray<double> a = {{{3, 1, 2}}, {{6, 5, 4}}};
+        xarray<double> ex = {{{1, 2, 3}}, {{4, 5, 6}}};
+        EXPECT_EQ(ex, sort(a));
+        EXPECT_EQ(a, sort(a, 0));
+        EXPECT_EQ(a, sort(a, 1));
+    }
+
+    TEST(xsort, sort_parallel)
+    {
+        std::size_t size = 3 * XTENSOR_PARALLEL_THRESHOLD + 5;
+        xtensor<double, 1> a = random::randn<double>({size});
+        std::vector<double> ex(a.cbegin(), a.cend());
+        std::sort(ex.begin(), ex.end());
+        auto res = sort(a);
+        EXPECT_TRUE(std::equal(ex.cbegin(), ex.cend(), res.cbegin()));
+
+        std::vector<std::size_t> shape = {8, XTENSOR_PARALLEL_THRESHOLD / 4 + 3};
+        xarray<double> b = random::randint<int>(shape, 0, 100);
+        xarray<double> b_sorted = sort(b, 1);
+        xarray<std::size_t> b_idx = argsort(b, 1);
+        for (std::size_t i = 0; i < b.shape()[0]; ++i)
+        {
+            for (std::size_t j = 1; j < b.shape()[1]; ++j)
+            {
+                EXPECT_LE(b_sorted(i, j - 1), b_sorted(i, j));
+                EXPECT_EQ(b(i, b_idx(i, j)), b_sorted(i, j));
+                if (b(i, b_idx(i, j - 1)) == b(i, b_idx(i, j)))
+                {
+                    EXPECT_LT(b_idx(i, j - 1), b_idx(i, j));
+                }
+            }
+        }
+    }
+
+    template <class E>
+    void check_radix_sort(const E& e, std::size_t axis)
+    {
+        auto expected = sort(e, axis, sorting_method::comparison);
+        auto expected_idx = argsort(e, axis, sorting_method::comparison);
+        EXPECT_EQ(sort(e, axis, sorting_method::radix), expected);
+        EXPECT_EQ(argsort(e, axis, sorting_method::radix), expected_idx);
+        EXPECT_EQ(sort(e, axis), expected);
+        EXPECT_EQ(argsort(e, axis), expected_idx);
+    }
+
+    TEST(xsort, radix_sort_signed_zeros_nans)
+    {
+        double inf = std::numeric_limits<double>::infinity();
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        // -0 and +0 are equal, NaNs are placed at the end whatever their sign
+        xarray<double> z = {nan, 0., -nan, -0., 1., -inf, -0.};
+        xarray<std::size_t> z_idx = {5, 1, 3, 6, 4, 0, 2};
+        EXPECT_EQ(argsort(z, 0, sorting_method::comparison), z_idx);
+        EXPECT_EQ(argsort(z, 0, sorting_method::radix), z_idx);
+        for (auto method : {sorting_method::comparison, sorting_method::radix})
+        {
+            xarray<double> z_sorted = sort(z, 0, method);
+            xarray<double> z_values = view(z_sorted, range(0, 5));
+            EXPECT_EQ(z_values, (xarray<double>{-inf, 0., 0., 0., 1.}));
+            EXPECT_TRUE(std::isnan(z_sorted(5)) && std::isnan(z_sorted(6)));
+        }
+
+        // short and long lanes have the same order
+        std::size_t nl = 300 * z.size();
+        xtensor<double, 1> zl = xtensor<double, 1>::from_shape({nl});
+        for (std::size_t i = 0; i < nl; ++i)
+        {
+            zl(i) = z(i % z.size());
+        }
+        auto zl_idx = argsort(zl, 0, sorting_method::comparison);
+        EXPECT_EQ(argsort(zl, 0), zl_idx);
+        EXPECT_EQ(argsort(zl, 0, sorting_method::radix), zl_idx);
+        xtensor<double, 1> zl_sorted = sort(zl, 0);
+        for (std::size_t i = 0; i < nl; ++i)
+        {
+            EXPECT_EQ(i >= 1500, std::isnan(zl_sorted(i)));
+        }
+        EXPECT_TRUE(std::is_sorted(zl_sorted.cbegin(), zl_sorted.cbegin() + 1500));
+    }
+
+    TEST(xsort, radix_sort)
+    {
+        xarray<int> a = {{5, -3, 1, -3}, {std::numeric_limits<int>::min(), 4, std::numeric_limits<int>::max(), 0}};
+        xarray<int> a_sorted = {{-3, -3, 1, 5}, {std::numeric_limits<int>::min(), 0, 4, std::numeric_limits<int>::max()}};
+        xarray<std::size_t> a_idx = {{1, 3, 2, 0}, {0, 3, 1, 2}};
+        EXPECT_EQ(sort(a, 1, sorting_method::radix), a_sorted);
+        EXPECT_EQ(argsort(a, 1, sorting_method::radix), a_idx);
+
+        double inf = std::numeric_limits<double>::infinity();
+        xarray<double> d = {2.5, -0.5, inf, -1e-300, 0., -inf, 1e300, -2.5};
+        xarray<double> d_sorted = {-inf, -2.5, -0.5, -1e-300, 0., 2.5, 1e300, inf};
+        EXPECT_EQ(sort(d, xnone(), sorting_method::radix), d_sorted);
+
+        std::size_t n = 3 * XTENSOR_PARALLEL_THRESHOLD + 5;
+        xtensor<float, 1> f = random::randn<float>({n});
+        check_radix_sort(f, 0);
+        xtensor<std::uint32_t, 1> u = random::randint<std::uint32_t>({n});
+        check_radix_sort(u, 0);
+
+        // Few distinct values: passes are skipped, ties keep their order
+        xarray<std::int64_t> l = random::randint<std::int64_t>({std::size_t(5), std::size_t(2000), std::size_t(3)}, -4, 4);
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            check_radix_sort(l, axis);
+        }
+        xarray<short> s = random::randint<short>({std::size_t(3), std::size_t(1500)});
+        check_radix_sort(s, 1);
+
+        // Chunks scattered concurrently: the keys share their high byte, so
+        // that the histograms of the chunks are computed again after the
+        // first pass
+        std::size_t nc = 2 * detail::radix_chunk_size + 3;
+        xtensor<std::uint32_t, 1> uc = random::randint<std::uint32_t>({nc}, 0u, 3u << 24);
+        check_radix_sort(uc, 0);
+        xtensor<double, 1> dc = random::randint<int>({nc}, -500, 500) / 7.;
+        check_radix_sort(dc, 0);
+
+        xarray<bool> b = {true, false};
+        EXPECT_THROW(sort(b, 0, sorting_method::radix), std::runtime_error);
+        EXPECT_THROW(argsort(b, 0, sorting_method::radix), std::runtime_error);
+        EXPECT_EQ(sort(b, 0), (xarray<bool>{false, true}));
+    }
+
+    TEST(xsort, argsort)
+    {
+        xarray<double> a = {{5, 3, 1}, {4, 4, 2}};
+
+        xarray<std::size_t> ex_0 = {{1, 0, 0}, {0, 1, 1}};
+        EXPECT_EQ(ex_0, argsort(a, 0));
+
+        xarray<std::size_t> ex_1 = {{2, 1, 0}, {2, 0, 1}};
+        EXPECT_EQ(ex_1, argsort(a, 1));
+        EXPECT_EQ(ex_1, argsort(a));
+
+        xtensor<std::size_t, 1> ex_flat = {2, 5, 1, 3, 4, 0};
+        EXPECT_EQ(ex_flat, argsort(a, xnone()));
+
+        xtensor<double, 2, layout_type::column_major> b = a;
+        xtensor<std::size_t, 2, layout_type::column_major> b_1 = argsort(b, 1);
+        EXPECT_EQ(ex_1, b_1);
+        EXPECT_EQ(ex_0, argsort(b, 0));
+    }
+
+    TEST(xsort, partition)
+    {
+        xarray<double> a = {{9, 1, 8, 2, 7, 3, 6}, {0, 5, 4, 9, 1, 8, 2}};
+
+        auto p = partition(a, 3);
+        ASSERT_EQ(p.shape(), a.shape());
+        EXPECT_EQ(p(0, 3), 6.);
+        EXPECT_EQ(p(1, 3), 4.);
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            for (std::size_t j = 0; j < 7; ++j)
+            {
+                if (j < 3)
+                {
+                    EXPECT_LE(p(i, j), p(i, 3));
+                }
+                else
+                {
+                    EXPECT_GE(p(i, j), p(i, 3));
+                }
+            }
+        }
+
+        auto p2 = partition(a, std::vector<std::size_t>({5, 1}));
+        EXPECT_EQ(p2(0, 1), 2.);
+        EXPECT_EQ(p2(0, 5), 8.);
+        EXPECT_EQ(p2(1, 1), 1.);
+        EXPECT_EQ(p2(1, 5), 8.);
+
+        auto p0 = partition(a, 0, 0);
+        xarray<double> ex_0 = {{0, 1, 4, 2, 1, 3, 2}, {9, 5, 8, 9, 7, 8, 6}};
+        EXPECT_EQ(ex_0, p0);
+
+        auto pf = partition(a, 7, xnone());
+        EXPECT_EQ(pf(7), 5.);
+
+        EXPECT_THROW(partition(a, 7), std::runtime_error);
+
+        // NaNs are placed after the other values, as in sort
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        xarray<double> n = {3, nan, 1, nan, 2};
+        auto pn = partition(n, 2);
+        EXPECT_EQ(pn(2), 3.);
+        EXPECT_TRUE(std::isnan(pn(3)) && std::isnan(pn(4)));
+    }
+
+    TEST(xsort, argpartition)
+    {
+        xarray<double> a = {{9, 1, 8, 2, 7, 3, 6}, {0, 5, 4, 9, 1, 8, 2}};
+
+        xarray<std::size_t> idx = argpartition(a, 3);
+        ASSERT_EQ(idx.shape(), a.shape());
+        EXPECT_EQ(a(0, idx(0, 3)), 6.);
+        EXPECT_EQ(a(1, idx(1, 3)), 4.);
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                EXPECT_LE(a(i, idx(i, j)), a(i, idx(i, 3)));
+            }
+        }
+
+        xarray<std::size_t> idx0 = argpartition(a, 1, 0);
+        xarray<std::size_t> ex_0 = {{1, 0, 1, 0, 1, 0, 1}, {0, 1, 0, 1, 0, 1, 0}};
+        EXPECT_EQ(ex_0, idx0);
+
+        auto idxf = argpartition(a, std::vector<std::size_t>({0, 13}), xnone());
+        EXPECT_EQ(idxf(0), 7u);
+        EXPECT_EQ(idxf(13), 10u);
+
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        xarray<double> n = {3, nan, 1, 2};
+        xarray<std::size_t> idxn = argpartition(n, 2);
+        EXPECT_EQ(idxn(2), 0u);
+        EXPECT_EQ(idxn(3), 1u);
+    }
+
+    TEST(xsort, median)
+    {
+        xarray<double> a = {{3, 1, 2}, {6, 5, 9}};
+        EXPECT_EQ(median(a), 4.);
+
+        xarray<double> ex_0 = {4.5, 3, 5.5};
+        EXPECT_EQ(ex_0, median(a, 0));
+
+        xarray<double> ex_1 = {2, 6};
+        EXPECT_EQ(ex_1, median(a, 1));
+
+        xtensor<int, 1> b = {7, 1, 5};
+        EXPECT_EQ(median(b), 5.);
+
+        // integral medians are not truncated
+        xtensor<int, 1> c = {1, 2};
+        EXPECT_EQ(median(c), 1.5);
+        xtensor<int, 2> d = {{1, 4, 7}, {2, 4, 6}};
+        xarray<double> ex_d0 = {1.5, 4., 6.5};
+        EXPECT_EQ(ex_d0, median(d, 0));
+
+        // NaNs are ordered after the other values
+        double nan = std::numeric_limits<double>::quiet_NaN();
+        xarray<double> n = {{1, nan, 3}, {4, 2, nan}};
+        EXPECT_EQ(median(n), 3.5);
+        xarray<double> ex_n1 = {3, 4};
+        EXPECT_EQ(ex_n1, median(n, 1));
+    }
+
+    TEST(xsort, strided_lanes)
+    {
+        xarray<double> a = random::randint<int>({std::size_t(7), std::size_t(40), std::size_t(3)}, 0, 20);
+        xtensor<double, 3, layout_type::column_major> b = a;
+        for (std::size_t axis = 0; axis < 3; ++axis)
+        {
+            xarray<double> sorted = sort(a, axis);
+            xarray<std::size_t> idx = argsort(a, axis);
+            xarray<std::size_t> amin = argmin(a, axis);
+            xarray<std::size_t> amax = argmax(b, axis);
+            EXPECT_EQ(sorted, sort(b, axis));
+            EXPECT_EQ(idx, argsort(b, axis));
+            EXPECT_EQ(amin, argmin(b, axis));
+            EXPECT_EQ(amax, argmax(a, axis));
+
+            std::vector<std::size_t> index(3);
+            for (index[0] = 0; index[0] < a.shape()[0]; ++index[0])
+            {
+                for (index[1] = 0; index[1] < a.shape()[1]; ++index[1])
+                {
+                    for (index[2] = 0; index[2] < a.shape()[2]; ++index[2])
+                    {
+                        std::vector<std::size_t> lane_index = index;
+                        lane_index[axis] = idx.element(index.cbegin(), index.cend());
+                        EXPECT_EQ(a.element(lane_index.cbegin(), lane_index.cend()), sorted.element(index.cbegin(), index.cend()));
+
+                        std::vector<std::size_t> reduced_index = index;
+                        reduced_index.erase(reduced_index.begin() + std::ptrdiff_t(axis));
+                        std::vector<std::size_t> min_index = index;
+                        min_index[axis] = amin.element(reduced_index.cbegin(), reduced_index.cend());
+                        std::vector<std::size_t> max_index = index;
+                        max_index[axis] = amax.element(reduced_index.cbegin(), reduced_index.cend());
+                        EXPECT_LE(a.element(min_index.cbegin(), min_index.cend()), a.element(index.cbegin(), index.cend()));
+                        EXPECT_GE(a.element(max_index.cbegin(), max_index.cend()), a.element(index.cbegin(), index.cend()));
+                        if (index[axis] > 0)
+                        {
+                            std::vector<std::size_t> prev = index;
+                            --prev[axis];
+                            EXPECT_LE(sorted.element(prev.cbegin(), prev.cend()), sorted.element(index.cbegin(), index.cend()));
+                        }
+                    }
+                }
+            }
+        }
+    }
 }
@@ -573,6 +573,48 @@ namespace xt
         EXPECT_ANY_THROW(vt.at(0, 0, 0, 0));
     }
 
+    TEST(xstrided_view, tiled_transpose_assignment)
+    {
+        std::size_t n = XTENSOR_ASSIGN_TILE_SIZE + 13;
+        std::size_t m = 2 * XTENSOR_ASSIGN_TILE_SIZE + 5;
+        xarray<double> a = arange<double>(double(n * m));
+        a.reshape({n, m});
+
+        xarray<double> res = transpose(a);
+        xarray<double, layout_type::column_major> cres = transpose(a);
+        xarray<double> fres = transpose(a) + 2. * transpose(a);
+        ASSERT_EQ(res.shape()[0], m);
+        ASSERT_EQ(res.shape()[1], n);
+        for (std::size_t i = 0; i < m; ++i)
+        {
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                EXPECT_EQ(res(i, j), a(j, i));
+                EXPECT_EQ(cres(i, j), a(j, i));
+                EXPECT_EQ(fres(i, j), 3. * a(j, i));
+            }
+        }
+
+        xarray<double> b = zeros<double>({m, n});
+        auto tb = transpose(b);
+        noalias(tb) = a;
+        EXPECT_EQ(b, res);
+
+        xarray<double> c = arange<double>(double(3 * n * m));
+        c.reshape({3, n, m});
+        xarray<double> cres3 = transpose(c, {0, 2, 1});
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+            for (std::size_t i = 0; i < m; ++i)
+            {
+                for (std::size_t j = 0; j < n; ++j)
+                {
+                    EXPECT_EQ(cres3(k, i, j), c(k, j, i));
+                }
+            }
+        }
+    }
+
     TEST(xstrided_view, expression_adapter)
     {
         auto e = xt::arange<double>(24);
@@ -7,13 +7,18 @@
 ****************************************************************************/
 
 #include "gtest/gtest.h"
+#include <algorithm>
 #include <initializer_list>
+#include <numeric>
+#include <string>
+#include <typeinfo>
 #include <type_traits>
 #include <tuple>
 #include <complex>
 
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
 #include "xtensor/xfixed.hpp"
 #include "xtensor/xstrided_view.hpp"
 #include "xtensor/xshape.hpp"
@@ -216,4 +221,47 @@ namespace xt
         alloc_tracking::disable();
         EXPECT_NO_THROW(arr_t c = a);
     }
+
+    TEST(utils, allocation_statistics)
+    {
+        using arr_t = xarray<double, layout_type::row_major,
+                             tracking_allocator<double, std::allocator<double>, alloc_tracking::policy::statistics>>;
+
+        auto find = [](const std::vector<alloc_tracking::counters>& c, const std::string& name) {
+            return std::find_if(c.cbegin(), c.cend(), [&name](const alloc_tracking::counters& e) { return e.name == name; });
+        };
+
+        arr_t a = {{1, 2, 3}, {5, 6, 7}};
+        alloc_tracking::reset();
+        auto start = alloc_tracking::snapshot();
+        EXPECT_EQ(start.peak_bytes, start.live_bytes);
+        EXPECT_EQ(std::accumulate(start.histogram.cbegin(), start.histogram.cend(), std::size_t(0)), 0u);
+
+        {
+            alloc_tracking::scoped_tag tag("add");
+            arr_t b = a + 123;
+            arr_t c = zeros<double>({100});
+            EXPECT_EQ(b(1, 2), 130.);
+        }
+        arr_t d = a * 2;
+
+        auto stats = alloc_tracking::snapshot();
+        auto type_it = find(stats.types, typeid(double).name());
+        ASSERT_NE(type_it, stats.types.cend());
+        EXPECT_EQ(type_it->allocations, 3u);
+        EXPECT_EQ(type_it->deallocations, 2u);
+        EXPECT_EQ(type_it->allocated_bytes, (6 + 100 + 6) * sizeof(double));
+        EXPECT_EQ(type_it->deallocated_bytes, (6 + 100) * sizeof(double));
+
+        auto tag_it = find(stats.tags, "add");
+        ASSERT_NE(tag_it, stats.tags.cend());
+        EXPECT_EQ(tag_it->allocations, 2u);
+        EXPECT_EQ(tag_it->allocated_bytes, (6 + 100) * sizeof(double));
+
+        EXPECT_EQ(stats.live_bytes, start.live_bytes + 6 * sizeof(double));
+        EXPECT_EQ(stats.peak_bytes, start.live_bytes + (6 + 100) * sizeof(double));
+        // 48 bytes in [32, 64), 800 bytes in [512, 1024)
+        EXPECT_EQ(stats.histogram[6], 2u);
+        EXPECT_EQ(stats.histogram[10], 1u);
+    }
 }
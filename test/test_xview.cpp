@@ -10,6 +10,7 @@
 
 #include "gtest/gtest.h"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
 #include "xtensor/xfixed.hpp"
 #include "xtensor/xnoalias.hpp"
 #include "xtensor/xstrided_view.hpp"
@@ -922,4 +923,53 @@ namespace xt
         b = detail::slices_contigous<xrange<int>, xrange<int>, int>::value;
         EXPECT_TRUE(b);
     }
+
+    TEST(xview, row_assign)
+    {
+        std::size_t n = 37;
+        xarray<double> a = zeros<double>({7, 37});
+        xarray<double> b = arange<double>(4. * double(n));
+        b.reshape({4, n});
+        xarray<double> c = arange<double>(double(n));
+
+        view(a, range(1, 5), all()) = b;
+        auto v = view(a, range(2, 6), all());
+        noalias(v) += c;
+        for (std::size_t i = 0; i < 7; ++i)
+        {
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                double expected = (i >= 1 && i < 5) ? b(i - 1, j) : 0.;
+                expected += (i >= 2 && i < 6) ? c(j) : 0.;
+                EXPECT_EQ(a(i, j), expected);
+            }
+        }
+
+        xarray<double> d = zeros<double>({4, 37});
+        auto vd = view(d, all(), all());
+        noalias(vd) = b * 2.;
+        EXPECT_EQ(d, b * 2.);
+
+        xarray<double> e = view(a, range(1, 5), all());
+        xarray<double, layout_type::column_major> ce = view(a, range(1, 5), all());
+        xarray<double> se = view(a, 3, range(0, 37));
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                EXPECT_EQ(e(i, j), a(i + 1, j));
+                EXPECT_EQ(ce(i, j), a(i + 1, j));
+            }
+        }
+        EXPECT_EQ(se, view(e, 2, all()));
+
+        auto sv = strided_view(a, {range(0, 7, 2), range(1, 37, 3)});
+        xarray<double> sres = sv;
+        xarray<double> scopy = zeros<double>(sres.shape());
+        std::copy(sv.cbegin(), sv.cend(), scopy.begin());
+        EXPECT_EQ(sres, scopy);
+        sv = zeros<double>(sres.shape());
+        EXPECT_EQ(a(2, 4), 0.);
+        EXPECT_EQ(a(2, 5), b(1, 5) + c(5));
+    }
 }